@@ -0,0 +1,77 @@
+// B+ 树 vs RBTree vs std::set: 插入 / 查找 / 全量扫描
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "BPlusTree/BPlusTree.hpp"
+#include "RBTree/RBTree.hpp"
+#include "BenchCommon.hpp"
+
+struct Result {
+    double insert_ns, find_ns, scan_ns, bytes;
+};
+
+static void Print(const char* name, std::size_t n, const Result& r) {
+    std::printf("%-10s n=%-10zu insert=%7.1f ns  find=%7.1f ns  scan=%6.2f ns/elem  mem=%6.1f B/elem\n",
+                name, n, r.insert_ns, r.find_ns, r.scan_ns, r.bytes);
+}
+
+template <typename Insert, typename Find, typename Scan>
+static Result Measure(const std::vector<int>& keys, const std::vector<int>& probes,
+                      Insert&& insert, Find&& find, Scan&& scan) {
+    Result r{};
+    std::size_t heap = Bench::HeapInUse();
+    r.insert_ns = Bench::TimeMs([&] { for (int k : keys) insert(k); }) * 1e6 / keys.size();
+    r.bytes = double(Bench::HeapInUse() - heap) / keys.size();
+    std::size_t hits = 0;
+    r.find_ns = Bench::TimeMs([&] { for (int p : probes) hits += find(p); }) * 1e6 / probes.size();
+    std::int64_t sum = 0;
+    r.scan_ns = Bench::TimeMs([&] { scan(sum); }) * 1e6 / keys.size();
+    Bench::DoNotOptimize(hits);
+    Bench::DoNotOptimize(sum);
+    return r;
+}
+
+static void Run(std::size_t n) {
+    std::mt19937 rng(3);
+    std::vector<int> keys(n);
+    for (auto& key : keys) key = static_cast<int>(rng());
+    std::vector<int> probes(1'000'000);
+    for (auto& probe : probes) probe = keys[rng() % n];
+
+    {
+        BPlusTree<int> tree;
+        Print("BPlusTree", n, Measure(keys, probes,
+            [&](int k) { tree.Insert(k); },
+            [&](int k) { return tree.Contains(k); },
+            [&](std::int64_t& sum) { tree.ForEach([&](int v) { sum += v; }); }));
+    }
+    {
+        RBTree<int> tree;
+        Print("RBTree", n, Measure(keys, probes,
+            [&](int k) { tree.Insert(k); },
+            [&](int k) { return tree.Find(k) != nullptr; },
+            [&](std::int64_t& sum) { RBTreeTools::Traversal(tree.Root(), [&](auto* node) { sum += node->val; }); }));
+    }
+    {
+        std::set<int> tree;
+        Print("std::set", n, Measure(keys, probes,
+            [&](int k) { tree.insert(k); },
+            [&](int k) { return tree.count(k) != 0; },
+            [&](std::int64_t& sum) { for (int v : tree) sum += v; }));
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1) {
+        Run(std::stoull(argv[1]));
+        return 0;
+    }
+    for (std::size_t n : {100'000u, 1'000'000u, 10'000'000u}) {
+        Run(n);
+    }
+    return 0;
+}
@@ -0,0 +1,40 @@
+#pragma once
+// bench/ 下各基准程序共用的计时与内存统计工具
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <malloc.h>
+#include <unistd.h>
+
+namespace Bench {
+
+// @return: 当前进程常驻内存 (bytes), 读取失败时返回 0
+inline std::size_t CurrentRSS() {
+    std::ifstream statm("/proc/self/statm");
+    std::size_t pages = 0, resident = 0;
+    if (!(statm >> pages >> resident)) {
+        return 0;
+    }
+    return resident * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+}
+
+// @return: malloc 当前持有的字节数 (含分配器自身开销), 比 RSS 更不受内存复用影响
+inline std::size_t HeapInUse() {
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+}
+
+template <typename Fn>
+inline double TimeMs(Fn&& fn) {
+    auto begin = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+}
+
+// * 防止被测结果被编译器优化掉
+template <typename Ty>
+inline void DoNotOptimize(const Ty& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+}
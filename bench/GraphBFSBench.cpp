@@ -0,0 +1,79 @@
+// 方向优化 BFS 的线程扩展性: R-MAT 图 (Graph500 的参数 a=0.57 b=c=0.19), 纯自顶向下 vs 方向优化
+// 报告 MTEPS (每秒遍历的边数, 以连通分量内的边数计)
+//   GraphBFSBench [scale] [edge_factor]
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Graph/BFS.hpp"
+#include "BenchCommon.hpp"
+
+using namespace Moonlight::Graph;
+
+// @function: 逐位选择象限 a | b / c | d 生成一条边, 行落在 c 或 d 时 u 置位, 列落在 b 或 d 时 v 置位
+static void RMatEdge(std::mt19937_64& rng, unsigned scale, uint64_t& u, uint64_t& v) {
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    for (unsigned bit = 0; bit < scale; ++bit) {
+        double r = unit(rng);
+        bool row = r >= 0.57 + 0.19, col = (r >= 0.57 && r < 0.76) || r >= 0.95;
+        u |= static_cast<uint64_t>(row) << bit;
+        v |= static_cast<uint64_t>(col) << bit;
+    }
+}
+
+int main(int argc, char** argv) {
+    unsigned scale = argc > 1 ? static_cast<unsigned>(std::stoul(argv[1])) : 18;
+    unsigned edge_factor = argc > 2 ? static_cast<unsigned>(std::stoul(argv[2])) : 16;
+    const uint64_t n = uint64_t{1} << scale;
+
+    auto& graph = GraphManager<int, double>::Instance().GetAEmptyGraph();
+    graph.AddNVertex(n, 0);
+    std::mt19937_64 rng(500);
+    double load_ms = Bench::TimeMs([&] {
+        for (uint64_t i = 0; i < n * edge_factor; ++i) {
+            uint64_t u = 0, v = 0;
+            RMatEdge(rng, scale, u, v);
+            graph.AddEdge(u, v);
+        }
+    });
+    double csr_ms = Bench::TimeMs([&] { Bench::DoNotOptimize(graph.List()); });
+    const auto& csr = graph.List();
+
+    // 从度数最大的顶点出发, 保证落在巨型连通分量中
+    uint64_t source = 0;
+    for (uint64_t v = 1; v < n; ++v) {
+        if (csr.Degree(v) > csr.Degree(source)) source = v;
+    }
+    BFSResult reference = BFS(csr, source);
+    uint64_t traversed = 0;
+    for (uint64_t v = 0; v < n; ++v) {
+        if (reference.Reached(v)) traversed += csr.Degree(v);
+    }
+    std::printf("scale=%u n=%llu undirected edges=%llu (load %.0f ms, CSR %.0f ms), reached %.1f%%, hybrid steps td=%llu bu=%llu\n",
+                scale, static_cast<unsigned long long>(n), static_cast<unsigned long long>(graph.EdgeCount()), load_ms,
+                csr_ms, 100.0 * static_cast<double>(std::count_if(reference.parent.begin(), reference.parent.end(),
+                                                                  [](uint64_t p) { return p != Unreached; })) / n,
+                static_cast<unsigned long long>(reference.top_down_steps),
+                static_cast<unsigned long long>(reference.bottom_up_steps));
+
+    unsigned max_threads = std::max(4u, std::thread::hardware_concurrency());
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+        BFSOptions top_down;
+        top_down.alpha = 0;
+        top_down.threads = threads;
+        BFSOptions hybrid;
+        hybrid.threads = threads;
+        double td_ms = 1e300, hy_ms = 1e300;
+        for (int r = 0; r < 3; ++r) {
+            td_ms = std::min(td_ms, Bench::TimeMs([&] { Bench::DoNotOptimize(BFS(csr, source, top_down).parent.data()); }));
+            hy_ms = std::min(hy_ms, Bench::TimeMs([&] { Bench::DoNotOptimize(BFS(csr, source, hybrid).parent.data()); }));
+        }
+        std::printf("threads=%-3u top-down %8.1f ms %7.1f MTEPS   direction-optimizing %8.1f ms %7.1f MTEPS   (%.2fx)\n",
+                    threads, td_ms, traversed / td_ms / 1e3, hy_ms, traversed / hy_ms / 1e3, td_ms / hy_ms);
+        std::fflush(stdout);
+    }
+    return 0;
+}
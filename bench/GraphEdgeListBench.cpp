@@ -0,0 +1,61 @@
+// 文本边表加载: 逐行 ifstream >> + AddEdge  vs  mmap + 并行解析 + 批量 AddEdges
+// 报告解析阶段每个线程的 MB/s, 插入时间, 以及加载之后的峰值常驻内存
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <thread>
+
+#include <sys/resource.h>
+
+#include "Graph/EdgeListLoader.hpp"
+#include "BenchCommon.hpp"
+
+using namespace Moonlight::Graph;
+
+// @return: 进程峰值常驻内存 (MB)
+static double PeakRSSMB() {
+    struct rusage usage {};
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<double>(usage.ru_maxrss) / 1024.0;
+}
+
+int main(int argc, char** argv) {
+    const uint64_t n = argc > 1 ? std::stoull(argv[1]) : 1'000'000;
+    const uint64_t m = argc > 2 ? std::stoull(argv[2]) : 4'000'000;
+    const std::string path = (std::filesystem::temp_directory_path() / "moonlight_edge_bench.txt").string();
+    {
+        std::mt19937_64 rng(24);
+        std::ofstream out(path);
+        for (uint64_t i = 0; i < m; ++i) {
+            out << rng() % n << ' ' << rng() % n << ' ' << static_cast<double>(rng() % 1000) / 8 << '\n';
+        }
+    }
+    const double mb = static_cast<double>(std::filesystem::file_size(path)) / 1e6;
+    std::printf("edge list: n=%llu m=%llu %.1f MB, peak RSS before loading %.1f MB\n",
+                static_cast<unsigned long long>(n), static_cast<unsigned long long>(m), mb, PeakRSSMB());
+
+    for (unsigned threads : {1u, std::max(1u, std::thread::hardware_concurrency())}) {
+        GraphInstance<int, double> graph;
+        EdgeListStats stats;
+        double total_ms = Bench::TimeMs([&] { stats = LoadEdgeList(graph, path, {.threads = threads}); });
+        std::printf("LoadEdgeList  %2u threads: total %8.1f ms  parse %7.1f ms (%6.1f MB/s per core)  insert %8.1f ms  "
+                    "edges %llu  peak RSS %.1f MB\n",
+                    stats.threads, total_ms, stats.parse_ms, stats.ParseMBPerSecondPerCore(), stats.insert_ms,
+                    static_cast<unsigned long long>(graph.EdgeCount()), PeakRSSMB());
+    }
+    {
+        GraphInstance<int, double> graph;
+        double total_ms = Bench::TimeMs([&] {
+            std::ifstream in(path);
+            uint64_t u, v;
+            double w;
+            while (in >> u >> v >> w) graph.AddEdge(u, v, w);
+        });
+        std::printf("ifstream + AddEdge      : total %8.1f ms  (%6.1f MB/s)  edges %llu\n", total_ms, mb / (total_ms / 1e3),
+                    static_cast<unsigned long long>(graph.EdgeCount()));
+    }
+    std::filesystem::remove(path);
+    return 0;
+}
@@ -0,0 +1,75 @@
+// 随机无向图上的小批量边修改: 修改后整体重建 CSR vs 把 delta 合并进已有的 CSR
+// 另外报告 GraphInstance 上记录修改 + ForEachNeighbor 读 (CSR + delta) 的开销
+#include <cstdio>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "Graph/GraphManager.hpp"
+#include "BenchCommon.hpp"
+
+using namespace Moonlight::Graph;
+using EdgeSet = std::unordered_set<Edge<double>, Edge<double>::EdgeHash, Edge<double>::EdgeEqual>;
+
+static void Run(uint64_t n, std::size_t m, std::size_t batch) {
+    std::mt19937_64 rng(23);
+    EdgeSet edges;
+    edges.reserve(m + batch);
+    while (edges.size() < m) {
+        edges.insert(Edge<double>(rng() % n, rng() % n, static_cast<double>(rng() % 100)));
+    }
+    AdjacencyList<int, double> csr(n, edges);
+
+    // 一半插入新边, 一半删除已有的边
+    EdgeDelta<double> delta;
+    auto it = edges.begin();
+    for (std::size_t i = 0; i < batch; ++i) {
+        uint64_t u, v;
+        std::optional<double> weight;
+        if (i % 2) {
+            u = it->from, v = it->to;
+            ++it;
+        } else {
+            u = rng() % n, v = rng() % n, weight = 1.0;
+        }
+        Edge<double> edge(u, v, weight.value_or(0));
+        if (weight) edges.insert(edge); else edges.erase(edge);
+        delta[u][v] = weight;
+        delta[v][u] = weight;
+    }
+    double rebuild_ms = Bench::TimeMs([&] { AdjacencyList<int, double> fresh(n, edges); Bench::DoNotOptimize(fresh); });
+    double merge_ms = Bench::TimeMs([&] { csr.Merge(n, delta); });
+    Bench::DoNotOptimize(csr);
+
+    // GraphInstance: 记录修改并读取受影响顶点的邻居, 最后一次 List() 触发合并
+    GraphInstance<int, double> graph;
+    for (const auto& e : edges) graph.AddEdge(e.from, e.to, e.weight);
+    graph.AddEdge(n - 1, n - 1);
+    graph.List();
+    double sum = 0;
+    double record_ms = Bench::TimeMs([&] {
+        for (std::size_t i = 0; i < batch; ++i) {
+            uint64_t u = rng() % n, v = rng() % n;
+            graph.AddEdge(u, v, 2.0);
+            graph.ForEachNeighbor(u, [&](uint64_t x, double w) { sum += w * static_cast<double>(x); });
+        }
+    });
+    double flush_ms = Bench::TimeMs([&] { graph.List(); });
+    Bench::DoNotOptimize(sum);
+    std::printf("n=%-9llu m=%-9zu batch=%-6zu rebuild %8.2f ms  merge %7.2f ms (%5.1fx)   "
+                "record+read %7.1f ns/op  merge on List() %7.2f ms\n",
+                static_cast<unsigned long long>(n), m, batch, rebuild_ms, merge_ms, rebuild_ms / merge_ms,
+                record_ms * 1e6 / static_cast<double>(batch), flush_ms);
+}
+
+int main(int argc, char** argv) {
+    if (argc > 3) {
+        Run(std::stoull(argv[1]), std::stoull(argv[2]), std::stoull(argv[3]));
+        return 0;
+    }
+    for (std::size_t batch : {16, 256, 4096}) {
+        Run(200'000, 1'000'000, batch);
+    }
+    return 0;
+}
@@ -0,0 +1,92 @@
+// 单源最短路: std::priority_queue 二叉堆 Dijkstra (懒删除) vs 基数堆 / 配对堆 Dijkstra vs 并行 delta-stepping
+// 两种图: 均匀随机图 (小直径) 与网格 (大直径, 接近路网), 整数与浮点边权各测一次
+//   GraphSSSPBench [random|grid] [n]
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <queue>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Graph/ShortestPath.hpp"
+#include "BenchCommon.hpp"
+
+using namespace Moonlight::Graph;
+
+template <typename Weight>
+static std::vector<Weight> BinaryHeapDijkstra(const AdjacencyList<int, Weight>& graph, uint64_t source) {
+    std::vector<Weight> distance(graph.VertexCount(), InfiniteDistance<Weight>);
+    std::priority_queue<std::pair<Weight, uint64_t>, std::vector<std::pair<Weight, uint64_t>>, std::greater<>> queue;
+    distance[source] = 0;
+    queue.emplace(0, source);
+    while (!queue.empty()) {
+        auto [d, u] = queue.top();
+        queue.pop();
+        if (d != distance[u]) continue;
+        auto neighbors = graph.Neighbors(u);
+        auto weights = graph.Weights(u);
+        for (std::size_t i = 0; i < neighbors.size(); ++i) {
+            Weight candidate = d + weights[i];
+            if (candidate < distance[neighbors[i]]) queue.emplace(distance[neighbors[i]] = candidate, neighbors[i]);
+        }
+    }
+    return distance;
+}
+
+template <typename Weight>
+static void Run(const char* shape, uint64_t n, bool grid) {
+    std::mt19937_64 rng(21);
+    GraphInstance<int, Weight> graph;
+    graph.AddNVertex(n, 0);
+    auto weight = [&] {
+        if constexpr (std::is_integral_v<Weight>) return static_cast<Weight>(1 + rng() % 1000);
+        else return static_cast<Weight>(std::uniform_real_distribution<double>(0.001, 1.0)(rng));
+    };
+    if (grid) {
+        uint64_t side = 1;
+        while ((side + 1) * (side + 1) <= n) ++side;
+        for (uint64_t r = 0; r < side; ++r) {
+            for (uint64_t c = 0; c < side; ++c) {
+                if (c + 1 < side) graph.AddEdge(r * side + c, r * side + c + 1, weight());
+                if (r + 1 < side) graph.AddEdge(r * side + c, (r + 1) * side + c, weight());
+            }
+        }
+    } else {
+        for (uint64_t i = 0; i < 4 * n; ++i) graph.AddEdge(rng() % n, rng() % n, weight());
+    }
+    const auto& csr = graph.List();
+
+    std::vector<Weight> expected;
+    double heap_ms = Bench::TimeMs([&] { expected = BinaryHeapDijkstra(csr, 0); });
+    ShortestPathResult<Weight> result;
+    double radix_ms = Bench::TimeMs([&] { result = Dijkstra(csr, 0, Unreached, DijkstraHeap::Radix); });
+    bool same = result.distance == expected;
+    double pairing_ms = Bench::TimeMs([&] { result = Dijkstra(csr, 0, Unreached, DijkstraHeap::Pairing); });
+    same = same && result.distance == expected;
+    std::printf("%-6s %-6s n=%-8llu arcs=%-9llu std::priority_queue %7.1f ms   radix heap %7.1f ms (%.2fx)   "
+                "pairing heap %7.1f ms (%.2fx)%s\n",
+                shape, std::is_integral_v<Weight> ? "int" : "double", static_cast<unsigned long long>(n),
+                static_cast<unsigned long long>(csr.ArcCount()), heap_ms, radix_ms, heap_ms / radix_ms, pairing_ms,
+                heap_ms / pairing_ms, same ? "" : "  MISMATCH");
+    unsigned max_threads = std::max(4u, std::thread::hardware_concurrency());
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+        DeltaSteppingOptions<Weight> options;
+        options.threads = threads;
+        double delta_ms = Bench::TimeMs([&] { result = DeltaStepping(csr, 0, options); });
+        same = result.distance == expected;
+        std::printf("       delta-stepping threads=%-3u %8.1f ms (%.2fx vs std::priority_queue)%s\n", threads, delta_ms,
+                    heap_ms / delta_ms, same ? "" : "  MISMATCH");
+    }
+    std::fflush(stdout);
+}
+
+int main(int argc, char** argv) {
+    const char* shape = argc > 1 ? argv[1] : "random";
+    uint64_t n = argc > 2 ? std::stoull(argv[2]) : 1'000'000;
+    bool grid = !std::strcmp(shape, "grid");
+    Run<uint32_t>(shape, n, grid);
+    Run<double>(shape, n, grid);
+    return 0;
+}
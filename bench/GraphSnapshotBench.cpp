@@ -0,0 +1,55 @@
+// 图快照: Save 的时间与文件大小, Open 到可以查询的时间, 随机查询, 全量校验
+// 与从文本边表重新加载 (LoadEdgeList) 对比
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+
+#include "Graph/EdgeListLoader.hpp"
+#include "Graph/Snapshot.hpp"
+#include "BenchCommon.hpp"
+
+using namespace Moonlight::Graph;
+
+int main(int argc, char** argv) {
+    const uint64_t n = argc > 1 ? std::stoull(argv[1]) : 1'000'000;
+    const uint64_t m = argc > 2 ? std::stoull(argv[2]) : 4'000'000;
+    const auto directory = std::filesystem::temp_directory_path();
+    const std::string text_path = (directory / "moonlight_snapshot_bench.txt").string();
+    const std::string path = (directory / "moonlight_snapshot_bench.snapshot").string();
+    {
+        std::mt19937_64 rng(25);
+        std::ofstream out(text_path);
+        for (uint64_t i = 0; i < m; ++i) {
+            out << rng() % n << ' ' << rng() % n << ' ' << static_cast<double>(rng() % 1000) / 8 << '\n';
+        }
+    }
+
+    GraphInstance<int, double> graph;
+    double load_ms = Bench::TimeMs([&] { LoadEdgeList(graph, text_path); });
+    double csr_ms = Bench::TimeMs([&] { graph.List(); });
+    double save_ms = Bench::TimeMs([&] { GraphSnapshot<int, double>::Save(graph, path); });
+    std::printf("n=%llu m=%llu: text %.1f MB, snapshot %.1f MB\n", static_cast<unsigned long long>(n),
+                static_cast<unsigned long long>(m), static_cast<double>(std::filesystem::file_size(text_path)) / 1e6,
+                static_cast<double>(std::filesystem::file_size(path)) / 1e6);
+    std::printf("re-ingest from text: LoadEdgeList %8.1f ms + CSR %7.1f ms    Save %7.1f ms\n", load_ms, csr_ms, save_ms);
+
+    GraphSnapshot<int, double> snapshot;
+    double open_ms = Bench::TimeMs([&] { snapshot = GraphSnapshot<int, double>::Open(path); });
+    std::mt19937_64 rng(7);
+    double first_ms = Bench::TimeMs([&] { Bench::DoNotOptimize(snapshot.Neighbors(rng() % n).size()); });
+    uint64_t queries = 1'000'000, found = 0;
+    double query_ms = Bench::TimeMs([&] {
+        for (uint64_t i = 0; i < queries; ++i) found += snapshot.HasEdge(rng() % n, rng() % n);
+    });
+    Bench::DoNotOptimize(found);
+    bool ok = false;
+    double verify_ms = Bench::TimeMs([&] { ok = snapshot.Verify(); });
+    std::printf("Open %7.3f ms   first query %7.3f ms   HasEdge %6.1f ns/query   Verify %7.1f ms (%s)   RSS %.1f MB\n",
+                open_ms, first_ms, query_ms * 1e6 / static_cast<double>(queries), verify_ms, ok ? "ok" : "FAILED",
+                static_cast<double>(Bench::CurrentRSS()) / 1e6);
+    std::filesystem::remove(text_path);
+    std::filesystem::remove(path);
+    return 0;
+}
@@ -0,0 +1,54 @@
+// 对比 std::allocator 与 PoolAllocator 两条插入路径的吞吐与常驻内存
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "RBTree/RBTree.hpp"
+#include "RBTree/NodePool.hpp"
+#include "BenchCommon.hpp"
+
+using namespace RBTreeTools;
+using Bench::CurrentRSS;
+
+template <class Alloc>
+static void Run(const char* name, const std::vector<int>& keys) {
+    using Clock = std::chrono::steady_clock;
+    std::size_t rss_before = CurrentRSS();
+    auto begin = Clock::now();
+    double destroy_ms = 0;
+    // * RSS 可能因为 malloc 归还内存而下降, 差值按有符号数计算
+    std::ptrdiff_t rss_delta = 0;
+    {
+        RBTree<int, Alloc> tree;
+        for (int key : keys) {
+            tree.Insert(key);
+        }
+        auto end = Clock::now();
+        rss_delta = static_cast<std::ptrdiff_t>(CurrentRSS()) - static_cast<std::ptrdiff_t>(rss_before);
+        double sec = std::chrono::duration<double>(end - begin).count();
+        auto destroy_begin = Clock::now();
+        tree.Clear();
+        destroy_ms = std::chrono::duration<double, std::milli>(Clock::now() - destroy_begin).count();
+        std::printf("%-16s n=%-9zu %10.2f Minserts/s  rss=%8.1f MiB  teardown=%8.3f ms\n",
+                    name, keys.size(), keys.size() / sec / 1e6,
+                    static_cast<double>(rss_delta) / 1048576.0, destroy_ms);
+    }
+}
+
+int main(int argc, char** argv) {
+    std::size_t n = argc > 1 ? std::stoull(argv[1]) : 1'000'000;
+    std::vector<int> keys(n);
+    std::mt19937 rng(42);
+    for (auto& key : keys) {
+        key = static_cast<int>(rng());
+    }
+    // * 先跑池化版本, 避免 malloc 缓存的空闲内存让后者的 RSS 偏小
+    Run<PoolAllocator<RBNode<int>>>("PoolAllocator", keys);
+    Run<std::allocator<RBNode<int>>>("std::allocator", keys);
+    return 0;
+}
@@ -0,0 +1,269 @@
+// 回归基准: RBTree / CompactRBTree vs std::set / std::map
+// 负载 (random / sorted / zipf) x 规模 x 操作 (insert / find / erase / scan), 报告 ns/op 与 bytes/elem
+// 表格打印到 stdout; --csv <file> 另外写出机器可读的结果, 两次构建的结果可以直接 diff 或交给脚本比较
+//
+//   RBTreeBenchSuite [--csv results.csv] [--sizes 1000,100000,1000000] [--repeat 3] [--allow-unoptimized]
+//   cmake --build <dir> --target bench-suite    # 用默认参数运行并写出 <dir>/bench_results.csv
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <numeric>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "RBTree/RBTree.hpp"
+#include "BenchCommon.hpp"
+
+using namespace RBTreeTools;
+
+namespace {
+
+    struct Workload {
+        const char* name;
+        std::vector<int> inserts;  // * 插入/删除的顺序, zipf 下含大量重复
+        std::vector<int> probes;   // * 查找的顺序
+    };
+
+    struct Row {
+        std::string workload;
+        std::size_t n;
+        std::string container;
+        std::string op;
+        double ns_per_op;
+        double bytes_per_elem;
+    };
+
+    /*
+    * @function: Zipf(s) 分布的秩, 秩 0 最热; 用 CDF + 二分采样
+    * @note: 秩经过随机置换映射到键, 热点键不会恰好是最小的几个
+    */
+    class ZipfGenerator {
+    public:
+        ZipfGenerator(std::size_t universe, double s, std::mt19937_64& rng) : _m_cdf(universe), _m_keys(universe) {
+            double sum = 0;
+            for (std::size_t i = 0; i < universe; ++i) {
+                sum += 1.0 / std::pow(static_cast<double>(i + 1), s);
+                _m_cdf[i] = sum;
+            }
+            for (double& c : _m_cdf) c /= sum;
+            std::iota(_m_keys.begin(), _m_keys.end(), 0);
+            std::shuffle(_m_keys.begin(), _m_keys.end(), rng);
+        }
+        int operator()(std::mt19937_64& rng) const {
+            double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+            auto rank = static_cast<std::size_t>(std::lower_bound(_m_cdf.begin(), _m_cdf.end(), u) - _m_cdf.begin());
+            return _m_keys[std::min(rank, _m_keys.size() - 1)];
+        }
+
+    private:
+        std::vector<double> _m_cdf;
+        std::vector<int> _m_keys;
+    };
+
+    std::vector<Workload> MakeWorkloads(std::size_t n) {
+        std::mt19937_64 rng(42);
+        std::vector<Workload> workloads;
+
+        Workload random{"random", std::vector<int>(n), std::vector<int>(n)};
+        for (auto& key : random.inserts) key = static_cast<int>(rng() >> 33);
+        for (auto& probe : random.probes) probe = random.inserts[rng() % n];
+        workloads.push_back(std::move(random));
+
+        Workload sorted{"sorted", std::vector<int>(n), std::vector<int>(n)};
+        std::iota(sorted.inserts.begin(), sorted.inserts.end(), 0);
+        sorted.probes = sorted.inserts;
+        workloads.push_back(std::move(sorted));
+
+        // 键空间为 n, s = 0.99 (YCSB 的默认值)
+        ZipfGenerator zipf(n, 0.99, rng);
+        Workload skewed{"zipf", std::vector<int>(n), std::vector<int>(n)};
+        for (auto& key : skewed.inserts) key = zipf(rng);
+        for (auto& probe : skewed.probes) probe = zipf(rng);
+        workloads.push_back(std::move(skewed));
+        return workloads;
+    }
+
+    /*
+    * @function: 对一种容器跑完 insert / find / scan / erase
+    * @param: ops 提供 insert(k), find(k) -> bool, scan(sum&), erase(k), size()
+    */
+    template <typename Container, typename Ops>
+    void Measure(const Workload& workload, std::size_t n, const char* name, std::size_t repeat,
+                 Ops ops, std::vector<Row>& rows) {
+        double insert_ns = 1e300, find_ns = 1e300, scan_ns = 1e300, erase_ns = 1e300, bytes = 0;
+        for (std::size_t r = 0; r < repeat; ++r) {
+            Container container;
+            std::size_t heap = Bench::HeapInUse();
+            double ms = Bench::TimeMs([&] { for (int k : workload.inserts) ops.insert(container, k); });
+            insert_ns = std::min(insert_ns, ms * 1e6 / workload.inserts.size());
+            std::size_t size = ops.size(container);
+            bytes = size ? static_cast<double>(Bench::HeapInUse() - heap) / size : 0.0;
+
+            std::size_t hits = 0;
+            ms = Bench::TimeMs([&] { for (int k : workload.probes) hits += ops.find(container, k); });
+            find_ns = std::min(find_ns, ms * 1e6 / workload.probes.size());
+            Bench::DoNotOptimize(hits);
+
+            std::int64_t sum = 0;
+            ms = Bench::TimeMs([&] { ops.scan(container, sum); });
+            scan_ns = std::min(scan_ns, size ? ms * 1e6 / size : 0.0);
+            Bench::DoNotOptimize(sum);
+
+            ms = Bench::TimeMs([&] { for (int k : workload.inserts) ops.erase(container, k); });
+            erase_ns = std::min(erase_ns, ms * 1e6 / workload.inserts.size());
+        }
+        for (auto [op, ns] : {std::pair{"insert", insert_ns}, std::pair{"find", find_ns},
+                              std::pair{"scan", scan_ns}, std::pair{"erase", erase_ns}}) {
+            rows.push_back({workload.name, n, name, op, ns, bytes});
+        }
+    }
+
+    template <typename Tree>
+    struct RBTreeOps {
+        void insert(Tree& tree, int k) const { tree.Insert(k); }
+        bool find(const Tree& tree, int k) const { return tree.Find(k) != nullptr; }
+        void scan(const Tree& tree, std::int64_t& sum) const {
+            RBTreeTools::Traversal(tree.Root(), [&](auto* node) { sum += node->val; });
+        }
+        void erase(Tree& tree, int k) const { tree.Remove(k); }
+        std::size_t size(const Tree& tree) const {
+            std::size_t count = 0;
+            RBTreeTools::Traversal(tree.Root(), [&](auto*) { ++count; });
+            return count;
+        }
+    };
+
+    struct SetOps {
+        void insert(std::set<int>& set, int k) const { set.insert(k); }
+        bool find(const std::set<int>& set, int k) const { return set.find(k) != set.end(); }
+        void scan(const std::set<int>& set, std::int64_t& sum) const { for (int v : set) sum += v; }
+        void erase(std::set<int>& set, int k) const { set.erase(k); }
+        std::size_t size(const std::set<int>& set) const { return set.size(); }
+    };
+
+    struct MapOps {
+        void insert(std::map<int, int>& map, int k) const { map.emplace(k, k); }
+        bool find(const std::map<int, int>& map, int k) const { return map.find(k) != map.end(); }
+        void scan(const std::map<int, int>& map, std::int64_t& sum) const { for (auto& [k, v] : map) sum += v; }
+        void erase(std::map<int, int>& map, int k) const { map.erase(k); }
+        std::size_t size(const std::map<int, int>& map) const { return map.size(); }
+    };
+
+    /*
+    * @function: 解析 "n1,n2,..." 形式的规模列表
+    * @return: 出现非数字, 空项或 0 时返回 false
+    */
+    bool ParseSizes(const char* text, std::vector<std::size_t>& sizes) {
+        sizes.clear();
+        for (const char* p = text; ; ++p) {
+            if (*p < '0' || *p > '9') return false;
+            char* end = nullptr;
+            errno = 0;
+            unsigned long long n = std::strtoull(p, &end, 10);
+            if (errno == ERANGE || n == 0) return false;
+            sizes.push_back(static_cast<std::size_t>(n));
+            p = end;
+            if (*p == '\0') return true;
+            if (*p != ',') return false;
+        }
+    }
+
+    bool ParseCount(const char* text, std::size_t& count) {
+        if (*text < '0' || *text > '9') return false;
+        char* end = nullptr;
+        errno = 0;
+        unsigned long long n = std::strtoull(text, &end, 10);
+        if (errno == ERANGE || *end != '\0') return false;
+        count = static_cast<std::size_t>(n);
+        return true;
+    }
+
+    int Usage(const char* program) {
+        std::fprintf(stderr, "usage: %s [--csv file] [--sizes n1,n2,...] [--repeat r] [--allow-unoptimized]\n", program);
+        return 1;
+    }
+}
+
+// * 两个宏由 CMake 传入; 单配置生成器未指定 CMAKE_BUILD_TYPE 时构建类型为空串 (此时基准按 -O2 编译)
+#ifndef MOONLIGHT_BENCH_BUILD_TYPE
+#define MOONLIGHT_BENCH_BUILD_TYPE "unknown"
+#endif
+#ifndef MOONLIGHT_BENCH_COMPILER
+#define MOONLIGHT_BENCH_COMPILER __VERSION__
+#endif
+
+namespace {
+    const char* BuildType() {
+        return MOONLIGHT_BENCH_BUILD_TYPE[0] ? MOONLIGHT_BENCH_BUILD_TYPE : "none (-O2)";
+    }
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::size_t> sizes {1'000, 100'000, 1'000'000};
+    std::size_t repeat = 3;
+    const char* csv_path = nullptr;
+    bool allow_unoptimized = false;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--csv") && i + 1 < argc) {
+            csv_path = argv[++i];
+        } else if (!std::strcmp(argv[i], "--sizes") && i + 1 < argc) {
+            if (!ParseSizes(argv[++i], sizes)) return Usage(argv[0]);
+        } else if (!std::strcmp(argv[i], "--repeat") && i + 1 < argc) {
+            if (!ParseCount(argv[++i], repeat)) return Usage(argv[0]);
+            repeat = std::max<std::size_t>(1, repeat);
+        } else if (!std::strcmp(argv[i], "--allow-unoptimized")) {
+            allow_unoptimized = true;
+        } else {
+            return Usage(argv[0]);
+        }
+    }
+#ifndef __OPTIMIZE__
+    // * 未优化的构建测出来的数字没有比较意义, 除非显式要求否则直接拒绝
+    if (!allow_unoptimized) {
+        std::fprintf(stderr, "%s: built without optimization (%s); configure with -DCMAKE_BUILD_TYPE=Release "
+                             "or pass --allow-unoptimized\n", argv[0], BuildType());
+        return 1;
+    }
+#else
+    (void)allow_unoptimized;
+#endif
+    std::printf("build: %s, compiler: %s\n", BuildType(), MOONLIGHT_BENCH_COMPILER);
+
+    std::vector<Row> rows;
+    for (std::size_t n : sizes) {
+        for (const Workload& workload : MakeWorkloads(n)) {
+            Measure<RBTree<int>>(workload, n, "RBTree", repeat, RBTreeOps<RBTree<int>>{}, rows);
+            Measure<CompactRBTree<int>>(workload, n, "CompactRBTree", repeat, RBTreeOps<CompactRBTree<int>>{}, rows);
+            Measure<std::set<int>>(workload, n, "std::set", repeat, SetOps{}, rows);
+            Measure<std::map<int, int>>(workload, n, "std::map", repeat, MapOps{}, rows);
+            for (auto it = rows.end() - 16; it != rows.end(); ++it) {
+                std::printf("%-7s n=%-9zu %-14s %-6s %9.1f ns/op %7.1f B/elem\n", it->workload.c_str(), it->n,
+                            it->container.c_str(), it->op.c_str(), it->ns_per_op, it->bytes_per_elem);
+            }
+            std::fflush(stdout);
+        }
+    }
+
+    if (csv_path) {
+        FILE* out = std::fopen(csv_path, "w");
+        if (!out) {
+            std::perror(csv_path);
+            return 1;
+        }
+        // * 以 # 开头的注释行记录构建信息, 比较两份结果时先确认它们来自可比的构建
+        std::fprintf(out, "# build_type=%s\n# compiler=%s\n", BuildType(), MOONLIGHT_BENCH_COMPILER);
+        std::fprintf(out, "workload,n,container,op,ns_per_op,bytes_per_elem\n");
+        for (const Row& row : rows) {
+            std::fprintf(out, "%s,%zu,%s,%s,%.2f,%.2f\n", row.workload.c_str(), row.n, row.container.c_str(),
+                         row.op.c_str(), row.ns_per_op, row.bytes_per_elem);
+        }
+        std::fclose(out);
+    }
+    return 0;
+}
@@ -0,0 +1,59 @@
+// 有序序列建树 / 批量插入 与 main.cpp 中逐个 InsertRBTree 的对比
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "RBTree/RBTree.hpp"
+#include "BenchCommon.hpp"
+
+using namespace RBTreeTools;
+using Node = RBNode<int>;
+using Bench::TimeMs;
+
+static void Run(std::size_t n) {
+    std::vector<int> sorted(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        sorted[i] = static_cast<int>(i * 2);
+    }
+
+    Node* loop_root = nullptr;
+    double loop_ms = TimeMs([&] {
+        for (int v : sorted) InsertRBTree(loop_root, v);
+    });
+    Node* bulk_root = nullptr;
+    double bulk_ms = TimeMs([&] {
+        bulk_root = BuildFromSorted(sorted.begin(), sorted.end());
+    });
+    std::printf("n=%-9zu sorted build : loop %9.1f ms  BuildFromSorted %8.1f ms  speedup %6.1fx\n",
+                n, loop_ms, bulk_ms, loop_ms / bulk_ms);
+
+    // * 向已有的树中合并一批 n/2 个乱序的奇数
+    std::vector<int> batch(n / 2);
+    for (std::size_t i = 0; i < batch.size(); ++i) {
+        batch[i] = static_cast<int>(i * 4 + 1);
+    }
+    std::shuffle(batch.begin(), batch.end(), std::mt19937(42));
+    double each_ms = TimeMs([&] {
+        for (int v : batch) InsertRBTree(loop_root, v);
+    });
+    double range_ms = TimeMs([&] {
+        InsertRange(bulk_root, batch.begin(), batch.end());
+    });
+    std::printf("n=%-9zu merge n/2    : loop %9.1f ms  InsertRange     %8.1f ms  speedup %6.1fx\n",
+                n, each_ms, range_ms, each_ms / range_ms);
+
+    DestroyRBTree(loop_root);
+    DestroyRBTree(bulk_root);
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1) {
+        Run(std::stoull(argv[1]));
+        return 0;
+    }
+    Run(1'000'000);
+    Run(10'000'000);
+    return 0;
+}
@@ -0,0 +1,59 @@
+// RBNode 与 CompactRBNode 的内存占用与查找延迟对比
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "RBTree/RBTree.hpp"
+#include "RBTree/NodePool.hpp"
+#include "BenchCommon.hpp"
+
+using namespace RBTreeTools;
+
+// * glibc malloc 会把 32/40 字节的请求都凑成 48 字节的 chunk, 所以这里用 PoolAllocator 按 sizeof 紧密排布
+template <typename Node>
+static void Run(const char* name, const std::vector<typename Node::value_type>& keys,
+                const std::vector<typename Node::value_type>& probes) {
+    std::size_t heap_before = Bench::HeapInUse();
+    RBTree<typename Node::value_type, PoolAllocator<Node>> tree;
+    for (auto key : keys) {
+        tree.Insert(key);
+    }
+    std::size_t heap = Bench::HeapInUse() - heap_before;
+
+    std::size_t hits = 0;
+    double ms = Bench::TimeMs([&] {
+        for (auto probe : probes) {
+            hits += tree.Find(probe) != nullptr;
+        }
+    });
+    Bench::DoNotOptimize(hits);
+    std::printf("%-23s sizeof=%2zu  n=%-9zu heap/elem=%5.1f B  find=%7.1f ns/op\n",
+                name, sizeof(Node), keys.size(), double(heap) / keys.size(),
+                ms * 1e6 / probes.size());
+}
+
+template <typename Key>
+static void RunSize(std::size_t n, const char* compact_name, const char* plain_name) {
+    std::mt19937_64 rng(42);
+    std::vector<Key> keys(n);
+    for (auto& key : keys) key = static_cast<Key>(rng());
+    std::vector<Key> probes(2'000'000);
+    for (auto& probe : probes) probe = keys[rng() % n];
+
+    Run<CompactRBNode<Key>>(compact_name, keys, probes);
+    Run<RBNode<Key>>(plain_name, keys, probes);
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::size_t> sizes = {10'000, 1'000'000, 4'000'000};
+    if (argc > 1) {
+        sizes = {std::stoull(argv[1])};
+    }
+    for (std::size_t n : sizes) {
+        RunSize<int>(n, "CompactRBNode<int>", "RBNode<int>");
+        RunSize<std::int64_t>(n, "CompactRBNode<int64_t>", "RBNode<int64_t>");
+    }
+    return 0;
+}
@@ -0,0 +1,91 @@
+// 读多写少: ConcurrentRBTree (无锁读 + epoch 回收) vs RBTree + std::shared_mutex
+// 1 个写者持续插入随机值, N 个读者持续随机查找, 统计固定时长内的读/写吞吐
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "RBTree/RBTree.hpp"
+#include "RBTree/Concurrent.hpp"
+#include "BenchCommon.hpp"
+
+using namespace RBTreeTools;
+
+constexpr int KeyRange = 1 << 24;
+
+struct LockedTree {
+    RBTree<int> tree;
+    mutable std::shared_mutex mutex;
+
+    bool Contains(int v) const {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        return RBTreeTools::Find(tree.Root(), v) != nullptr;
+    }
+    void Insert(int v) {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        tree.Insert(v);
+    }
+};
+
+template <typename Tree>
+static void Run(const char* name, Tree& tree, std::size_t readers, std::chrono::milliseconds duration) {
+    std::atomic<bool> stop{false};
+    std::atomic<std::size_t> reads{0};
+    std::size_t writes = 0;
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < readers; ++t) {
+        threads.emplace_back([&, t] {
+            std::mt19937 rng(static_cast<unsigned>(t + 1));
+            std::size_t local = 0, hits = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                for (int i = 0; i < 64; ++i) {
+                    hits += tree.Contains(static_cast<int>(rng() % KeyRange));
+                }
+                local += 64;
+            }
+            Bench::DoNotOptimize(hits);
+            reads.fetch_add(local);
+        });
+    }
+    std::thread writer([&] {
+        std::mt19937 rng(12345);
+        while (!stop.load(std::memory_order_relaxed)) {
+            tree.Insert(static_cast<int>(rng() % KeyRange));
+            ++writes;
+        }
+    });
+    std::this_thread::sleep_for(duration);
+    stop = true;
+    writer.join();
+    for (auto& thread : threads) thread.join();
+    double seconds = std::chrono::duration<double>(duration).count();
+    std::printf("%-16s readers=%-3zu reads %8.2f M/s   writes %7.3f M/s\n", name, readers,
+                reads.load() / seconds / 1e6, writes / seconds / 1e6);
+}
+
+int main(int argc, char** argv) {
+    std::size_t n = argc > 1 ? std::stoull(argv[1]) : 1'000'000;
+    std::size_t max_readers = std::max(4u, 2 * std::thread::hardware_concurrency());
+    std::chrono::milliseconds duration(1000);
+    std::printf("hardware threads: %u, preload %zu keys\n", std::thread::hardware_concurrency(), n);
+
+    for (std::size_t readers = 1; readers <= max_readers; readers *= 2) {
+        std::mt19937 rng(7);
+        {
+            LockedTree locked;
+            for (std::size_t i = 0; i < n; ++i) locked.tree.Insert(static_cast<int>(rng() % KeyRange));
+            Run("shared_mutex", locked, readers, duration);
+        }
+        rng.seed(7);
+        {
+            ConcurrentRBTree<int> concurrent;
+            for (std::size_t i = 0; i < n; ++i) concurrent.Insert(static_cast<int>(rng() % KeyRange));
+            Run("epoch/path-copy", concurrent, readers, duration);
+        }
+    }
+    return 0;
+}
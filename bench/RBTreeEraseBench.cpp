@@ -0,0 +1,57 @@
+// 删除: 逐个 Remove vs EraseRange (Split/Join2), 以及大量增删后的树高
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "RBTree/RBTree.hpp"
+#include "RBTree/SetOps.hpp"
+#include "BenchCommon.hpp"
+
+using namespace RBTreeTools;
+
+template <typename NodeTp>
+static std::size_t MaxDepth(const NodeTp* node) {
+    return node ? 1 + std::max(MaxDepth(node->left), MaxDepth(node->right)) : 0;
+}
+
+static void Run(std::size_t n) {
+    std::vector<int> keys(n);
+    for (std::size_t i = 0; i < n; ++i) keys[i] = static_cast<int>(i);
+
+    for (std::size_t k : {std::size_t{1000}, n / 10, n / 2}) {
+        int lo = static_cast<int>(n / 4), hi = lo + static_cast<int>(k) - 1;
+        RBTree<int> looped;
+        looped.BuildFromSorted(keys.begin(), keys.end());
+        double loop_ms = Bench::TimeMs([&] {
+            for (int v = lo; v <= hi; ++v) looped.Remove(v);
+        });
+        RBTree<int> ranged;
+        ranged.BuildFromSorted(keys.begin(), keys.end());
+        std::size_t erased = 0;
+        double range_ms = Bench::TimeMs([&] { erased = ranged.EraseRange(lo, hi); });
+        std::printf("n=%-9zu k=%-9zu Remove x k %9.3f ms   EraseRange %9.3f ms (%zu erased)\n",
+                    n, k, loop_ms, range_ms, erased);
+    }
+
+    // 随机增删后的树高, 应始终 <= 2 log2(n + 1)
+    std::mt19937 rng(5);
+    RBTree<int> churned;
+    for (std::size_t round = 0; round < 4 * n; ++round) {
+        int v = static_cast<int>(rng() % n);
+        if (rng() % 2) churned.Insert(v); else churned.Remove(v);
+    }
+    std::size_t size = std::distance(churned.begin(), churned.end());
+    std::printf("n=%-9zu after %zu random insert/remove: size %zu, max depth %zu\n",
+                n, 4 * n, size, MaxDepth(churned.Root()));
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1) {
+        Run(std::stoull(argv[1]));
+        return 0;
+    }
+    Run(1'000'000);
+    return 0;
+}
@@ -0,0 +1,74 @@
+// 查找: 逐个 Find vs FindMany (8 路交错 + 预取); std::string 键上异构查找 vs 构造临时 std::string
+#include <cstdio>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "RBTree/RBTree.hpp"
+#include "BenchCommon.hpp"
+
+using namespace RBTreeTools;
+
+static void RunInt(std::size_t n, std::size_t queries) {
+    std::mt19937 rng(3);
+    RBTree<int> tree;
+    std::vector<int> keys(n);
+    for (auto& key : keys) {
+        key = static_cast<int>(rng() >> 1);
+        tree.Insert(key);
+    }
+    std::vector<int> probes(queries);
+    for (auto& probe : probes) probe = rng() % 2 ? keys[rng() % n] : static_cast<int>(rng() >> 1);
+
+    std::size_t hits = 0;
+    double single_ms = Bench::TimeMs([&] {
+        for (int probe : probes) hits += tree.Find(probe) != nullptr;
+    });
+    std::vector<RBNode<int>*> found(queries);
+    double batched_ms = Bench::TimeMs([&] {
+        tree.FindMany(probes.begin(), probes.end(), found.begin());
+    });
+    Bench::DoNotOptimize(hits);
+    Bench::DoNotOptimize(found.data());
+    std::printf("int    n=%-9zu Find %7.1f ns/op   FindMany %7.1f ns/op   speedup %.2fx\n", n,
+                single_ms * 1e6 / queries, batched_ms * 1e6 / queries, single_ms / batched_ms);
+}
+
+static void RunString(std::size_t n, std::size_t queries) {
+    std::mt19937 rng(4);
+    RBTree<std::string> plain;
+    RBTree<std::string, std::allocator<RBNode<std::string>>, std::less<>> transparent;
+    std::vector<std::string> keys(n);
+    for (auto& key : keys) {
+        key = "user:" + std::to_string(rng()) + ":session:" + std::to_string(rng());
+        plain.Insert(key);
+        transparent.Insert(key);
+    }
+    std::vector<std::string_view> probes(queries);
+    for (auto& probe : probes) probe = keys[rng() % n];
+
+    std::size_t hits = 0;
+    double temp_ms = Bench::TimeMs([&] {
+        for (std::string_view probe : probes) hits += plain.Find(std::string(probe)) != nullptr;
+    });
+    double hetero_ms = Bench::TimeMs([&] {
+        for (std::string_view probe : probes) hits += transparent.Find(probe) != nullptr;
+    });
+    Bench::DoNotOptimize(hits);
+    std::printf("string n=%-9zu Find(std::string(sv)) %7.1f ns/op   Find(sv) %7.1f ns/op\n", n,
+                temp_ms * 1e6 / queries, hetero_ms * 1e6 / queries);
+}
+
+int main(int argc, char** argv) {
+    std::size_t queries = 1'000'000;
+    if (argc > 1) {
+        RunInt(std::stoull(argv[1]), queries);
+        return 0;
+    }
+    for (std::size_t n : {std::size_t{10'000}, std::size_t{1'000'000}, std::size_t{10'000'000}}) {
+        RunInt(n, queries);
+    }
+    RunString(1'000'000, queries);
+    return 0;
+}
@@ -0,0 +1,59 @@
+// 只读查找: RBTreeTools::Find (指针树) vs FrozenRBTree (Eytzinger + 预取) vs std::lower_bound (有序数组)
+// n 从 L1 可容纳 (2^10) 到远超 LLC (2^24), 随机查找, 一半命中
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "RBTree/RBTree.hpp"
+#include "RBTree/Frozen.hpp"
+#include "BenchCommon.hpp"
+
+using namespace RBTreeTools;
+
+static void Run(std::size_t n, std::size_t queries) {
+    std::mt19937 rng(5);
+    std::vector<int> sorted(n);
+    for (std::size_t i = 0; i < n; ++i) sorted[i] = static_cast<int>(2 * i);
+    RBTree<int> tree;
+    // 打乱后逐个插入, 节点在堆上的分布接近真实使用场景
+    std::vector<int> shuffled = sorted;
+    std::shuffle(shuffled.begin(), shuffled.end(), rng);
+    for (int v : shuffled) tree.Insert(v);
+    auto frozen = Freeze(tree);
+
+    std::vector<int> probes(queries);
+    for (auto& probe : probes) probe = static_cast<int>(rng() % (2 * n));
+
+    std::size_t hits = 0;
+    double tree_ms = Bench::TimeMs([&] {
+        for (int probe : probes) hits += RBTreeTools::Find(tree.Root(), probe) != nullptr;
+    });
+    double frozen_ms = Bench::TimeMs([&] {
+        for (int probe : probes) hits += frozen.Find(probe) != nullptr;
+    });
+    double array_ms = Bench::TimeMs([&] {
+        for (int probe : probes) {
+            auto it = std::lower_bound(sorted.begin(), sorted.end(), probe);
+            hits += it != sorted.end() && *it == probe;
+        }
+    });
+    Bench::DoNotOptimize(hits);
+    std::printf("n=2^%-2d %-9zu RBTree %7.1f ns/op   Frozen %7.1f ns/op   sorted-array %7.1f ns/op   speedup %.2fx\n",
+                std::countr_zero(n), n, tree_ms * 1e6 / queries, frozen_ms * 1e6 / queries,
+                array_ms * 1e6 / queries, tree_ms / frozen_ms);
+}
+
+int main(int argc, char** argv) {
+    std::size_t queries = 2'000'000;
+    if (argc > 1) {
+        Run(std::stoull(argv[1]), queries);
+        return 0;
+    }
+    for (int log = 10; log <= 24; log += 2) {
+        Run(std::size_t{1} << log, queries);
+    }
+    return 0;
+}
@@ -0,0 +1,52 @@
+// 基本有序的输入流: 逐个 Insert (每次从根下降) vs InsertHint (以上一次插入的节点为手指) vs std::set::emplace_hint
+#include <cstdio>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "RBTree/RBTree.hpp"
+#include "BenchCommon.hpp"
+
+using namespace RBTreeTools;
+
+static void Run(const char* name, const std::vector<long long>& stream) {
+    std::size_t n = stream.size();
+    double plain_ms = Bench::TimeMs([&] {
+        RBTree<long long> tree;
+        for (long long v : stream) tree.Insert(v);
+        Bench::DoNotOptimize(tree.Root());
+    });
+    double hint_ms = Bench::TimeMs([&] {
+        RBTree<long long> tree;
+        RBNode<long long>* last = nullptr;
+        for (long long v : stream) last = tree.InsertHint(last, v);
+        Bench::DoNotOptimize(tree.Root());
+    });
+    double std_ms = Bench::TimeMs([&] {
+        std::set<long long> set;
+        auto last = set.end();
+        for (long long v : stream) last = set.emplace_hint(last, v);
+        Bench::DoNotOptimize(set.size());
+    });
+    std::printf("%-14s n=%-9zu Insert %6.1f ns/op   InsertHint %6.1f ns/op   std::set hint %6.1f ns/op   speedup %.2fx\n",
+                name, n, plain_ms * 1e6 / n, hint_ms * 1e6 / n, std_ms * 1e6 / n, plain_ms / hint_ms);
+}
+
+int main(int argc, char** argv) {
+    std::size_t n = argc > 1 ? std::stoull(argv[1]) : 1'000'000;
+    std::mt19937_64 rng(9);
+    std::vector<long long> sorted(n), reverse(n), nearly(n), random(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        sorted[i] = static_cast<long long>(i);
+        reverse[i] = static_cast<long long>(n - i);
+        // 时间戳: 大体递增, 每个元素最多偏离有序位置约 32 个元素
+        nearly[i] = static_cast<long long>(i * 16 + rng() % 512);
+        random[i] = static_cast<long long>(rng() >> 1);
+    }
+    Run("sorted", sorted);
+    Run("reverse", reverse);
+    Run("nearly-sorted", nearly);
+    Run("random", random);
+    return 0;
+}
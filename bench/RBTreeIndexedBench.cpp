@@ -0,0 +1,55 @@
+// 内存与查找: 指针链接的 RBNode<int> vs 下标链接, 连续存放的 IndexedRBNode<int>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "RBTree/RBTree.hpp"
+#include "RBTree/Indexed.hpp"
+#include "BenchCommon.hpp"
+
+using namespace RBTreeTools;
+
+template <typename Tree, typename Build, typename Lookup>
+static void Measure(const char* name, std::size_t n, const std::vector<int>& probes, Build&& build, Lookup&& lookup) {
+    std::size_t heap_before = Bench::HeapInUse();
+    Tree tree;
+    double insert_ms = Bench::TimeMs([&] { build(tree); });
+    double bytes = static_cast<double>(Bench::HeapInUse() - heap_before) / n;
+    std::size_t hits = 0;
+    double find_ms = Bench::TimeMs([&] {
+        for (int probe : probes) hits += lookup(tree, probe);
+    });
+    Bench::DoNotOptimize(hits);
+    std::printf("n=%-9zu %-22s %6.1f bytes/elem   insert %7.1f ns/op   find %7.1f ns/op\n", n, name, bytes,
+                insert_ms * 1e6 / n, find_ms * 1e6 / probes.size());
+}
+
+static void Run(std::size_t n) {
+    std::mt19937 rng(8);
+    std::vector<int> keys(n);
+    for (auto& key : keys) key = static_cast<int>(rng() >> 1);
+    std::vector<int> probes(1'000'000);
+    for (auto& probe : probes) probe = keys[rng() % n];
+
+    Measure<RBTree<int>>("RBNode<int> (pointer)", n, probes,
+        [&](auto& tree) { for (int key : keys) tree.Insert(key); },
+        [](auto& tree, int key) { return tree.Find(key) != nullptr; });
+    Measure<IndexedRBTree<int>>("Indexed (growing)", n, probes,
+        [&](auto& tree) { for (int key : keys) tree.Insert(key); },
+        [](auto& tree, int key) { return tree.Contains(key); });
+    Measure<IndexedRBTree<int>>("Indexed (reserved)", n, probes,
+        [&](auto& tree) { tree.Reserve(n); for (int key : keys) tree.Insert(key); },
+        [](auto& tree, int key) { return tree.Contains(key); });
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1) {
+        Run(std::stoull(argv[1]));
+        return 0;
+    }
+    Run(100'000);
+    Run(1'000'000);
+    Run(10'000'000);
+    return 0;
+}
@@ -0,0 +1,58 @@
+// 区间重叠查询: Traversal 线性扫描 vs 区间树 ForEachOverlapping
+// n 个长度随机的时间段, 分别做点查询 (刺穿) 和窗口查询
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "RBTree/RBTree.hpp"
+#include "RBTree/Interval.hpp"
+#include "BenchCommon.hpp"
+
+using namespace RBTreeTools;
+
+static void Run(std::size_t n, int window, std::size_t queries) {
+    using INode = IntervalRBNode<long long>;
+    const long long span = 1'000'000'000;
+    std::mt19937_64 rng(11);
+    IntervalRBTree<long long> ranges;
+    for (std::size_t i = 0; i < n; ++i) {
+        long long lo = static_cast<long long>(rng() % span);
+        ranges.Insert(Interval<long long>{lo, lo + static_cast<long long>(rng() % 100'000)});
+    }
+    std::vector<long long> probes(queries);
+    for (auto& probe : probes) probe = static_cast<long long>(rng() % span);
+
+    std::size_t scan_hits = 0, tree_hits = 0;
+    // 线性扫描太慢, 只测一小部分查询再折算
+    std::size_t scan_queries = std::min<std::size_t>(queries, 20);
+    double scan_ms = Bench::TimeMs([&] {
+        for (std::size_t q = 0; q < scan_queries; ++q) {
+            long long lo = probes[q], hi = probes[q] + window;
+            Traversal(ranges.Root(), [&](INode* node) { scan_hits += node->val.Overlaps(lo, hi); });
+        }
+    });
+    double tree_ms = Bench::TimeMs([&] {
+        for (long long lo : probes) {
+            ForEachOverlapping(ranges.Root(), lo, lo + window, [&](INode*) { ++tree_hits; });
+        }
+    });
+    Bench::DoNotOptimize(scan_hits);
+    std::printf("n=%-9zu window=%-7d avg k=%6.2f   scan %12.1f ns/query   interval tree %8.1f ns/query\n",
+                n, window, static_cast<double>(tree_hits) / queries, scan_ms * 1e6 / scan_queries,
+                tree_ms * 1e6 / queries);
+}
+
+int main(int argc, char** argv) {
+    std::size_t queries = 200'000;
+    if (argc > 1) {
+        Run(std::stoull(argv[1]), 0, queries);
+        return 0;
+    }
+    for (std::size_t n : {std::size_t{10'000}, std::size_t{1'000'000}, std::size_t{4'000'000}}) {
+        Run(n, 0, queries);
+        Run(n, 1'000'000, queries);
+    }
+    return 0;
+}
@@ -0,0 +1,63 @@
+// 持久化红黑树: 无快照时的写入开销, 定期快照时的写入开销与内存, 快照本身的耗时
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "RBTree/RBTree.hpp"
+#include "RBTree/Persistent.hpp"
+#include "BenchCommon.hpp"
+
+using namespace RBTreeTools;
+
+static std::vector<int> RandomKeys(std::size_t n) {
+    std::mt19937 rng(42);
+    std::vector<int> keys(n);
+    for (auto& key : keys) key = static_cast<int>(rng() >> 1);
+    return keys;
+}
+
+static void Run(std::size_t n) {
+    std::vector<int> keys = RandomKeys(n);
+
+    {
+        RBTree<int> tree;
+        double ms = Bench::TimeMs([&] { for (int key : keys) tree.Insert(key); });
+        std::printf("n=%-9zu %-28s %7.1f ns/insert\n", n, "RBTree", ms * 1e6 / n);
+    }
+    {
+        PersistentRBTree<int> tree;
+        double ms = Bench::TimeMs([&] { for (int key : keys) tree.Insert(key); });
+        std::printf("n=%-9zu %-28s %7.1f ns/insert\n", n, "Persistent, no snapshots", ms * 1e6 / n);
+
+        std::vector<PersistentRBTree<int>> snapshots;
+        snapshots.reserve(1000);
+        double snap_ms = Bench::TimeMs([&] { for (int i = 0; i < 1000; ++i) snapshots.push_back(tree.Snapshot()); });
+        std::printf("n=%-9zu %-28s %7.1f ns/snapshot\n", n, "Snapshot()", snap_ms * 1e6 / 1000);
+    }
+    for (std::size_t every : {std::size_t{1000}, std::size_t{10}}) {
+        std::size_t heap_before = Bench::HeapInUse();
+        PersistentRBTree<int> tree;
+        std::vector<PersistentRBTree<int>> snapshots;
+        double ms = Bench::TimeMs([&] {
+            for (std::size_t i = 0; i < keys.size(); ++i) {
+                tree.Insert(keys[i]);
+                if (i % every == 0) snapshots.push_back(tree.Snapshot());
+            }
+        });
+        double mb = (Bench::HeapInUse() - heap_before) / 1048576.0;
+        std::string name = "Persistent, snapshot/" + std::to_string(every);
+        std::printf("n=%-9zu %-28s %7.1f ns/insert  %zu snapshots kept, %.1f MB\n", n, name.c_str(),
+                    ms * 1e6 / n, snapshots.size(), mb);
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1) {
+        Run(std::stoull(argv[1]));
+        return 0;
+    }
+    Run(100'000);
+    Run(1'000'000);
+    return 0;
+}
@@ -0,0 +1,76 @@
+// 全树扫描吞吐: 旧的 std::stack + std::function 遍历 vs 模板 Traversal vs 迭代器
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <stack>
+#include <string>
+#include <vector>
+
+#include "RBTree/RBTree.hpp"
+#include "RBTree/NodePool.hpp"
+#include "BenchCommon.hpp"
+
+using namespace RBTreeTools;
+using Node = RBNode<int>;
+
+// * 改动前 RBTreeTools::Traversal 的实现, 作为基线
+static void StackTraversal(Node* root, std::function<void(Node*)> visit) {
+    std::stack<Node*> stack;
+    Node* current = root;
+    while (current || !stack.empty()) {
+        while (current) {
+            stack.push(current);
+            current = current->left;
+        }
+        current = stack.top();
+        stack.pop();
+        visit(current);
+        current = current->right;
+    }
+}
+
+static void Report(const char* name, std::size_t n, int rounds, double ms) {
+    std::printf("%-22s n=%-9zu %8.2f ns/elem  %8.1f Melem/s\n",
+                name, n, ms * 1e6 / (double(n) * rounds), double(n) * rounds / ms / 1e3);
+}
+
+static void Run(std::size_t n) {
+    RBTree<int, PoolAllocator<Node>> tree;
+    std::mt19937 rng(7);
+    for (std::size_t i = 0; i < n; ++i) {
+        tree.Insert(static_cast<int>(rng()));
+    }
+    int rounds = n >= 1'000'000 ? 5 : 200;
+    std::int64_t sum = 0;
+
+    double stack_ms = Bench::TimeMs([&] {
+        for (int r = 0; r < rounds; ++r)
+            StackTraversal(tree.Root(), [&](Node* node) { sum += node->val; });
+    });
+    double visitor_ms = Bench::TimeMs([&] {
+        for (int r = 0; r < rounds; ++r)
+            Traversal(tree.Root(), [&](Node* node) { sum += node->val; });
+    });
+    double iter_ms = Bench::TimeMs([&] {
+        for (int r = 0; r < rounds; ++r)
+            for (int v : tree) sum += v;
+    });
+    Bench::DoNotOptimize(sum);
+
+    std::size_t size = static_cast<std::size_t>(std::distance(tree.begin(), tree.end()));
+    Report("stack+std::function", size, rounds, stack_ms);
+    Report("Traversal<Visitor>", size, rounds, visitor_ms);
+    Report("iterator range-for", size, rounds, iter_ms);
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1) {
+        Run(std::stoull(argv[1]));
+        return 0;
+    }
+    for (std::size_t n : {10'000u, 1'000'000u}) {
+        Run(n);
+    }
+    return 0;
+}
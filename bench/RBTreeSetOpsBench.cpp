@@ -0,0 +1,66 @@
+// 集合运算: 逐个重新插入 vs 串行 Join/Split vs 并行 Join/Split
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "RBTree/RBTree.hpp"
+#include "RBTree/SetOps.hpp"
+#include "BenchCommon.hpp"
+
+using namespace RBTreeTools;
+using Node = RBNode<int>;
+
+static std::vector<int> SortedKeys(std::size_t n, std::mt19937& rng) {
+    std::vector<int> keys(n);
+    for (auto& key : keys) key = static_cast<int>(rng() >> 1);
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    return keys;
+}
+
+template <typename Op>
+static void RunOp(const char* name, const std::vector<int>& a, const std::vector<int>& b, Op&& op) {
+    std::allocator<Node> alloc;
+    std::size_t threads = std::thread::hardware_concurrency();
+    for (std::size_t parallel_depth : {std::size_t{0}, _detail::DefaultParallelDepth()}) {
+        Node* ta = BuildFromSorted(a.begin(), a.end());
+        Node* tb = BuildFromSorted(b.begin(), b.end());
+        Node* result = nullptr;
+        double ms = Bench::TimeMs([&] { result = op(ta, tb, alloc, parallel_depth); });
+        std::printf("%-12s |a|=%-9zu |b|=%-9zu %-8s %9.1f ms\n", name, a.size(), b.size(),
+                    parallel_depth ? "parallel" : "serial", ms);
+        DestroyRBTree(result);
+        if (threads <= 1) break;
+    }
+}
+
+static void Run(std::size_t n) {
+    std::mt19937 rng(1);
+    std::vector<int> a = SortedKeys(n, rng);
+    std::vector<int> b = SortedKeys(n, rng);
+
+    Node* base = BuildFromSorted(a.begin(), a.end());
+    double loop_ms = Bench::TimeMs([&] {
+        for (int v : b) InsertRBTree(base, v);
+    });
+    std::printf("%-12s |a|=%-9zu |b|=%-9zu %-8s %9.1f ms\n", "reinsert", a.size(), b.size(), "serial", loop_ms);
+    DestroyRBTree(base);
+
+    RunOp("Union", a, b, [](Node* x, Node* y, auto& alloc, std::size_t d) { return Union(x, y, alloc, d); });
+    RunOp("Intersection", a, b, [](Node* x, Node* y, auto& alloc, std::size_t d) { return Intersection(x, y, alloc, d); });
+    RunOp("Difference", a, b, [](Node* x, Node* y, auto& alloc, std::size_t d) { return Difference(x, y, alloc, d); });
+}
+
+int main(int argc, char** argv) {
+    std::printf("hardware threads: %u\n", std::thread::hardware_concurrency());
+    if (argc > 1) {
+        Run(std::stoull(argv[1]));
+        return 0;
+    }
+    Run(1'000'000);
+    Run(10'000'000);
+    return 0;
+}
@@ -0,0 +1,66 @@
+// 小树上的 Find / Traverse: 泛型代码直接调用 BPlusTree (TreeInterface, 可内联) vs 经过 ITree 虚调用 + std::function
+// 树越小, 单次查找本身越便宜, 派发开销占比越高
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "BPlusTree/BPlusTree.hpp"
+#include "BenchCommon.hpp"
+
+template <TreeInterface Tree>
+static std::size_t CountHits(const Tree& tree, const std::vector<int>& probes) {
+    std::size_t hits = 0;
+    for (int probe : probes) {
+        hits += tree.Find(probe) != nullptr;
+    }
+    return hits;
+}
+
+template <TreeInterface Tree>
+static long long Sum(const Tree& tree) {
+    long long sum = 0;
+    tree.Traverse(nullptr, [&](auto* entry) { sum += entry->GetValue(); });
+    return sum;
+}
+
+// * 不内联, 编译器看不到 ITree& 背后的具体类型, 与真实的运行时多态一致
+[[gnu::noinline]] static const ITree<int>& Opaque(const ITree<int>& tree) {
+    return tree;
+}
+
+static void Run(std::size_t n, std::size_t queries) {
+    std::mt19937 rng(21);
+    ErasedTree<BPlusTree<int>> erased;
+    for (std::size_t i = 0; i < n; ++i) erased.Insert(static_cast<int>(rng() % (4 * n)));
+    const BPlusTree<int>& direct = erased.Get();
+    const ITree<int>& virtual_tree = Opaque(erased);
+    std::vector<int> probes(queries);
+    for (auto& probe : probes) probe = static_cast<int>(rng() % (4 * n));
+
+    std::size_t hits = 0;
+    double direct_ms = Bench::TimeMs([&] { hits += CountHits(direct, probes); });
+    double virtual_ms = Bench::TimeMs([&] { hits += CountHits(virtual_tree, probes); });
+    std::size_t rounds = queries / n;
+    long long sum = 0;
+    double direct_scan_ms = Bench::TimeMs([&] { for (std::size_t r = 0; r < rounds; ++r) sum += Sum(direct); });
+    double virtual_scan_ms = Bench::TimeMs([&] { for (std::size_t r = 0; r < rounds; ++r) sum += Sum(virtual_tree); });
+    Bench::DoNotOptimize(hits);
+    Bench::DoNotOptimize(sum);
+    std::size_t visited = rounds * direct.Size();
+    std::printf("n=%-6zu Find: direct %6.2f ns  ITree %6.2f ns (%.2fx)   Traverse: direct %5.2f ns/elem  ITree %5.2f ns/elem (%.2fx)\n",
+                n, direct_ms * 1e6 / queries, virtual_ms * 1e6 / queries, virtual_ms / direct_ms,
+                direct_scan_ms * 1e6 / visited, virtual_scan_ms * 1e6 / visited, virtual_scan_ms / direct_scan_ms);
+}
+
+int main(int argc, char** argv) {
+    std::size_t queries = 4'000'000;
+    if (argc > 1) {
+        Run(std::stoull(argv[1]), queries);
+        return 0;
+    }
+    for (std::size_t n : {std::size_t{8}, std::size_t{64}, std::size_t{512}, std::size_t{4096}}) {
+        Run(n, queries);
+    }
+    return 0;
+}
@@ -0,0 +1,580 @@
+#pragma once
+/*
+ *  缓存友好的 B+ 树, 满足 Interface.hpp 中的 TreeInterface (需要运行时多态时用 ErasedTree<BPlusTree<Ty>>):
+ *  1. 节点中的 key 连续存放, 每个节点的 key 数组占 4 条缓存行 (int 为 64 个),
+ *     一次查找只访问 log_64(n) 个节点, 而不是红黑树的 ~2log2(n) 个
+ *  2. 节点内用 "统计小于 val 的 key 个数" 的方式做无分支的线性查找, int32/int64 走 SSE2/AVX2
+ *  3. 所有值都在叶子中, 叶子之间用双向链表相连, 范围扫描只顺序读叶子
+ *
+ *  接口要求按元素返回句柄, 这里每个叶子槽位 i 对应一个固定的句柄 entries[i] (派生自 ITreeNode),
+ *  句柄始终指向同一叶子的 keys[i]; 句柄不参与查找, 不会污染 key 所在的缓存行
+ *  @note: 与 std::vector 的迭代器一样, 任何 Insert/Remove 之后之前拿到的句柄都可能失效
+ */
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "../RBTree/Interface.hpp"
+
+namespace BPlusTreeTools {
+
+    constexpr std::size_t CacheLine = 64;
+
+    // @function: 统计 keys[0, count) 中小于 val 的个数 (即 lower_bound 的下标)
+    template <typename Ty>
+    inline std::size_t CountLess(const Ty* keys, std::size_t count, const Ty& val) {
+        std::size_t i = 0;
+        std::size_t less = 0;
+    #if defined(__AVX2__)
+        if constexpr (std::is_same_v<Ty, std::int32_t>) {
+            const __m256i needle = _mm256_set1_epi32(val);
+            for (; i + 8 <= count; i += 8) {
+                __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i));
+                __m256i lt = _mm256_cmpgt_epi32(needle, block);
+                less += std::popcount(static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(lt))));
+            }
+        } else if constexpr (std::is_same_v<Ty, std::int64_t>) {
+            const __m256i needle = _mm256_set1_epi64x(val);
+            for (; i + 4 <= count; i += 4) {
+                __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i));
+                __m256i lt = _mm256_cmpgt_epi64(needle, block);
+                less += std::popcount(static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(lt))));
+            }
+        }
+    #elif defined(__SSE2__)
+        if constexpr (std::is_same_v<Ty, std::int32_t>) {
+            // * 没有 -mpopcnt 时 std::popcount 是一次库函数调用, 这里改为按通道累加比较结果 (-1), 最后横向求和
+            const __m128i needle = _mm_set1_epi32(val);
+            __m128i acc = _mm_setzero_si128();
+            for (; i + 4 <= count; i += 4) {
+                __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i));
+                acc = _mm_sub_epi32(acc, _mm_cmpgt_epi32(needle, block));
+            }
+            acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+            acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+            less += static_cast<std::size_t>(_mm_cvtsi128_si32(acc));
+        }
+    #endif
+        for (; i < count; ++i) {
+            less += keys[i] < val;
+        }
+        return less;
+    }
+
+    // @function: 统计 keys[0, count) 中小于等于 val 的个数 (即 upper_bound 的下标)
+    template <typename Ty>
+    inline std::size_t CountLessEqual(const Ty* keys, std::size_t count, const Ty& val) {
+        std::size_t less = CountLess(keys, count, val);
+        return less < count && !(val < keys[less]) ? less + 1 : less;
+    }
+}
+
+template <typename Ty, class Alloc = std::allocator<Ty>>
+class BPlusTree final {
+public:
+    using value_type      = Ty;
+    using allocator_type  = Alloc;
+    using node_type       = ITreeNode<Ty, Alloc>;
+
+    // * 叶子槽位的句柄; 类型为 final, 通过 Entry* 调用 GetValue 不经过虚表
+    struct Entry final : node_type {
+        const Ty* slot {nullptr};
+        const Ty& GetValue() const override {
+            return *slot;
+        }
+    };
+    using pointer         = Entry*;
+    using const_pointer   = const Entry*;
+
+    // * 每个节点的 key 数组占 4 条缓存行
+    static constexpr std::size_t LeafCapacity  = std::max<std::size_t>(4, 4 * BPlusTreeTools::CacheLine / sizeof(Ty));
+    static constexpr std::size_t InnerCapacity = std::max<std::size_t>(4, 4 * BPlusTreeTools::CacheLine / sizeof(Ty));
+
+private:
+    struct NodeBase {
+        std::uint32_t count {0};
+        bool is_leaf;
+        explicit NodeBase(bool leaf) : is_leaf(leaf) {}
+    };
+
+    struct Leaf;
+
+    struct Leaf : NodeBase {
+        Leaf* prev {nullptr};
+        Leaf* next {nullptr};
+        alignas(BPlusTreeTools::CacheLine) Ty keys[LeafCapacity];
+        Entry entries[LeafCapacity];
+
+        Leaf() : NodeBase(true) {
+            for (std::size_t i = 0; i < LeafCapacity; ++i) {
+                entries[i].slot = &keys[i];
+            }
+        }
+        Leaf(const Leaf&) = delete;
+        Leaf& operator=(const Leaf&) = delete;
+    };
+
+    struct Inner : NodeBase {
+        // * keys[i] 是 children[i+1] 中的最小值 (删除后可能小于它), 且大于 children[i] 中所有值
+        alignas(BPlusTreeTools::CacheLine) Ty keys[InnerCapacity];
+        NodeBase* children[InnerCapacity + 1];
+
+        Inner() : NodeBase(false) {}
+    };
+
+    using LeafAlloc  = typename std::allocator_traits<Alloc>::template rebind_alloc<Leaf>;
+    using InnerAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<Inner>;
+
+    struct SplitInfo {
+        NodeBase* right {nullptr};
+        Ty separator {};
+    };
+
+    static constexpr std::size_t LeafMin  = LeafCapacity / 2;
+    static constexpr std::size_t InnerMin = InnerCapacity / 2;
+
+public:
+    BPlusTree() = default;
+    explicit BPlusTree(const Alloc& alloc) : _m_alloc(alloc) {}
+    BPlusTree(const BPlusTree&) = delete;
+    BPlusTree& operator=(const BPlusTree&) = delete;
+    ~BPlusTree() {
+        Clear();
+    }
+
+    // @return: 新插入元素的句柄; 已存在时返回已有元素的句柄
+    pointer Insert(value_type&& value) {
+        return InsertImpl(std::move(value));
+    }
+    pointer Insert(const value_type& value) {
+        return InsertImpl(value);
+    }
+
+    /*
+    * @return: 删除成功时返回原位置上的元素 (即被删元素的后继) 的句柄, 被删的是最大元素时返回 nullptr;
+    * @return: 未找到时也返回 nullptr, 需要区分时请用 Erase
+    */
+    pointer Remove(const value_type& value) {
+        Leaf* leaf = nullptr;
+        std::size_t pos = 0;
+        if (!EraseImpl(value, leaf, pos)) {
+            return nullptr;
+        }
+        return HandleAt(leaf, pos);
+    }
+
+    pointer Find(const value_type& value) const {
+        auto [leaf, pos] = LowerBoundSlot(value);
+        if (!leaf || pos == leaf->count || value < leaf->keys[pos]) {
+            return nullptr;
+        }
+        return const_cast<Entry*>(&leaf->entries[pos]);
+    }
+
+    /// 按序遍历; root 为 nullptr 时从最小元素开始, 否则从 root 所指的元素开始, visit(pointer)
+    template <typename Visitor>
+    void Traverse(const_pointer root, Visitor&& visit) const {
+        const Leaf* leaf = _m_head;
+        std::size_t pos = 0;
+        if (root) {
+            auto [from_leaf, from_pos] = LowerBoundSlot(root->GetValue());
+            leaf = from_leaf;
+            pos = from_pos;
+        }
+        for (; leaf; leaf = leaf->next, pos = 0) {
+            for (; pos < leaf->count; ++pos) {
+                visit(const_cast<Entry*>(&leaf->entries[pos]));
+            }
+        }
+    }
+
+    allocator_type GetAllocator() const {
+        return _m_alloc;
+    }
+
+public:
+    // * 以下为 TreeInterface 之外的接口
+
+    bool Contains(const value_type& value) const {
+        auto [leaf, pos] = LowerBoundSlot(value);
+        return leaf && pos < leaf->count && !(value < leaf->keys[pos]);
+    }
+
+    // @return: 是否删除成功
+    bool Erase(const value_type& value) {
+        Leaf* leaf = nullptr;
+        std::size_t pos = 0;
+        return EraseImpl(value, leaf, pos);
+    }
+
+    // @function: 按序访问所有元素, fn(const Ty&)
+    template <typename Fn>
+    void ForEach(Fn&& fn) const {
+        for (const Leaf* leaf = _m_head; leaf; leaf = leaf->next) {
+            for (std::size_t i = 0; i < leaf->count; ++i) {
+                fn(leaf->keys[i]);
+            }
+        }
+    }
+
+    // @function: 按序访问 [lo, hi] 内的元素
+    template <typename Fn>
+    void Scan(const value_type& lo, const value_type& hi, Fn&& fn) const {
+        auto [leaf, pos] = LowerBoundSlot(lo);
+        for (const Leaf* cur = leaf; cur; cur = cur->next, pos = 0) {
+            for (; pos < cur->count; ++pos) {
+                if (hi < cur->keys[pos]) {
+                    return;
+                }
+                fn(cur->keys[pos]);
+            }
+        }
+    }
+
+    std::size_t Size() const noexcept {
+        return _m_size;
+    }
+    bool Empty() const noexcept {
+        return _m_size == 0;
+    }
+
+    void Clear() {
+        if (_m_root) {
+            DestroySubtree(_m_root);
+        }
+        _m_root = nullptr;
+        _m_head = nullptr;
+        _m_size = 0;
+    }
+
+private:
+    NodeBase* _m_root {nullptr};
+    Leaf* _m_head {nullptr};      // * 最左叶子, 顺序扫描的起点
+    std::size_t _m_size {0};
+    [[no_unique_address]] Alloc _m_alloc {};
+
+private:
+    // @function: 删除 value, 并通过 out_leaf/out_pos 写回删除后原位置上的元素
+    bool EraseImpl(const value_type& value, Leaf*& out_leaf, std::size_t& out_pos) {
+        if (!_m_root) {
+            return false;
+        }
+        Leaf* leaf = nullptr;
+        std::size_t pos = 0;
+        if (!EraseFrom(_m_root, value, leaf, pos)) {
+            return false;
+        }
+        --_m_size;
+        if (!_m_root->is_leaf && _m_root->count == 0) {
+            Inner* old = static_cast<Inner*>(_m_root);
+            _m_root = old->children[0];
+            DestroyInner(old);
+        } else if (_m_root->is_leaf && _m_root->count == 0) {
+            DestroyLeaf(static_cast<Leaf*>(_m_root));
+            _m_root = nullptr;
+            _m_head = nullptr;
+            leaf = nullptr;
+        }
+        // 删除位置在叶尾时, 后继在下一个叶子的开头
+        if (leaf && pos == leaf->count) {
+            leaf = leaf->next;
+            pos = 0;
+        }
+        out_leaf = leaf;
+        out_pos = pos;
+        return true;
+    }
+
+    static pointer HandleAt(Leaf* leaf, std::size_t pos) {
+        if (!leaf || pos >= leaf->count) {
+            return nullptr;
+        }
+        return &leaf->entries[pos];
+    }
+
+    // @return: 第一个不小于 value 的槽位; 全部小于 value 时 pos == leaf->count
+    std::pair<const Leaf*, std::size_t> LowerBoundSlot(const value_type& value) const {
+        const NodeBase* node = _m_root;
+        if (!node) {
+            return {nullptr, 0};
+        }
+        while (!node->is_leaf) {
+            const Inner* inner = static_cast<const Inner*>(node);
+            std::size_t idx = BPlusTreeTools::CountLessEqual(inner->keys, inner->count, value);
+            node = inner->children[idx];
+        }
+        const Leaf* leaf = static_cast<const Leaf*>(node);
+        std::size_t pos = BPlusTreeTools::CountLess(leaf->keys, leaf->count, value);
+        if (pos == leaf->count && leaf->next) {
+            return {leaf->next, 0};
+        }
+        return {leaf, pos};
+    }
+
+    template <typename Val>
+    pointer InsertImpl(Val&& value) {
+        if (!_m_root) {
+            Leaf* leaf = CreateLeaf();
+            _m_root = leaf;
+            _m_head = leaf;
+        }
+        Entry* entry = nullptr;
+        SplitInfo split = InsertInto(_m_root, std::forward<Val>(value), entry);
+        if (split.right) {
+            Inner* root = CreateInner();
+            root->count = 1;
+            root->keys[0] = std::move(split.separator);
+            root->children[0] = _m_root;
+            root->children[1] = split.right;
+            _m_root = root;
+        }
+        return entry;
+    }
+
+    template <typename Val>
+    SplitInfo InsertInto(NodeBase* node, Val&& value, Entry*& entry) {
+        if (node->is_leaf) {
+            return InsertIntoLeaf(static_cast<Leaf*>(node), std::forward<Val>(value), entry);
+        }
+        Inner* inner = static_cast<Inner*>(node);
+        std::size_t idx = BPlusTreeTools::CountLessEqual(inner->keys, inner->count, value);
+        SplitInfo child_split = InsertInto(inner->children[idx], std::forward<Val>(value), entry);
+        if (!child_split.right) {
+            return {};
+        }
+        if (inner->count < InnerCapacity) {
+            InsertIntoInner(inner, idx, std::move(child_split.separator), child_split.right);
+            return {};
+        }
+        // 满了: 先对半拆开, 中间的 key 上提, 再把新的分隔值放进对应的一半
+        Inner* right = CreateInner();
+        std::size_t mid = InnerCapacity / 2;
+        Ty up = std::move(inner->keys[mid]);
+        right->count = static_cast<std::uint32_t>(InnerCapacity - mid - 1);
+        std::move(inner->keys + mid + 1, inner->keys + InnerCapacity, right->keys);
+        std::copy(inner->children + mid + 1, inner->children + InnerCapacity + 1, right->children);
+        inner->count = static_cast<std::uint32_t>(mid);
+        if (idx <= mid) {
+            InsertIntoInner(inner, idx, std::move(child_split.separator), child_split.right);
+        } else {
+            InsertIntoInner(right, idx - mid - 1, std::move(child_split.separator), child_split.right);
+        }
+        return {right, std::move(up)};
+    }
+
+    static void InsertIntoInner(Inner* inner, std::size_t idx, Ty&& separator, NodeBase* right) {
+        std::move_backward(inner->keys + idx, inner->keys + inner->count, inner->keys + inner->count + 1);
+        std::copy_backward(inner->children + idx + 1, inner->children + inner->count + 1,
+                           inner->children + inner->count + 2);
+        inner->keys[idx] = std::move(separator);
+        inner->children[idx + 1] = right;
+        ++inner->count;
+    }
+
+    template <typename Val>
+    SplitInfo InsertIntoLeaf(Leaf* leaf, Val&& value, Entry*& entry) {
+        std::size_t pos = BPlusTreeTools::CountLess(leaf->keys, leaf->count, value);
+        if (pos < leaf->count && !(value < leaf->keys[pos])) {
+            entry = &leaf->entries[pos];
+            return {};
+        }
+        ++_m_size;
+        if (leaf->count < LeafCapacity) {
+            entry = PlaceInLeaf(leaf, pos, std::forward<Val>(value));
+            return {};
+        }
+        Leaf* right = CreateLeaf();
+        std::size_t mid = LeafCapacity / 2;
+        std::move(leaf->keys + mid, leaf->keys + LeafCapacity, right->keys);
+        right->count = static_cast<std::uint32_t>(LeafCapacity - mid);
+        leaf->count = static_cast<std::uint32_t>(mid);
+        right->next = leaf->next;
+        right->prev = leaf;
+        if (leaf->next) leaf->next->prev = right;
+        leaf->next = right;
+        if (pos <= mid) {
+            entry = PlaceInLeaf(leaf, pos, std::forward<Val>(value));
+        } else {
+            entry = PlaceInLeaf(right, pos - mid, std::forward<Val>(value));
+        }
+        return {right, right->keys[0]};
+    }
+
+    template <typename Val>
+    static Entry* PlaceInLeaf(Leaf* leaf, std::size_t pos, Val&& value) {
+        std::move_backward(leaf->keys + pos, leaf->keys + leaf->count, leaf->keys + leaf->count + 1);
+        leaf->keys[pos] = std::forward<Val>(value);
+        ++leaf->count;
+        return &leaf->entries[pos];
+    }
+
+    // @return: 是否删除; 删除后 node 可能少于下限, 由父节点负责借位或合并
+    bool EraseFrom(NodeBase* node, const value_type& value, Leaf*& leaf_out, std::size_t& pos_out) {
+        if (node->is_leaf) {
+            Leaf* leaf = static_cast<Leaf*>(node);
+            std::size_t pos = BPlusTreeTools::CountLess(leaf->keys, leaf->count, value);
+            if (pos == leaf->count || value < leaf->keys[pos]) {
+                return false;
+            }
+            std::move(leaf->keys + pos + 1, leaf->keys + leaf->count, leaf->keys + pos);
+            --leaf->count;
+            leaf_out = leaf;
+            pos_out = pos;
+            return true;
+        }
+        Inner* inner = static_cast<Inner*>(node);
+        std::size_t idx = BPlusTreeTools::CountLessEqual(inner->keys, inner->count, value);
+        if (!EraseFrom(inner->children[idx], value, leaf_out, pos_out)) {
+            return false;
+        }
+        Rebalance(inner, idx, leaf_out, pos_out);
+        return true;
+    }
+
+    /*
+    * @function: children[idx] 少于下限时, 先向兄弟借一个, 借不到就与兄弟合并
+    * @note: 合并/借位会移动元素, 因此同步修正 leaf_out/pos_out 指向的位置
+    */
+    void Rebalance(Inner* parent, std::size_t idx, Leaf*& leaf_out, std::size_t& pos_out) {
+        NodeBase* child = parent->children[idx];
+        if (child->is_leaf) {
+            Leaf* leaf = static_cast<Leaf*>(child);
+            if (leaf->count >= LeafMin) {
+                return;
+            }
+            Leaf* left = idx > 0 ? static_cast<Leaf*>(parent->children[idx - 1]) : nullptr;
+            Leaf* right = idx < parent->count ? static_cast<Leaf*>(parent->children[idx + 1]) : nullptr;
+            if (left && left->count > LeafMin) {
+                std::move_backward(leaf->keys, leaf->keys + leaf->count, leaf->keys + leaf->count + 1);
+                leaf->keys[0] = std::move(left->keys[left->count - 1]);
+                --left->count;
+                ++leaf->count;
+                parent->keys[idx - 1] = leaf->keys[0];
+                if (leaf_out == leaf) ++pos_out;
+            } else if (right && right->count > LeafMin) {
+                leaf->keys[leaf->count] = std::move(right->keys[0]);
+                std::move(right->keys + 1, right->keys + right->count, right->keys);
+                --right->count;
+                ++leaf->count;
+                parent->keys[idx] = right->keys[0];
+                if (leaf_out == right) {
+                    if (pos_out == 0) { leaf_out = leaf; pos_out = leaf->count - 1; }
+                    else --pos_out;
+                }
+            } else if (left) {
+                MergeLeaves(parent, idx - 1, leaf_out, pos_out);
+            } else if (right) {
+                MergeLeaves(parent, idx, leaf_out, pos_out);
+            }
+            return;
+        }
+
+        Inner* inner = static_cast<Inner*>(child);
+        if (inner->count >= InnerMin) {
+            return;
+        }
+        Inner* left = idx > 0 ? static_cast<Inner*>(parent->children[idx - 1]) : nullptr;
+        Inner* right = idx < parent->count ? static_cast<Inner*>(parent->children[idx + 1]) : nullptr;
+        if (left && left->count > InnerMin) {
+            std::move_backward(inner->keys, inner->keys + inner->count, inner->keys + inner->count + 1);
+            std::copy_backward(inner->children, inner->children + inner->count + 1,
+                               inner->children + inner->count + 2);
+            inner->keys[0] = std::move(parent->keys[idx - 1]);
+            inner->children[0] = left->children[left->count];
+            parent->keys[idx - 1] = std::move(left->keys[left->count - 1]);
+            --left->count;
+            ++inner->count;
+        } else if (right && right->count > InnerMin) {
+            inner->keys[inner->count] = std::move(parent->keys[idx]);
+            inner->children[inner->count + 1] = right->children[0];
+            ++inner->count;
+            parent->keys[idx] = std::move(right->keys[0]);
+            std::move(right->keys + 1, right->keys + right->count, right->keys);
+            std::copy(right->children + 1, right->children + right->count + 1, right->children);
+            --right->count;
+        } else if (left) {
+            MergeInners(parent, idx - 1);
+        } else if (right) {
+            MergeInners(parent, idx);
+        }
+    }
+
+    // @function: 把 children[idx+1] 并入 children[idx] 并删掉分隔值 keys[idx]
+    void MergeLeaves(Inner* parent, std::size_t idx, Leaf*& leaf_out, std::size_t& pos_out) {
+        Leaf* left = static_cast<Leaf*>(parent->children[idx]);
+        Leaf* right = static_cast<Leaf*>(parent->children[idx + 1]);
+        if (leaf_out == right) {
+            leaf_out = left;
+            pos_out += left->count;
+        }
+        std::move(right->keys, right->keys + right->count, left->keys + left->count);
+        left->count += right->count;
+        left->next = right->next;
+        if (right->next) right->next->prev = left;
+        RemoveFromInner(parent, idx);
+        DestroyLeaf(right);
+    }
+
+    void MergeInners(Inner* parent, std::size_t idx) {
+        Inner* left = static_cast<Inner*>(parent->children[idx]);
+        Inner* right = static_cast<Inner*>(parent->children[idx + 1]);
+        left->keys[left->count] = std::move(parent->keys[idx]);
+        std::move(right->keys, right->keys + right->count, left->keys + left->count + 1);
+        std::copy(right->children, right->children + right->count + 1, left->children + left->count + 1);
+        left->count += right->count + 1;
+        RemoveFromInner(parent, idx);
+        right->count = 0;
+        DestroyInner(right);
+    }
+
+    // @function: 删除分隔值 keys[idx] 与其右侧孩子 children[idx+1]
+    static void RemoveFromInner(Inner* parent, std::size_t idx) {
+        std::move(parent->keys + idx + 1, parent->keys + parent->count, parent->keys + idx);
+        std::copy(parent->children + idx + 2, parent->children + parent->count + 1, parent->children + idx + 1);
+        --parent->count;
+    }
+
+    Leaf* CreateLeaf() {
+        LeafAlloc alloc(_m_alloc);
+        Leaf* leaf = std::allocator_traits<LeafAlloc>::allocate(alloc, 1);
+        std::construct_at(leaf);
+        return leaf;
+    }
+    Inner* CreateInner() {
+        InnerAlloc alloc(_m_alloc);
+        Inner* inner = std::allocator_traits<InnerAlloc>::allocate(alloc, 1);
+        std::construct_at(inner);
+        return inner;
+    }
+    void DestroyLeaf(Leaf* leaf) {
+        LeafAlloc alloc(_m_alloc);
+        std::destroy_at(leaf);
+        std::allocator_traits<LeafAlloc>::deallocate(alloc, leaf, 1);
+    }
+    void DestroyInner(Inner* inner) {
+        InnerAlloc alloc(_m_alloc);
+        std::destroy_at(inner);
+        std::allocator_traits<InnerAlloc>::deallocate(alloc, inner, 1);
+    }
+    void DestroySubtree(NodeBase* node) {
+        if (node->is_leaf) {
+            DestroyLeaf(static_cast<Leaf*>(node));
+            return;
+        }
+        Inner* inner = static_cast<Inner*>(node);
+        for (std::size_t i = 0; i <= inner->count; ++i) {
+            DestroySubtree(inner->children[i]);
+        }
+        DestroyInner(inner);
+    }
+};
@@ -0,0 +1,254 @@
+#pragma once
+/*
+ *  方向优化 BFS (Beamer, Asanović, Patterson 2012), 在 GraphInstance::List() 的 CSR 上运行
+ *
+ *  自顶向下: 扫描当前层 frontier 中每个顶点的邻居, 用 CAS 抢占未访问的邻居
+ *            frontier 是稀疏队列, 代价 ~ frontier 的度数之和 m_f
+ *  自底向上: 扫描每个未访问的顶点, 只要找到一个在 frontier 中的邻居就停下
+ *            frontier 是位图, 每个顶点只由一个线程处理, 不需要原子操作
+ *
+ *        m_f > m_u / alpha                     (m_u: 未访问顶点的度数之和)
+ *   top-down ─────────────────────▶ bottom-up
+ *            ◀─────────────────────
+ *        n_f < n / beta 且 frontier 在缩小
+ *
+ *  图是无向图, 一个顶点的入边就是 Neighbors(v), 自底向上不需要转置图
+ */
+
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "GraphManager.hpp"
+#include "Parallel.hpp"
+
+namespace Moonlight::Graph {
+
+struct BFSOptions {
+    // * 最多使用的线程数, 0 表示 hardware_concurrency
+    unsigned threads = 0;
+    // * 切换阈值, 取论文中的默认值; alpha 越大越早切到自底向上, 取 0 即为纯自顶向下
+    double alpha = 15.0;
+    double beta = 18.0;
+};
+
+struct BFSResult {
+    // * distance[v] 为 source 到 v 的边数, parent[source] == source, 未到达为 Unreached
+    std::vector<uint64_t> distance;
+    std::vector<uint64_t> parent;
+    uint64_t top_down_steps = 0;
+    uint64_t bottom_up_steps = 0;
+
+    bool Reached(const uint64_t v) const noexcept {
+        return v < parent.size() && parent[v] != Unreached;
+    }
+};
+
+// * visit(vertex, parent, depth) 返回 false 时提前结束, 也可以不返回值
+template <typename Visitor>
+concept BFSVisitor = std::invocable<Visitor&, uint64_t, uint64_t, uint64_t>;
+
+namespace _detail {
+
+    template <typename Visitor>
+    class BFSState {
+    public:
+        BFSState(const uint64_t n, Visitor& visit) : _m_visit(visit), _m_words((n + 63) / 64) {
+            result.distance.assign(n, Unreached);
+            result.parent.assign(n, Unreached);
+        }
+
+        // @function: 记录 v 在第 depth 层被 parent 发现, 并调用 visitor
+        void Discover(const uint64_t v, const uint64_t parent, const uint64_t depth) {
+            result.distance[v] = depth;
+            if constexpr (std::is_same_v<std::invoke_result_t<Visitor&, uint64_t, uint64_t, uint64_t>, void>) {
+                _m_visit(v, parent, depth);
+            } else {
+                if (!_m_visit(v, parent, depth)) {
+                    stop.store(true, std::memory_order_relaxed);
+                }
+            }
+        }
+        bool Stopped() const noexcept {
+            return stop.load(std::memory_order_relaxed);
+        }
+        // @function: 用 CAS 抢占 v, 只有一个线程能成功
+        bool Claim(const uint64_t v, const uint64_t parent, const bool concurrent) {
+            uint64_t& slot = result.parent[v];
+            if (!concurrent) {
+                if (slot != Unreached) return false;
+                slot = parent;
+                return true;
+            }
+            std::atomic_ref<uint64_t> ref(slot);
+            uint64_t expected = Unreached;
+            return ref.load(std::memory_order_relaxed) == Unreached &&
+                   ref.compare_exchange_strong(expected, parent, std::memory_order_relaxed);
+        }
+        std::vector<uint64_t> EmptyBitmap() const {
+            return std::vector<uint64_t>(_m_words, 0);
+        }
+        std::size_t Words() const noexcept {
+            return _m_words;
+        }
+
+    public:
+        BFSResult result;
+        std::atomic<bool> stop{false};
+
+    private:
+        Visitor& _m_visit;
+        std::size_t _m_words;
+    };
+
+    // * 一层扩展的结果: 新 frontier 的顶点数与度数之和
+    struct StepCount {
+        uint64_t vertices = 0;
+        uint64_t degrees = 0;
+    };
+
+    template <typename List, typename Visitor>
+    StepCount TopDownStep(const List& graph, BFSState<Visitor>& state, std::vector<uint64_t>& frontier,
+                          const uint64_t depth, const unsigned threads) {
+        const unsigned workers = WorkerCount(frontier.size(), 1024, threads);
+        const bool concurrent = workers > 1;
+        std::vector<std::vector<uint64_t>> next(workers);
+        std::vector<uint64_t> degrees(workers, 0);
+        ParallelFor(frontier.size(), workers, [&](std::size_t begin, std::size_t end, unsigned w) {
+            for (std::size_t i = begin; i < end && !state.Stopped(); ++i) {
+                uint64_t u = frontier[i];
+                for (uint64_t v : graph.Neighbors(u)) {
+                    if (state.Claim(v, u, concurrent)) {
+                        next[w].push_back(v);
+                        degrees[w] += graph.Degree(v);
+                        state.Discover(v, u, depth + 1);
+                    }
+                }
+            }
+        });
+        StepCount count;
+        frontier.clear();
+        for (unsigned w = 0; w < workers; ++w) {
+            frontier.insert(frontier.end(), next[w].begin(), next[w].end());
+            count.degrees += degrees[w];
+        }
+        count.vertices = frontier.size();
+        return count;
+    }
+
+    // @note: 按 64 个顶点一组划分, 每个线程只写自己的位图字和父节点, 不需要原子操作
+    template <typename List, typename Visitor>
+    StepCount BottomUpStep(const List& graph, BFSState<Visitor>& state, const std::vector<uint64_t>& front,
+                           std::vector<uint64_t>& next, const uint64_t depth, const unsigned threads) {
+        const uint64_t n = graph.VertexCount();
+        const unsigned workers = WorkerCount(state.Words(), 256, threads);
+        std::vector<StepCount> counts(workers);
+        ParallelFor(state.Words(), workers, [&](std::size_t begin, std::size_t end, unsigned w) {
+            for (std::size_t word = begin; word < end && !state.Stopped(); ++word) {
+                uint64_t bits = 0;
+                const uint64_t last = std::min<uint64_t>(n, (word + 1) * 64);
+                for (uint64_t v = word * 64; v < last; ++v) {
+                    if (state.result.parent[v] != Unreached) continue;
+                    for (uint64_t u : graph.Neighbors(v)) {
+                        if (front[u >> 6] >> (u & 63) & 1) {
+                            state.result.parent[v] = u;
+                            bits |= uint64_t{1} << (v & 63);
+                            ++counts[w].vertices;
+                            counts[w].degrees += graph.Degree(v);
+                            state.Discover(v, u, depth + 1);
+                            break;
+                        }
+                    }
+                }
+                next[word] = bits;
+            }
+        });
+        StepCount count;
+        for (const auto& c : counts) {
+            count.vertices += c.vertices;
+            count.degrees += c.degrees;
+        }
+        return count;
+    }
+}
+
+/*
+ * @function: 从 source 出发的方向优化 BFS
+ * @param: visit(vertex, parent, depth) 在每个顶点被发现时调用一次 (包括 source 本身, 此时 parent == source);
+ *         返回 false 后各线程尽快停止扩展, 已发现的顶点仍然记录在结果中
+ * @note: 多线程时 visit 会被多个线程同时调用, 必须是线程安全的
+ * @note: 同一层内谁成为父节点取决于线程调度, distance 总是确定的
+ */
+template <typename VerTy, typename Weight, BFSVisitor Visitor>
+inline BFSResult BFS(const AdjacencyList<VerTy, Weight>& graph, const uint64_t source, Visitor&& visit,
+                     const BFSOptions& options = {}) {
+    const uint64_t n = graph.VertexCount();
+    _detail::BFSState<std::remove_reference_t<Visitor>> state(n, visit);
+    if (source >= n) {
+        return std::move(state.result);
+    }
+    state.result.parent[source] = source;
+    state.Discover(source, source, 0);
+
+    std::vector<uint64_t> frontier {source};
+    std::vector<uint64_t> front_bits, next_bits;
+    bool bottom_up = false;
+    _detail::StepCount current {1, graph.Degree(source)};
+    uint64_t previous_vertices = 0;
+    uint64_t unexplored = graph.ArcCount() - current.degrees;
+
+    for (uint64_t depth = 0; current.vertices > 0 && !state.Stopped(); ++depth) {
+        if (!bottom_up && static_cast<double>(current.degrees) > static_cast<double>(unexplored) / options.alpha) {
+            // 队列 -> 位图
+            front_bits = state.EmptyBitmap();
+            next_bits = state.EmptyBitmap();
+            for (uint64_t v : frontier) front_bits[v >> 6] |= uint64_t{1} << (v & 63);
+            bottom_up = true;
+        } else if (bottom_up && static_cast<double>(current.vertices) < static_cast<double>(n) / options.beta &&
+                   current.vertices < previous_vertices) {
+            // 位图 -> 队列
+            frontier.clear();
+            for (std::size_t word = 0; word < front_bits.size(); ++word) {
+                for (uint64_t bits = front_bits[word]; bits; bits &= bits - 1) {
+                    frontier.push_back(word * 64 + std::countr_zero(bits));
+                }
+            }
+            bottom_up = false;
+        }
+        previous_vertices = current.vertices;
+        if (bottom_up) {
+            current = _detail::BottomUpStep(graph, state, front_bits, next_bits, depth, options.threads);
+            std::swap(front_bits, next_bits);
+            ++state.result.bottom_up_steps;
+        } else {
+            current = _detail::TopDownStep(graph, state, frontier, depth, options.threads);
+            ++state.result.top_down_steps;
+        }
+        unexplored -= current.degrees;
+    }
+    return std::move(state.result);
+}
+
+template <typename VerTy, typename Weight>
+inline BFSResult BFS(const AdjacencyList<VerTy, Weight>& graph, const uint64_t source, const BFSOptions& options = {}) {
+    return BFS(graph, source, [](uint64_t, uint64_t, uint64_t) {}, options);
+}
+
+// * GraphInstance (包括 GraphManager 中取得的图) 上直接运行, 第一次调用时构造 CSR
+template <typename VerTy, typename WeightType, BFSVisitor Visitor>
+inline BFSResult BFS(const GraphInstance<VerTy, WeightType>& graph, const uint64_t source, Visitor&& visit,
+                     const BFSOptions& options = {}) {
+    return BFS(graph.List(), source, std::forward<Visitor>(visit), options);
+}
+
+template <typename VerTy, typename WeightType>
+inline BFSResult BFS(const GraphInstance<VerTy, WeightType>& graph, const uint64_t source, const BFSOptions& options = {}) {
+    return BFS(graph.List(), source, options);
+}
+
+}
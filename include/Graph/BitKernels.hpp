@@ -0,0 +1,69 @@
+#pragma once
+// 位集合上的 AND + popcount 内核, AdjacencyMatrix 的公共邻居 / 三角形 / Jaccard 都归结到这里
+// 与 BPlusTree 一样按编译选项选择实现: 定义了 __AVX2__ (-mavx2 或 -DMOONLIGHT_AVX2=ON) 时用 AVX2, 否则用标量
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace Moonlight::Graph::_detail {
+
+// * 位图每行补齐到的字数, 一行正好是若干个 256 位向量
+inline constexpr std::size_t SimdWords = 4;
+
+// @return: popcount(a[i] & b[i]) 之和, i ∈ [0, words)
+inline uint64_t AndPopcountScalar(const uint64_t* a, const uint64_t* b, const std::size_t words) noexcept {
+    uint64_t count = 0;
+#if defined(__POPCNT__)
+    for (std::size_t i = 0; i < words; ++i) {
+        count += static_cast<uint64_t>(std::popcount(a[i] & b[i]));
+    }
+#else
+    // * 没有 -mpopcnt 时 std::popcount 是一次库函数调用, 改用 SWAR: 逐级把相邻的位段相加, 编译器可以向量化
+    for (std::size_t i = 0; i < words; ++i) {
+        uint64_t x = a[i] & b[i];
+        x = x - ((x >> 1) & 0x5555555555555555ULL);
+        x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+        x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+        count += (x * 0x0101010101010101ULL) >> 56;
+    }
+#endif
+    return count;
+}
+
+#if defined(__AVX2__)
+/*
+ * @function: 查表法 popcount (Muła): 每个字节拆成高低两个 4 位, 用 vpshufb 查 16 项的表,
+ *            再用 vpsadbw 把 32 个字节的计数横向加到 4 个 64 位通道
+ * @note: a, b 必须 32 字节对齐, words 必须是 SimdWords 的倍数
+ */
+inline uint64_t AndPopcountAVX2(const uint64_t* a, const uint64_t* b, const std::size_t words) noexcept {
+    const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                           0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_mask = _mm256_set1_epi8(0x0f);
+    __m256i total = _mm256_setzero_si256();
+    for (std::size_t i = 0; i < words; i += SimdWords) {
+        __m256i bits = _mm256_and_si256(_mm256_load_si256(reinterpret_cast<const __m256i*>(a + i)),
+                                        _mm256_load_si256(reinterpret_cast<const __m256i*>(b + i)));
+        __m256i low = _mm256_shuffle_epi8(table, _mm256_and_si256(bits, low_mask));
+        __m256i high = _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(bits, 4), low_mask));
+        total = _mm256_add_epi64(total, _mm256_sad_epu8(_mm256_add_epi8(low, high), _mm256_setzero_si256()));
+    }
+    __m128i sum = _mm_add_epi64(_mm256_castsi256_si128(total), _mm256_extracti128_si256(total, 1));
+    return static_cast<uint64_t>(_mm_cvtsi128_si64(sum)) + static_cast<uint64_t>(_mm_extract_epi64(sum, 1));
+}
+#endif
+
+// @function: 按编译选项选择的 AND + popcount, 约束同 AndPopcountAVX2
+inline uint64_t AndPopcount(const uint64_t* a, const uint64_t* b, const std::size_t words) noexcept {
+#if defined(__AVX2__)
+    return AndPopcountAVX2(a, b, words);
+#else
+    return AndPopcountScalar(a, b, words);
+#endif
+}
+
+}
@@ -0,0 +1,191 @@
+#pragma once
+/*
+ *  文本边表的并行加载: 每行 "from to [weight]", 空白 / 制表符 / 逗号分隔
+ *  以 '#' 或 '%' 开头的行与空行跳过 (SNAP / Matrix Market 的注释), 第三列之后的列忽略, 没有权重时取 WeightType(1)
+ *
+ *  文件整体 mmap, 按轮处理, 每轮 threads 个块, 块的边界挪到下一个换行符之后:
+ *
+ *    |<------------- 第 k 轮 ------------->|
+ *    | 块 0 \n | 块 1    \n | 块 2   \n |     各线程把自己的块解析到自己的边缓冲 (跨轮复用, 不再分配)
+ *                                        ↓
+ *                 按块的顺序批量 AddEdges  ->  已读完的页 madvise(MADV_DONTNEED) 释放
+ *
+ *  同一条边出现多次时与逐行 AddEdge 一样保留第一次的权重
+ */
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#include "GraphManager.hpp"
+#include "MappedFile.hpp"
+#include "Parallel.hpp"
+
+namespace Moonlight::Graph {
+
+struct EdgeListOptions {
+    // * 最多使用的线程数, 0 表示 hardware_concurrency
+    unsigned threads = 0;
+    // * 每个线程每轮解析的字节数, 决定边缓冲的大小
+    std::size_t chunk_bytes = std::size_t{16} << 20;
+};
+
+struct EdgeListStats {
+    uint64_t bytes = 0;
+    uint64_t lines = 0;
+    // * 解析出的边数 (含重复), 以及其中新加入图中的边数
+    uint64_t edges = 0;
+    uint64_t inserted = 0;
+    // * 无法解析的行数, 这些行被跳过
+    uint64_t malformed = 0;
+    double parse_ms = 0;
+    double insert_ms = 0;
+    unsigned threads = 0;
+
+    // @return: 解析阶段每个线程的吞吐量 (MB/s)
+    double ParseMBPerSecondPerCore() const noexcept {
+        return parse_ms > 0 ? static_cast<double>(bytes) / 1e6 / (parse_ms / 1e3) / threads : 0.0;
+    }
+};
+
+namespace _detail {
+
+    inline bool IsFieldSeparator(const char c) noexcept {
+        return c == ' ' || c == '\t' || c == ',' || c == '\r';
+    }
+
+    template <typename Weight>
+    struct EdgeChunk {
+        std::vector<Edge<Weight>> edges;
+        uint64_t lines = 0;
+        uint64_t malformed = 0;
+    };
+
+    // @return: 从 p 开始的下一行的行首, 没有换行符时为 end
+    inline const char* NextLine(const char* p, const char* end) noexcept {
+        const void* eol = p < end ? std::memchr(p, '\n', static_cast<std::size_t>(end - p)) : nullptr;
+        return eol ? static_cast<const char*>(eol) + 1 : end;
+    }
+
+    // @function: 解析 [begin, end) 中的完整行, 追加到 chunk; 数字用 from_chars 原地解析, 不分配内存
+    template <typename Weight>
+    void ParseEdgeChunk(const char* begin, const char* end, EdgeChunk<Weight>& chunk) {
+        const char* p = begin;
+        while (p < end) {
+            const char* next = NextLine(p, end);
+            const char* eol = next[-1] == '\n' ? next - 1 : next;
+            ++chunk.lines;
+            while (p < eol && IsFieldSeparator(*p)) ++p;
+            if (p == eol || *p == '#' || *p == '%') {
+                p = next;
+                continue;
+            }
+            uint64_t ids[2];
+            Weight weight = Weight(1);
+            bool ok = true;
+            for (int i = 0; i < 2 && ok; ++i) {
+                auto [ptr, ec] = std::from_chars(p, eol, ids[i]);
+                ok = ec == std::errc{} && (ptr == eol || IsFieldSeparator(*ptr));
+                p = ptr;
+                while (p < eol && IsFieldSeparator(*p)) ++p;
+            }
+            if (ok && p < eol) {
+                auto [ptr, ec] = std::from_chars(p, eol, weight);
+                ok = ec == std::errc{} && (ptr == eol || IsFieldSeparator(*ptr));
+            }
+            if (ok) {
+                chunk.edges.emplace_back(ids[0], ids[1], weight);
+            } else {
+                ++chunk.malformed;
+            }
+            p = next;
+        }
+    }
+}
+
+/*
+ * @function: 把文本边表 path 加载进 graph (通常是 GraphManager::GetAEmptyGraph() 取得的图), 返回统计信息
+ * @note: 文件无法打开或映射时抛出 std::system_error; 无法解析的行跳过并计入 malformed
+ * @note: 解析是并行的, 插入边集合是串行的 (unordered_set 不支持并发插入); 第一轮之后按读过的比例预估边数一次性 reserve
+ */
+template <typename VerTy, typename WeightType>
+EdgeListStats LoadEdgeList(GraphInstance<VerTy, WeightType>& graph, const std::string& path,
+                           const EdgeListOptions& options = {}) {
+    static_assert(std::is_arithmetic_v<WeightType>, "LoadEdgeList: edge weights are parsed with std::from_chars");
+    using Clock = std::chrono::steady_clock;
+    auto elapsed_ms = [](Clock::time_point since) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - since).count();
+    };
+
+    _detail::MappedFile file(path);
+    file.Advise(MADV_SEQUENTIAL);
+    const char* const data = file.Data();
+    const std::size_t size = file.Size();
+    const std::size_t chunk_bytes = std::max<std::size_t>(options.chunk_bytes, 4096);
+
+    EdgeListStats stats;
+    stats.bytes = size;
+    stats.threads = _detail::WorkerCount(size, std::min(chunk_bytes, std::size_t{1} << 20), options.threads);
+    const uint64_t edges_before = graph.EdgeCount();
+    std::vector<_detail::EdgeChunk<WeightType>> chunks(stats.threads);
+    for (auto& chunk : chunks) {
+        chunk.edges.reserve(chunk_bytes / 16);
+    }
+
+    bool reserved = false;
+    std::vector<const char*> bounds(stats.threads + 1);
+    for (std::size_t round_begin = 0; round_begin < size;) {
+        // 1. 本轮的范围与各块的边界, 都挪到换行符之后
+        std::size_t round_end = size;
+        if (size - round_begin > chunk_bytes * stats.threads) {
+            round_end = static_cast<std::size_t>(_detail::NextLine(data + round_begin + chunk_bytes * stats.threads, data + size) - data);
+        }
+        bounds.front() = data + round_begin;
+        bounds.back() = data + round_end;
+        for (unsigned w = 1; w < stats.threads; ++w) {
+            const char* split = data + round_begin + (round_end - round_begin) * w / stats.threads;
+            bounds[w] = split <= bounds[w - 1] ? bounds[w - 1] : _detail::NextLine(split - 1, data + round_end);
+        }
+
+        // 2. 并行解析
+        auto parse_begin = Clock::now();
+        _detail::ParallelFor(stats.threads, stats.threads, [&](std::size_t begin, std::size_t end, unsigned) {
+            for (std::size_t w = begin; w < end; ++w) {
+                chunks[w].edges.clear();
+                _detail::ParseEdgeChunk(bounds[w], bounds[w + 1], chunks[w]);
+            }
+        });
+        stats.parse_ms += elapsed_ms(parse_begin);
+
+        // 3. 按块的顺序插入, 然后释放读完的页
+        auto insert_begin = Clock::now();
+        if (!reserved && round_end < size) {
+            uint64_t parsed = 0;
+            for (const auto& chunk : chunks) parsed += chunk.edges.size();
+            graph.ReserveEdges(graph.EdgeCount() + static_cast<uint64_t>(static_cast<double>(parsed) * size / round_end));
+            reserved = true;
+        }
+        for (const auto& chunk : chunks) {
+            stats.edges += chunk.edges.size();
+            graph.AddEdges(chunk.edges);
+        }
+        stats.insert_ms += elapsed_ms(insert_begin);
+        file.Release(round_end);
+        round_begin = round_end;
+    }
+    for (const auto& chunk : chunks) {
+        stats.lines += chunk.lines;
+        stats.malformed += chunk.malformed;
+    }
+    stats.inserted = graph.EdgeCount() - edges_before;
+    return stats;
+}
+
+}
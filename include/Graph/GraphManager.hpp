@@ -10,6 +10,8 @@
 #include <iostream>
 #include <functional>
 #include <optional>
+#include <span>
+#include <utility>
 #include "GraphNode.hpp"
 namespace Moonlight::Graph {
 /*
@@ -23,90 +25,193 @@ public:
         Destory();
     }
     GraphInstance(GraphInstance<VerTy, WeightType>&& other){
-        if (*this == other){
-            return;
-        }
-        id = other.id;
-        start_id = other.start_id;
-        _m_list = std::move(other._m_list);
-        _m_matrix = std::move(other._m_matrix);
-        _m_edges = std::move(other._m_edges);
-        _m_vertexs = std::move(other._m_edges);
+        *this = std::move(other);
     }
     GraphInstance& operator=(GraphInstance<VerTy, WeightType>&& other){
-        if (*this == other){
-            return;
+        if (this == &other){
+            return *this;
         }
         id = other.id;
         start_id = other.start_id;
         _m_list = std::move(other._m_list);
         _m_matrix = std::move(other._m_matrix);
         _m_edges = std::move(other._m_edges);
-        _m_vertexs = std::move(other._m_edges);
+        _m_vertexs = std::move(other._m_vertexs);
+        _m_delta = std::move(other._m_delta);
+        _m_pending = std::exchange(other._m_pending, 0);
         return *this;
     }
 
 public:
     GraphInstance& AddVertex(VerTy val=VerTy()){
         _m_vertexs.push_back(val);
+        OnVerticesAdded();
         return *this;
     }
     GraphInstance& AddNVertex(const uint64_t n, VerTy val=VerTy()){
         for (uint64_t i=0; i<n; ++i){
             _m_vertexs.push_back(val);
         }
+        OnVerticesAdded();
         return *this;
     }
 
     template <typename ...Args>
     GraphInstance& AddNVertex(Args... args){
-        (_m_vertexs.pop_back(args), ...);
+        (_m_vertexs.push_back(args), ...);
+        OnVerticesAdded();
         return *this;
     }
     GraphInstance& UpdateVertex(const uint64_t id, VerTy val){
         _m_vertexs[id] = val;
+        return *this;
+    }
+    // @return: 顶点 id 的值, 没有初始化的顶点为 std::nullopt
+    const std::optional<VerTy>& GetVertex(const uint64_t id) const {
+        return _m_vertexs[id];
     }
 
     GraphInstance& AddEdge(const uint64_t from_id, uint64_t to_id, WeightType weight=WeightType(1)){
         // * 检查点 from_id, to_id 是否存在, 不存在则初始化
         uint64_t _id = std::max(from_id, to_id);
-        if (_m_vertexs.size() < _id){
+        if (_m_vertexs.size() <= _id){
             _m_vertexs.resize(_id+1, std::nullopt);
-            _m_vertexs[_id] = VerTy();
-        }else{
-            _m_vertexs[from_id] ?
-                (_m_vertexs[to_id] ?  : _m_vertexs[to_id]=VerTy()) : _m_vertexs[from_id]=VerTy();
+            OnVerticesAdded();
+        }
+        for (uint64_t vertex : {from_id, to_id}){
+            if (!_m_vertexs[vertex]){
+                _m_vertexs[vertex] = VerTy();
+            }
         }
 
-        _m_edges.insert({.from=from_id, .to=to_id, .weight=weight});
+        // * 边已经存在时保持原来的权重
+        if (_m_edges.insert(Edge<WeightType>(from_id, to_id, weight)).second){
+            Record(from_id, to_id, weight);
+        }
         return *this;
     }
 
     GraphInstance& UpdateEdge(uint64_t from_id, uint64_t to_id, WeightType weight=WeightType(1)){
-        auto it = _m_edges.find({.from=from_id, .to=to_id});
+        auto it = _m_edges.find(Edge<WeightType>(from_id, to_id));
         if (it != _m_edges.end()){
-            (*it).weight = weight;
+            // * 集合中的元素是 const, 取出节点修改权重后再放回
+            auto node = _m_edges.extract(it);
+            node.value().weight = weight;
+            _m_edges.insert(std::move(node));
+            Record(from_id, to_id, weight);
         }
         return *this;
     }
-    AdjacencyList<VerTy, WeightType>& List() const {
+    GraphInstance& RemoveEdge(uint64_t from_id, uint64_t to_id){
+        if (_m_edges.erase(Edge<WeightType>(from_id, to_id))){
+            Record(from_id, to_id, std::nullopt);
+        }
+        return *this;
+    }
+    /*
+    * @function: 批量加入边, 与逐条 AddEdge 的结果相同 (已存在的边保持原来的权重), 点集只扩容一次
+    * @note: 边数已知时先调用 ReserveEdges, 避免边集合在插入过程中反复 rehash
+    */
+    GraphInstance& AddEdges(std::span<const Edge<WeightType>> edges){
+        uint64_t _id = 0;
+        for (const auto& edge : edges){
+            _id = std::max({_id, edge.from, edge.to});
+        }
+        if (!edges.empty() && _m_vertexs.size() <= _id){
+            _m_vertexs.resize(_id+1, std::nullopt);
+            OnVerticesAdded();
+        }
+        for (const auto& edge : edges){
+            if (!_m_vertexs[edge.from]){
+                _m_vertexs[edge.from] = VerTy();
+            }
+            if (!_m_vertexs[edge.to]){
+                _m_vertexs[edge.to] = VerTy();
+            }
+            if (_m_edges.insert(edge).second){
+                Record(edge.from, edge.to, edge.weight);
+            }
+        }
+        return *this;
+    }
+    GraphInstance& ReserveEdges(const uint64_t n){
+        _m_edges.reserve(n);
+        return *this;
+    }
+    /*
+    * @function: 图的 CSR 邻接表, 第一次调用时由 _m_edges 并行构造, 之后返回缓存
+    * @note: 构造之后的边修改先记在按顶点分组的 delta 中, 下一次 List() 时只归并受影响的行 (见 AdjacencyList::Merge);
+    *        没有修改时不做任何事. 修改之后之前返回的 span 可能失效
+    * @note: 构造与合并都不加锁, 不要在多个线程中同时调用
+    */
+    const AdjacencyList<VerTy, WeightType>& List() const {
         if (!_m_list){
-            _m_list = AdjacencyList(_m_edges);
+            _m_list = std::make_unique<AdjacencyList<VerTy, WeightType>>(_m_vertexs.size(), _m_edges);
+        } else if (!_m_delta.empty() || _m_list->VertexCount() != _m_vertexs.size()){
+            MergeDelta();
         }
-        return &_m_list;
+        return *_m_list;
     }
-    AdjacencyMatrix<VerTy, WeightType>& Matrix() const {
-        if (!_m_matrix){
-            _m_matrix = AdjacencyMatrix(_m_vertexs.size(), _m_edges);
+    /*
+    * @function: 邻接矩阵, 同样缓存; 请求的 mode 与缓存的不同时重新构造
+    * @note: 边的修改直接就地改位图 (O(1)), 只有顶点数变化时才重新构造
+    */
+    const AdjacencyMatrix<VerTy, WeightType>& Matrix(const MatrixMode mode = MatrixMode::Bitset) const {
+        if (!_m_matrix || _m_matrix->Mode() != mode){
+            _m_matrix = std::make_unique<AdjacencyMatrix<VerTy, WeightType>>(_m_vertexs.size(), _m_edges, mode);
         }
-        return &_m_matrix;
+        return *_m_matrix;
+    }
+    /*
+    * @function: 按邻居 id 升序访问 v 的邻居 visit(u, weight), 读的是 CSR 加上尚未合并的 delta, 不触发合并
+    * @note: O(deg(v) + v 上尚未合并的修改数)
+    */
+    template <typename Visitor>
+    void ForEachNeighbor(const uint64_t v, Visitor&& visit) const {
+        if (!_m_list){
+            List();
+        }
+        std::span<const uint64_t> targets;
+        std::span<const WeightType> weights;
+        if (v < _m_list->VertexCount()){
+            targets = _m_list->Neighbors(v);
+            weights = _m_list->Weights(v);
+        }
+        auto changes = _m_delta.find(v);
+        if (changes == _m_delta.end()){
+            for (std::size_t i = 0; i < targets.size(); ++i){
+                visit(targets[i], weights[i]);
+            }
+        } else {
+            _detail::MergeRow(targets, weights, changes->second, visit);
+        }
+    }
+    // @return: 已记录但尚未合并进 CSR 的边修改数
+    uint64_t PendingMutations() const {
+        return _m_pending;
+    }
+    // @function: 立即把 delta 合并进 CSR
+    void Flush() const {
+        if (_m_list){
+            List();
+        }
+    }
+    uint64_t VertexCount() const {
+        return _m_vertexs.size();
+    }
+    uint64_t EdgeCount() const {
+        return _m_edges.size();
     }
 
 private:
-    uint64_t id;
+    uint64_t id{0};
     uint64_t start_id{1}; // * 起点顶点的id
-    std::unique_ptr<AdjacencyList<VerTy, WeightType>> _m_list {nullptr};
-    std::unique_ptr<AdjacencyMatrix<VerTy, WeightType>> _m_matrix {nullptr};
+    // * 由点集和边集派生的缓存, 边的修改增量地应用到缓存上
+    mutable std::unique_ptr<AdjacencyList<VerTy, WeightType>> _m_list {nullptr};
+    mutable std::unique_ptr<AdjacencyMatrix<VerTy, WeightType>> _m_matrix {nullptr};
+    // * _m_list 构造之后的边修改, 以及记录的修改次数
+    mutable EdgeDelta<WeightType> _m_delta;
+    mutable uint64_t _m_pending {0};
 
     std::vector<std::optional<VerTy>> _m_vertexs;
     std::unordered_set<
@@ -115,6 +220,33 @@ private:
                         typename Edge<WeightType>::EdgeEqual
                       > _m_edges;
 private:
+    // * 修改次数超过 CSR 条目数的 1/8 时在修改时就合并, 不让 delta 无限增长
+    static constexpr uint64_t MinMergeBatch = 4096;
+
+    void OnVerticesAdded(){
+        // * CSR 合并时补上新顶点的空行; 位图每行的长度随顶点数变化, 只能丢弃
+        _m_matrix = nullptr;
+    }
+    void Record(const uint64_t from_id, const uint64_t to_id, const std::optional<WeightType>& weight){
+        if (_m_matrix){
+            _m_matrix->Apply(from_id, to_id, weight);
+        }
+        if (!_m_list){
+            return;
+        }
+        _m_delta[from_id][to_id] = weight;
+        if (from_id != to_id){
+            _m_delta[to_id][from_id] = weight;
+        }
+        if (++_m_pending >= std::max(MinMergeBatch, _m_list->ArcCount() / 8)){
+            MergeDelta();
+        }
+    }
+    void MergeDelta() const {
+        _m_list->Merge(_m_vertexs.size(), _m_delta);
+        _m_delta.clear();
+        _m_pending = 0;
+    }
     void Destory(){
 #ifdef __PRINT_DEBUG_INFO__
         std::cout << "GraphInstance: Destory() Call!\n";
@@ -130,6 +262,8 @@ private:
         }
         _m_vertexs.clear();
         _m_edges.clear();
+        _m_delta.clear();
+        _m_pending = 0;
     }
 };
 
@@ -143,7 +277,7 @@ private:
             GraphInstance<VerTy, WeightType>,
             std::function<void(GraphInstance<VerTy, WeightType>*)> // 自定义内存删除器
         > _ptr;
-        bool flag = false; // * 该内存是否初始化
+        bool flag = false; // * 该图是否正在使用; _ptr 非空时其指向的对象总是已构造的
     };
     using Allocator = typename GraphAllocInfo::Allocator;
 public:
@@ -182,9 +316,7 @@ public:
                     std::cerr << "Allocation failed: " << e.what() << std::endl;
                     throw;
                 }
-            } else { // 内存已分配但未初始化
-                std::construct_at(info._ptr.get());
-            }
+            } // * 内存已分配时对象已经在 DestoryAGraph 中被重置为空图, 直接复用
             info.flag = true;
             return *info._ptr;
         }
@@ -207,15 +339,12 @@ public:
                                         allocator.deallocate(p, 1); // 再释放内存
                                     }
                                 );
-                new_info.flag = true;
+                new_info.flag = (i == 0); // * 只有返回的第一个在使用
                 new_allocs.push_back(std::move(new_info));
             }
         } catch (...) {
             for(auto& info: new_allocs){
-                if (info._ptr){
-                    std::destroy_at(info._ptr.get());
-                    info._ptr.reset();
-                }
+                info._ptr.reset(); // * 删除器负责析构与释放
             }
             throw;
         }
@@ -234,7 +363,7 @@ public:
         auto& info = _m_graphs[id];
         if (!info.flag) return;
 
-        std::destroy_at(info._ptr.get()); // * 销毁对象
+        *info._ptr = GraphInstance<VerTy, WeightType>(); // * 重置为空图, 内存留给下一次 GetAEmptyGraph
         info.flag = false;
     }
 
@@ -293,10 +422,7 @@ private:
 #endif
         std::lock_guard<std::mutex> lock(_mutex);
         for (auto& info : _m_graphs) {
-            if (info._ptr) {
-                std::destroy_at(info._ptr.get());
-                info._ptr.reset();
-            }
+            info._ptr.reset(); // * 删除器先析构对象再释放内存
         }
         _m_graphs.clear();
     }
@@ -1,18 +1,34 @@
 #pragma once
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <limits>
+#include <map>
+#include <new>
+#include <optional>
+#include <span>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 #include <cstdint>
 
+#include "BitKernels.hpp"
+#include "Parallel.hpp"
+
 namespace Moonlight::Graph {
+// * 图算法中表示 "没有这个顶点": 未到达的顶点的距离与父节点等
+inline constexpr uint64_t Unreached = std::numeric_limits<uint64_t>::max();
+
 template<typename Weight=double>
 struct Edge{
 public:
     Edge() = default;
     Edge(const Edge&)  = default;
     Edge(Edge&&)  = default;
+    Edge& operator=(const Edge&) = default;
+    Edge& operator=(Edge&&) = default;
     Edge(uint64_t from, uint64_t to, Weight weight=static_cast<Weight>(1))
     : from(from), to(to), weight(weight){}
 public:
@@ -28,8 +44,9 @@ public:
             return _hash(from, to);
         }
     private:
-        size_t _hash(const uint64_t from, const uint64_t to) {
-            return std::hash<uint64_t>{}(from) * 31 + std::hash<uint64_t>{}(to);
+        // * EdgeEqual 不区分方向, 哈希也必须与方向无关
+        static size_t _hash(const uint64_t from, const uint64_t to) {
+            return std::hash<uint64_t>{}(std::min(from, to)) * 31 + std::hash<uint64_t>{}(std::max(from, to));
         }
     };
 
@@ -46,26 +63,208 @@ public:
     Weight weight;
 };
 
+/*
+ * 尚未合并进 CSR 的修改, 按顶点分组: delta[v][u] 有值表示边 {v, u} 插入或更新为该权重, 为空表示删除
+ * 无向边的两个端点各记一次 (自环一次); 同一条边的多次修改只保留最后一次
+ */
+template <typename Weight>
+using EdgeDelta = std::unordered_map<uint64_t, std::map<uint64_t, std::optional<Weight>>>;
+
+namespace _detail {
+    /*
+    * @function: 有序的一行 (targets, weights) 与这一行的修改做归并, 按邻居 id 升序调用 emit(u, weight)
+    * @note: O(行长 + 修改数)
+    */
+    template <typename Weight, typename Emit>
+    inline void MergeRow(std::span<const uint64_t> targets, std::span<const Weight> weights,
+                         const std::map<uint64_t, std::optional<Weight>>& changes, Emit&& emit) {
+        std::size_t i = 0;
+        for (const auto& [u, weight] : changes) {
+            for (; i < targets.size() && targets[i] < u; ++i) {
+                emit(targets[i], weights[i]);
+            }
+            if (i < targets.size() && targets[i] == u) ++i;
+            if (weight) emit(u, *weight);
+        }
+        for (; i < targets.size(); ++i) {
+            emit(targets[i], weights[i]);
+        }
+    }
+}
+
+/*
+ * 压缩稀疏行 (CSR) 邻接表, 构造之后只能通过 Merge 批量修改
+ *   offsets : 长度为 VertexCount() + 1, 顶点 v 的邻居是 targets[offsets[v], offsets[v + 1])
+ *   targets : 邻居顶点的 id, 每个顶点的邻居按 id 升序排列
+ *   weights : 与 targets 一一对应的边权
+ *
+ *   0 ── 1        offsets: [0, 2, 4, 6, 6]
+ *   │    │        targets: [1, 2 | 0, 2 | 0, 1]
+ *   2 ───┘        顶点 3 没有边
+ *
+ * Edge::EdgeEqual 不区分方向, 图是无向图: 一条边 {u, v} 同时写入 u 与 v 的邻居, 自环只写一次
+ * 遍历一个顶点的邻居就是顺序扫描两段连续内存
+ */
 template <typename VerTy=int, typename Weight=double>
 struct AdjacencyList{
+    using vertex_type = uint64_t;
+    using weight_type = Weight;
+
+    // * 每个线程至少处理的边数, 边数更少时串行构造
+    static constexpr std::size_t ParallelGrain = 1 << 15;
+
     AdjacencyList() = default;
-    // * 边的集合初始化
-    explicit AdjacencyList(std::unordered_set<Edge<Weight>> list) {
+    /*
+    * @function: 由边集合构造 CSR: 统计度数 -> 前缀和 -> 分散写入 -> 各顶点的邻居排序, 每一步都并行
+    * @param: vertex_count 顶点数, 所有边的端点都必须小于它
+    * @param: edges 提供 bucket_count() 与 begin(b)/end(b) 的哈希集合, 各线程按桶划分
+    * @param: threads 最多使用的线程数, 0 表示 hardware_concurrency
+    * @note: 同一输入无论用多少线程, 得到的三个数组都完全相同
+    */
+    template <typename EdgeSet>
+    AdjacencyList(const uint64_t vertex_count, const EdgeSet& edges, const unsigned threads = 0)
+        : _m_offsets(vertex_count + 1, 0) {
+        const unsigned workers = _detail::WorkerCount(edges.size(), ParallelGrain, threads);
+        const bool concurrent = workers > 1;
+        const std::size_t buckets = edges.bucket_count();
 
+        // 1. 度数, 暂存在 offsets[v + 1]
+        _detail::ParallelFor(buckets, workers, [&](std::size_t begin, std::size_t end, unsigned) {
+            for (std::size_t b = begin; b < end; ++b) {
+                for (auto it = edges.begin(b); it != edges.end(b); ++it) {
+                    FetchAdd(_m_offsets[it->from + 1], concurrent);
+                    if (it->from != it->to) {
+                        FetchAdd(_m_offsets[it->to + 1], concurrent);
+                    }
+                }
+            }
+        });
+        // 2. 前缀和, offsets[v] 成为 v 的第一个邻居的位置
+        _detail::ParallelInclusiveScan(_m_offsets, workers);
+
+        // 3. 分散写入, cursor[v] 是 v 的下一个空位
+        _m_targets.resize(_m_offsets.back());
+        _m_weights.resize(_m_offsets.back());
+        std::vector<uint64_t> cursor(_m_offsets.begin(), _m_offsets.end() - 1);
+        _detail::ParallelFor(buckets, workers, [&](std::size_t begin, std::size_t end, unsigned) {
+            for (std::size_t b = begin; b < end; ++b) {
+                for (auto it = edges.begin(b); it != edges.end(b); ++it) {
+                    uint64_t slot = FetchAdd(cursor[it->from], concurrent);
+                    _m_targets[slot] = it->to;
+                    _m_weights[slot] = it->weight;
+                    if (it->from != it->to) {
+                        slot = FetchAdd(cursor[it->to], concurrent);
+                        _m_targets[slot] = it->from;
+                        _m_weights[slot] = it->weight;
+                    }
+                }
+            }
+        });
+
+        // 4. 写入顺序取决于桶的遍历顺序与线程调度, 排序后结果确定
+        _detail::ParallelFor(vertex_count, _detail::WorkerCount(vertex_count, ParallelGrain / 8, workers),
+            [&](std::size_t begin, std::size_t end, unsigned) {
+                std::vector<std::pair<uint64_t, Weight>> scratch;
+                for (std::size_t v = begin; v < end; ++v) {
+                    SortSegment(_m_offsets[v], _m_offsets[v + 1], scratch);
+                }
+            });
     }
     void Destory(){
-        _m_list.clear();
+        _m_offsets.clear();
+        _m_targets.clear();
+        _m_weights.clear();
     }
 
-public:
-    template <typename WeightType=Weight>
-    AdjacencyList& SetEdge(const uint64_t from, const uint64_t to, WeightType weight){
+    /*
+    * @function: 把 delta 合并进来, 结果与用修改后的边集合重新构造的 CSR 完全相同
+    * @param: vertex_count 新的顶点数, 不能小于当前顶点数; 新增的顶点只出现在 delta 中或没有邻居
+    * @note: 只有 delta 中的行逐个归并; 两个受影响的行之间的行整段拷贝, 只需要平移 offsets,
+    *        不再遍历哈希集合, 也不再排序
+    */
+    void Merge(const uint64_t vertex_count, const EdgeDelta<Weight>& delta) {
+        const uint64_t old_count = VertexCount();
+        std::vector<uint64_t> rows;
+        rows.reserve(delta.size());
+        for (const auto& entry : delta) rows.push_back(entry.first);
+        std::sort(rows.begin(), rows.end());
+
+        // 1. 受影响的行归并到临时缓冲
+        std::vector<uint64_t> merged_targets;
+        std::vector<Weight> merged_weights;
+        std::vector<uint64_t> merged_begin {0};
+        uint64_t removed = 0;
+        for (uint64_t v : rows) {
+            std::span<const uint64_t> targets;
+            std::span<const Weight> weights;
+            if (v < old_count) {
+                targets = Neighbors(v);
+                weights = Weights(v);
+                removed += targets.size();
+            }
+            _detail::MergeRow(targets, weights, delta.find(v)->second, [&](uint64_t u, const Weight& weight) {
+                merged_targets.push_back(u);
+                merged_weights.push_back(weight);
+            });
+            merged_begin.push_back(merged_targets.size());
+        }
+
+        // 2. 拼出新数组: 未受影响的行整段拷贝, 受影响的行从缓冲拷贝
+        std::vector<uint64_t> offsets(vertex_count + 1);
+        std::vector<uint64_t> targets;
+        std::vector<Weight> weights;
+        targets.reserve(ArcCount() - removed + merged_targets.size());
+        weights.reserve(targets.capacity());
+        auto copy_rows = [&](const uint64_t begin, const uint64_t end) {
+            const uint64_t base_end = std::clamp(end, begin, old_count);
+            if (begin < base_end) {
+                const uint64_t shift = targets.size() - _m_offsets[begin];
+                for (uint64_t x = begin; x < base_end; ++x) offsets[x] = _m_offsets[x] + shift;
+                targets.insert(targets.end(), _m_targets.begin() + _m_offsets[begin], _m_targets.begin() + _m_offsets[base_end]);
+                weights.insert(weights.end(), _m_weights.begin() + _m_offsets[begin], _m_weights.begin() + _m_offsets[base_end]);
+            }
+            for (uint64_t x = std::max(begin, base_end); x < end; ++x) offsets[x] = targets.size();
+        };
+        uint64_t next_row = 0;
+        for (std::size_t i = 0; i < rows.size(); ++i) {
+            copy_rows(next_row, rows[i]);
+            offsets[rows[i]] = targets.size();
+            targets.insert(targets.end(), merged_targets.begin() + merged_begin[i], merged_targets.begin() + merged_begin[i + 1]);
+            weights.insert(weights.end(), merged_weights.begin() + merged_begin[i], merged_weights.begin() + merged_begin[i + 1]);
+            next_row = rows[i] + 1;
+        }
+        copy_rows(next_row, vertex_count);
+        offsets[vertex_count] = targets.size();
 
-        return *this;
+        _m_offsets = std::move(offsets);
+        _m_targets = std::move(targets);
+        _m_weights = std::move(weights);
     }
-    AdjacencyList& AddVertex(){
 
+public:
+    uint64_t VertexCount() const noexcept {
+        return _m_offsets.empty() ? 0 : _m_offsets.size() - 1;
     }
+    // @return: 邻接表中的条目数, 无向边计两次, 自环计一次
+    uint64_t ArcCount() const noexcept {
+        return _m_targets.size();
+    }
+    uint64_t Degree(const uint64_t v) const noexcept {
+        return _m_offsets[v + 1] - _m_offsets[v];
+    }
+    // @return: v 的邻居, 按 id 升序
+    std::span<const uint64_t> Neighbors(const uint64_t v) const noexcept {
+        return {_m_targets.data() + _m_offsets[v], Degree(v)};
+    }
+    // @return: 与 Neighbors(v) 一一对应的边权
+    std::span<const Weight> Weights(const uint64_t v) const noexcept {
+        return {_m_weights.data() + _m_offsets[v], Degree(v)};
+    }
+    // * 三个底层数组, 供需要整体扫描的算法直接使用
+    std::span<const uint64_t> Offsets() const noexcept { return _m_offsets; }
+    std::span<const uint64_t> Targets() const noexcept { return _m_targets; }
+    std::span<const Weight> EdgeWeights() const noexcept { return _m_weights; }
+
     void SetStartVertex(const uint64_t id){
         start_id = id;
     }
@@ -73,28 +272,224 @@ public:
         return id;
     }
 private:
-    // * 邻接表是from->to, 其值为权重
-    std::vector<std::vector<Weight>> _m_list;
+    static uint64_t FetchAdd(uint64_t& counter, const bool concurrent) noexcept {
+        if (concurrent) {
+            return std::atomic_ref<uint64_t>(counter).fetch_add(1, std::memory_order_relaxed);
+        }
+        return counter++;
+    }
+    // @function: 把 [begin, end) 内的邻居按 id 排序, 边权随之移动
+    void SortSegment(const uint64_t begin, const uint64_t end, std::vector<std::pair<uint64_t, Weight>>& scratch) {
+        if (end - begin <= 16) {
+            // 度数小的顶点占绝大多数, 直接在两个数组上插入排序
+            for (uint64_t i = begin + 1; i < end; ++i) {
+                uint64_t target = _m_targets[i];
+                Weight weight = _m_weights[i];
+                uint64_t j = i;
+                for (; j > begin && target < _m_targets[j - 1]; --j) {
+                    _m_targets[j] = _m_targets[j - 1];
+                    _m_weights[j] = _m_weights[j - 1];
+                }
+                _m_targets[j] = target;
+                _m_weights[j] = weight;
+            }
+            return;
+        }
+        scratch.clear();
+        for (uint64_t i = begin; i < end; ++i) {
+            scratch.emplace_back(_m_targets[i], _m_weights[i]);
+        }
+        std::sort(scratch.begin(), scratch.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+        for (uint64_t i = begin; i < end; ++i) {
+            _m_targets[i] = scratch[i - begin].first;
+            _m_weights[i] = scratch[i - begin].second;
+        }
+    }
+private:
+    std::vector<uint64_t> _m_offsets;
+    std::vector<uint64_t> _m_targets;
+    std::vector<Weight> _m_weights;
     // * 起点默认设置为uint64_t start_id = 1 的点
     uint64_t start_id{1};
     // * 邻接表本身的id
-    uint64_t id;
+    uint64_t id{0};
 };
 
+// * Bitset: 只保存连通关系, 每个格子 1 位; Weighted: 另外保存 n * n 个边权
+enum class MatrixMode {
+    Bitset,
+    Weighted,
+};
+
+/*
+ * 邻接矩阵, 以位图保存: 第 v 行的第 u 位表示边 {v, u} 是否存在
+ * 每行补齐到 SimdWords 个字 (256 位) 的倍数, 行首 64 字节对齐, 两行按字 AND 再 popcount 就是公共邻居数
+ *
+ *   row 0: 0110 0000 ... | padding
+ *   row 1: 1010 0000 ... | padding      common(0, 1) = popcount(row0 & row1) = popcount(0010) = 1
+ *   row 2: 1100 0000 ... | padding
+ *
+ * 与 AdjacencyList 一样按无向图处理; 稠密的无权图每个格子 1 位, 是 double 矩阵的 1/64
+ */
 template <typename VerTy=int, typename Weight=double>
 struct AdjacencyMatrix{
     AdjacencyMatrix() = default;
-    AdjacencyMatrix(const uint64_t number,
-                    std::unordered_set<
-                        Edge<Weight>,
-                        typename Edge<Weight>::EdgeHash,
-                        typename Edge<Weight>::EdgeEqual
-                    > edges){}
+    template <typename EdgeSet>
+    AdjacencyMatrix(const uint64_t number, const EdgeSet& edges, const MatrixMode mode = MatrixMode::Bitset)
+        : _m_vertices(number), _m_row_words(((number + 63) / 64 + _detail::SimdWords - 1) & ~(_detail::SimdWords - 1)),
+          _m_mode(mode) {
+        if (_m_vertices) {
+            _m_bits = static_cast<uint64_t*>(::operator new(sizeof(uint64_t) * Words(), BitsAlignment));
+            std::fill_n(_m_bits, Words(), uint64_t{0});
+        }
+        if (mode == MatrixMode::Weighted) {
+            _m_matrix.assign(number * number, Weight());
+        }
+        for (const auto& edge : edges) {
+            SetBit(edge.from, edge.to);
+            SetBit(edge.to, edge.from);
+            if (mode == MatrixMode::Weighted) {
+                _m_matrix[edge.from * number + edge.to] = edge.weight;
+                _m_matrix[edge.to * number + edge.from] = edge.weight;
+            }
+        }
+        _m_degree.resize(number);
+        for (uint64_t v = 0; v < number; ++v) {
+            _m_degree[v] = _detail::AndPopcount(Row(v).data(), Row(v).data(), _m_row_words);
+        }
+    }
+    AdjacencyMatrix(const AdjacencyMatrix&) = delete;
+    AdjacencyMatrix& operator=(const AdjacencyMatrix&) = delete;
+    ~AdjacencyMatrix() {
+        Destory();
+    }
 
     void Destory(){
+        if (_m_bits) {
+            ::operator delete(_m_bits, BitsAlignment);
+            _m_bits = nullptr;
+        }
+        _m_vertices = 0;
+        _m_degree.clear();
         _m_matrix.clear();
     }
+
+    /*
+    * @function: 就地修改一条边: weight 有值表示插入或更新, 为空表示删除, O(1)
+    * @note: u, v 必须小于 VertexCount(); 顶点数变化时每行的长度也变了, 只能重新构造
+    */
+    void Apply(const uint64_t u, const uint64_t v, const std::optional<Weight>& weight) noexcept {
+        const bool present = HasEdge(u, v);
+        if (weight && !present) {
+            SetBit(u, v);
+            SetBit(v, u);
+            ++_m_degree[u];
+            if (u != v) ++_m_degree[v];
+        } else if (!weight && present) {
+            ClearBit(u, v);
+            ClearBit(v, u);
+            --_m_degree[u];
+            if (u != v) --_m_degree[v];
+        }
+        if (_m_mode == MatrixMode::Weighted) {
+            _m_matrix[u * _m_vertices + v] = _m_matrix[v * _m_vertices + u] = weight.value_or(Weight());
+        }
+    }
+
+public:
+    uint64_t VertexCount() const noexcept {
+        return _m_vertices;
+    }
+    MatrixMode Mode() const noexcept {
+        return _m_mode;
+    }
+    bool HasEdge(const uint64_t u, const uint64_t v) const noexcept {
+        return _m_bits[u * _m_row_words + (v >> 6)] >> (v & 63) & 1;
+    }
+    // @return: 边 {u, v} 的权重, 只在 Weighted 模式下可用; 不存在的边为 Weight()
+    const Weight& At(const uint64_t u, const uint64_t v) const noexcept {
+        return _m_matrix[u * _m_vertices + v];
+    }
+    // @return: 第 v 行的位图, 长度为补齐后的字数, 补齐部分全为 0
+    std::span<const uint64_t> Row(const uint64_t v) const noexcept {
+        return {_m_bits + v * _m_row_words, _m_row_words};
+    }
+    // @return: v 的邻居数, 自环计一次
+    uint64_t Degree(const uint64_t v) const noexcept {
+        return _m_degree[v];
+    }
+
+    // @return: |N(u) ∩ N(v)|
+    uint64_t CommonNeighbors(const uint64_t u, const uint64_t v) const noexcept {
+        return _detail::AndPopcount(Row(u).data(), Row(v).data(), _m_row_words);
+    }
+    // @return: |N(u) ∩ N(v)| / |N(u) ∪ N(v)|, 两者都没有邻居时为 0
+    double Jaccard(const uint64_t u, const uint64_t v) const noexcept {
+        const uint64_t common = CommonNeighbors(u, v);
+        const uint64_t together = _m_degree[u] + _m_degree[v] - common;
+        return together ? static_cast<double>(common) / static_cast<double>(together) : 0.0;
+    }
+    // * 批量版本, out[i] 对应 pairs[i]
+    void CommonNeighbors(std::span<const std::pair<uint64_t, uint64_t>> pairs, std::span<uint64_t> out) const noexcept {
+        for (std::size_t i = 0; i < pairs.size(); ++i) {
+            out[i] = CommonNeighbors(pairs[i].first, pairs[i].second);
+        }
+    }
+    void Jaccard(std::span<const std::pair<uint64_t, uint64_t>> pairs, std::span<double> out) const noexcept {
+        for (std::size_t i = 0; i < pairs.size(); ++i) {
+            out[i] = Jaccard(pairs[i].first, pairs[i].second);
+        }
+    }
+    /*
+    * @function: 三角形个数 (自环不参与)
+    * @note: 每条边 {u, v} (u < v) 贡献 |N(u) ∩ N(v)|, 每个三角形被它的三条边各数一次
+    * @param: threads 最多使用的线程数, 0 表示 hardware_concurrency
+    */
+    uint64_t CountTriangles(const unsigned threads = 0) const {
+        const unsigned workers = _detail::WorkerCount(_m_vertices, 256, threads);
+        std::vector<uint64_t> partial(workers, 0);
+        _detail::ParallelFor(_m_vertices, workers, [&](std::size_t begin, std::size_t end, unsigned w) {
+            uint64_t sum = 0;
+            for (uint64_t u = begin; u < end; ++u) {
+                const uint64_t* row = Row(u).data();
+                const uint64_t loop_u = HasEdge(u, u);
+                // 只看 v > u 的位
+                for (std::size_t word = (u + 1) >> 6; word < _m_row_words; ++word) {
+                    uint64_t bits = row[word];
+                    if (word == (u + 1) >> 6) bits &= ~uint64_t{0} << ((u + 1) & 63);
+                    for (; bits; bits &= bits - 1) {
+                        const uint64_t v = word * 64 + std::countr_zero(bits);
+                        sum += CommonNeighbors(u, v) - loop_u - HasEdge(v, v);
+                    }
+                }
+            }
+            partial[w] = sum;
+        });
+        uint64_t total = 0;
+        for (uint64_t sum : partial) total += sum;
+        return total / 3;
+    }
+
+private:
+    static constexpr std::align_val_t BitsAlignment {64};
+
+    std::size_t Words() const noexcept {
+        return static_cast<std::size_t>(_m_vertices * _m_row_words);
+    }
+    void SetBit(const uint64_t u, const uint64_t v) noexcept {
+        _m_bits[u * _m_row_words + (v >> 6)] |= uint64_t{1} << (v & 63);
+    }
+    void ClearBit(const uint64_t u, const uint64_t v) noexcept {
+        _m_bits[u * _m_row_words + (v >> 6)] &= ~(uint64_t{1} << (v & 63));
+    }
+
 private:
+    uint64_t _m_vertices{0};
+    std::size_t _m_row_words{0};
+    MatrixMode _m_mode{MatrixMode::Bitset};
+    uint64_t* _m_bits{nullptr};
+    std::vector<uint64_t> _m_degree;
+    // * Weighted 模式下的 n * n 边权, 行优先
     std::vector<Weight> _m_matrix;
 };
-}
\ No newline at end of file
+}
@@ -0,0 +1,106 @@
+#pragma once
+// 只读内存映射文件 (POSIX mmap), 边表加载与图快照共用
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Moonlight::Graph::_detail {
+
+/*
+ * 整个文件映射为只读, 页在第一次访问时才由内核读入
+ * 打开或映射失败时抛出 std::system_error; 空文件不映射, Data() 为 nullptr
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), "open " + path);
+        }
+        struct stat info {};
+        if (::fstat(fd, &info) != 0) {
+            int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), "fstat " + path);
+        }
+        _m_size = static_cast<std::size_t>(info.st_size);
+        if (_m_size > 0) {
+            void* data = ::mmap(nullptr, _m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED) {
+                int error = errno;
+                ::close(fd);
+                throw std::system_error(error, std::generic_category(), "mmap " + path);
+            }
+            _m_data = static_cast<const char*>(data);
+        }
+        // * 映射建立后不再需要文件描述符
+        ::close(fd);
+    }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept {
+        *this = std::move(other);
+    }
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if (this == &other) {
+            return *this;
+        }
+        Destory();
+        _m_data = std::exchange(other._m_data, nullptr);
+        _m_size = std::exchange(other._m_size, 0);
+        return *this;
+    }
+    ~MappedFile() {
+        Destory();
+    }
+
+public:
+    const char* Data() const noexcept {
+        return _m_data;
+    }
+    std::size_t Size() const noexcept {
+        return _m_size;
+    }
+    // @function: 给内核的访问模式提示 (MADV_SEQUENTIAL / MADV_RANDOM / MADV_WILLNEED ...), 失败时忽略
+    void Advise(const int advice) const noexcept {
+        if (_m_data) {
+            ::madvise(const_cast<char*>(_m_data), _m_size, advice);
+        }
+    }
+    /*
+    * @function: 已经读完的 [0, end) 不再需要, 从进程中解除这些页, 之后再访问会重新从页缓存读入
+    * @note: 按页向下取整, 最后一个不完整的页保留
+    */
+    void Release(const std::size_t end) const noexcept {
+        const std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        const std::size_t length = std::min(end, _m_size) / page * page;
+        if (_m_data && length > 0) {
+            ::madvise(const_cast<char*>(_m_data), length, MADV_DONTNEED);
+        }
+    }
+
+private:
+    void Destory() noexcept {
+        if (_m_data) {
+            ::munmap(const_cast<char*>(_m_data), _m_size);
+        }
+        _m_data = nullptr;
+        _m_size = 0;
+    }
+
+private:
+    const char* _m_data = nullptr;
+    std::size_t _m_size = 0;
+};
+
+}
@@ -0,0 +1,74 @@
+#pragma once
+// 图算法内部共用的简单并行工具: 把 [0, n) 切成连续的块交给若干线程
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace Moonlight::Graph::_detail {
+
+// @return: 处理 n 个单位的工作应该使用的线程数, 每个线程至少分到 grain 个单位
+inline unsigned WorkerCount(const std::size_t n, const std::size_t grain, unsigned threads = 0) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    std::size_t by_work = std::max<std::size_t>(1, n / std::max<std::size_t>(1, grain));
+    return static_cast<unsigned>(std::min<std::size_t>(threads, by_work));
+}
+
+/*
+ * @function: 把 [0, n) 均分为 workers 个连续块, 并行调用 fn(begin, end, worker)
+ * @note: 最后一块在调用线程上执行; workers == 1 时不创建任何线程
+ */
+template <typename Fn>
+inline void ParallelFor(const std::size_t n, const unsigned workers, Fn&& fn) {
+    if (workers <= 1) {
+        fn(std::size_t{0}, n, 0u);
+        return;
+    }
+    std::vector<std::thread> pool;
+    pool.reserve(workers - 1);
+    for (unsigned w = 0; w + 1 < workers; ++w) {
+        pool.emplace_back([&fn, n, w, workers] { fn(n * w / workers, n * (w + 1) / workers, w); });
+    }
+    fn(n * (workers - 1) / workers, n, workers - 1);
+    for (auto& thread : pool) {
+        thread.join();
+    }
+}
+
+/*
+ * @function: 原地计算 data 的包含前缀和
+ * @note: 分块两遍: 各块求和 -> 块和的前缀和 (串行, 只有 workers 个数) -> 各块加上基数后做块内前缀和
+ */
+inline void ParallelInclusiveScan(std::vector<uint64_t>& data, const unsigned workers) {
+    if (workers <= 1) {
+        for (std::size_t i = 1; i < data.size(); ++i) {
+            data[i] += data[i - 1];
+        }
+        return;
+    }
+    std::vector<uint64_t> block_sum(workers, 0);
+    ParallelFor(data.size(), workers, [&](std::size_t begin, std::size_t end, unsigned w) {
+        uint64_t sum = 0;
+        for (std::size_t i = begin; i < end; ++i) {
+            sum += data[i];
+        }
+        block_sum[w] = sum;
+    });
+    uint64_t base = 0;
+    for (auto& sum : block_sum) {
+        base += std::exchange(sum, base);
+    }
+    ParallelFor(data.size(), workers, [&](std::size_t begin, std::size_t end, unsigned w) {
+        uint64_t running = block_sum[w];
+        for (std::size_t i = begin; i < end; ++i) {
+            running += data[i];
+            data[i] = running;
+        }
+    });
+}
+
+}
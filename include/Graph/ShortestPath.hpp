@@ -0,0 +1,474 @@
+#pragma once
+/*
+ *  单源最短路, 在 GraphInstance::List() 的 CSR 上运行, 边权必须非负
+ *
+ *  Dijkstra (串行, 适合大量的单次查询)
+ *    基数堆: 出堆的键单调不减, 按 "与上一次出堆的键最高的不同位" 分桶,
+ *            每个元素最多在桶之间下移 位宽 次, 没有比较堆的 log n
+ *            整数边权直接作键; 非负 float/double 的位模式是保序的, 同样可以作键
+ *    配对堆: decrease-key, 每个顶点在堆中只有一个节点; 用于无法映射为整数键的边权类型
+ *            实测在随机图与网格上都慢于基数堆 (指针跳转多), 所以默认只在基数堆不可用时使用
+ *
+ *  Delta-stepping (并行, 适合大图)
+ *    按 floor(dist / delta) 分桶, 同一个桶内的顶点并行松弛, 松弛用 CAS 取最小值
+ *    桶内的顶点可能被重复处理, 以少量重复工作换取同一桶内不需要任何顺序
+ *
+ *      bin 0     bin 1     bin 2
+ *    [0,delta) [delta,2d) [2d,3d) ...   各线程有自己的一组桶, 每一轮合并编号最小的非空桶
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "GraphManager.hpp"
+#include "Parallel.hpp"
+
+namespace Moonlight::Graph {
+
+// * 未到达的顶点的距离
+template <typename Weight>
+inline constexpr Weight InfiniteDistance = std::numeric_limits<Weight>::has_infinity
+                                               ? std::numeric_limits<Weight>::infinity()
+                                               : std::numeric_limits<Weight>::max();
+
+template <typename Weight>
+struct ShortestPathResult {
+    // * parent[source] == source, 未到达的顶点 distance 为 InfiniteDistance, parent 为 Unreached
+    std::vector<Weight> distance;
+    std::vector<uint64_t> parent;
+
+    bool Reached(const uint64_t v) const noexcept {
+        return v < parent.size() && parent[v] != Unreached;
+    }
+};
+
+/*
+ * @function: 单调的最小堆, 要求每次 Push 的键不小于上一次 Pop 出的键 (Dijkstra 恰好满足)
+ * @note: 桶 0 存放等于 last 的键, 桶 i 存放与 last 最高的不同位为第 i 位的键
+ */
+template <std::unsigned_integral Key, typename Value>
+class RadixHeap {
+public:
+    void Push(const Key key, const Value value) {
+        _m_buckets[BucketOf(key)].emplace_back(key, value);
+        ++_m_size;
+    }
+    // @function: 弹出键最小的元素, 堆不能为空
+    std::pair<Key, Value> Pop() {
+        if (_m_buckets[0].empty()) {
+            std::size_t i = 1;
+            while (_m_buckets[i].empty()) ++i;
+            // 新的 last 是桶 i 中的最小值, 桶 i 的元素按新的 last 全部下移到更小的桶
+            _m_last = std::min_element(_m_buckets[i].begin(), _m_buckets[i].end())->first;
+            for (const auto& entry : _m_buckets[i]) {
+                _m_buckets[BucketOf(entry.first)].push_back(entry);
+            }
+            _m_buckets[i].clear();
+        }
+        auto top = _m_buckets[0].back();
+        _m_buckets[0].pop_back();
+        --_m_size;
+        return top;
+    }
+    bool Empty() const noexcept {
+        return _m_size == 0;
+    }
+    std::size_t Size() const noexcept {
+        return _m_size;
+    }
+
+private:
+    std::size_t BucketOf(const Key key) const noexcept {
+        return static_cast<std::size_t>(std::bit_width(static_cast<Key>(key ^ _m_last)));
+    }
+
+private:
+    std::vector<std::pair<Key, Value>> _m_buckets[std::numeric_limits<Key>::digits + 1];
+    Key _m_last{0};
+    std::size_t _m_size{0};
+};
+
+/*
+ * @function: 以顶点 id (0 .. n-1) 为节点的配对堆, 支持 decrease-key
+ * @note: 节点放在按 id 下标的数组中, 不单独分配内存; Index 为 uint32_t 时一个节点 (double 键) 只占 24 字节
+ * @note: Pop 用两遍合并: 从左到右两两合并孩子, 再从右到左合并成一棵
+ */
+template <typename Key, std::unsigned_integral Index = uint32_t>
+class PairingHeap {
+public:
+    static constexpr Index None = std::numeric_limits<Index>::max();
+
+    explicit PairingHeap(const uint64_t n) : _m_nodes(n) {}
+
+    bool Empty() const noexcept {
+        return _m_root == None;
+    }
+    bool Contains(const uint64_t v) const noexcept {
+        return _m_nodes[v].in_heap;
+    }
+    const Key& KeyOf(const uint64_t v) const noexcept {
+        return _m_nodes[v].key;
+    }
+    void Push(const uint64_t v, const Key key) {
+        _m_nodes[v] = Node{key, None, None, None, true};
+        _m_root = Empty() ? static_cast<Index>(v) : Meld(_m_root, static_cast<Index>(v));
+    }
+    // @function: 把 v 的键降为 key, 以 v 为根的子树整体剪下再与根合并
+    void DecreaseKey(const uint64_t v, const Key key) {
+        _m_nodes[v].key = key;
+        if (v == _m_root) return;
+        Cut(static_cast<Index>(v));
+        _m_root = Meld(_m_root, static_cast<Index>(v));
+    }
+    // @function: 弹出键最小的顶点, 堆不能为空
+    uint64_t Pop() {
+        const Index top = _m_root;
+        _m_nodes[top].in_heap = false;
+        _m_root = MergePairs(_m_nodes[top].child);
+        if (_m_root != None) _m_nodes[_m_root].prev = None;
+        return top;
+    }
+
+private:
+    struct Node {
+        Key key;
+        Index child = None;
+        Index sibling = None;
+        Index prev = None; // * 左兄弟, 或者是父节点 (自己是最左孩子时)
+        bool in_heap = false;
+    };
+
+    // @function: 合并两棵树, 键大的一方成为另一方的最左孩子, 返回新根
+    Index Meld(Index a, Index b) {
+        if (_m_nodes[b].key < _m_nodes[a].key) std::swap(a, b);
+        Node& parent = _m_nodes[a];
+        Node& child = _m_nodes[b];
+        child.prev = a;
+        child.sibling = parent.child;
+        if (parent.child != None) _m_nodes[parent.child].prev = b;
+        parent.child = b;
+        parent.sibling = None;
+        return a;
+    }
+    void Cut(const Index v) {
+        Node& node = _m_nodes[v];
+        Node& prev = _m_nodes[node.prev];
+        if (prev.child == v) {
+            prev.child = node.sibling;
+        } else {
+            prev.sibling = node.sibling;
+        }
+        if (node.sibling != None) _m_nodes[node.sibling].prev = node.prev;
+        node.prev = node.sibling = None;
+    }
+    Index MergePairs(Index first) {
+        if (first == None) return None;
+        _m_pairs.clear();
+        while (first != None) {
+            Index a = first, b = _m_nodes[a].sibling;
+            if (b == None) {
+                _m_nodes[a].sibling = None;
+                _m_pairs.push_back(a);
+                break;
+            }
+            first = _m_nodes[b].sibling;
+            _m_nodes[a].sibling = _m_nodes[b].sibling = None;
+            _m_pairs.push_back(Meld(a, b));
+        }
+        Index root = _m_pairs.back();
+        for (std::size_t i = _m_pairs.size() - 1; i-- > 0; ) {
+            root = Meld(_m_pairs[i], root);
+        }
+        return root;
+    }
+
+private:
+    std::vector<Node> _m_nodes;
+    std::vector<Index> _m_pairs;
+    Index _m_root = None;
+};
+
+namespace _detail {
+
+    template <typename Weight>
+    ShortestPathResult<Weight> EmptyPaths(const uint64_t n) {
+        return {std::vector<Weight>(n, InfiniteDistance<Weight>), std::vector<uint64_t>(n, Unreached)};
+    }
+
+    // @function: slot = min(slot, value), 成功降低时返回 true
+    template <typename Weight>
+    bool RelaxMin(Weight& slot, const Weight value, const bool concurrent) {
+        if (!concurrent) {
+            if (!(value < slot)) return false;
+            slot = value;
+            return true;
+        }
+        std::atomic_ref<Weight> ref(slot);
+        Weight old = ref.load(std::memory_order_relaxed);
+        while (value < old) {
+            if (ref.compare_exchange_weak(old, value, std::memory_order_relaxed)) return true;
+        }
+        return false;
+    }
+}
+
+// * Dijkstra 使用的优先队列; Auto: 整数与 32/64 位浮点边权用基数堆, 其他用配对堆
+enum class DijkstraHeap {
+    Auto,
+    Radix,
+    Pairing,
+};
+
+namespace _detail {
+
+    template <typename Weight>
+    concept RadixKeyable = std::is_integral_v<Weight> ||
+                           (std::is_floating_point_v<Weight> && (sizeof(Weight) == 4 || sizeof(Weight) == 8));
+
+    /*
+    * @function: 把非负距离映射为保序的无符号整数键
+    * @note: 非负 IEEE 浮点数的位模式按无符号整数比较与数值比较一致, 所以浮点边权也能用基数堆
+    */
+    template <RadixKeyable Weight>
+    inline auto RadixKey(const Weight distance) noexcept {
+        if constexpr (std::is_integral_v<Weight>) {
+            return static_cast<std::make_unsigned_t<Weight>>(distance);
+        } else {
+            using Key = std::conditional_t<sizeof(Weight) == 8, uint64_t, uint32_t>;
+            return std::bit_cast<Key>(distance);
+        }
+    }
+
+    template <typename VerTy, typename Weight>
+    void RadixDijkstra(const AdjacencyList<VerTy, Weight>& graph, const uint64_t source, const uint64_t target,
+                       ShortestPathResult<Weight>& result) {
+        auto& distance = result.distance;
+        auto& parent = result.parent;
+        RadixHeap<decltype(RadixKey(Weight{})), uint64_t> heap;
+        heap.Push(RadixKey(Weight{}), source);
+        while (!heap.Empty()) {
+            auto [key, u] = heap.Pop();
+            // 懒删除: 同一个顶点可能以更大的旧键留在堆中
+            if (key != RadixKey(distance[u])) continue;
+            if (u == target) break;
+            auto neighbors = graph.Neighbors(u);
+            auto weights = graph.Weights(u);
+            for (std::size_t i = 0; i < neighbors.size(); ++i) {
+                const uint64_t v = neighbors[i];
+                const Weight candidate = distance[u] + weights[i];
+                if (candidate < distance[v]) {
+                    distance[v] = candidate;
+                    parent[v] = u;
+                    heap.Push(RadixKey(candidate), v);
+                }
+            }
+        }
+    }
+
+    template <typename VerTy, typename Weight>
+    void PairingDijkstra(const AdjacencyList<VerTy, Weight>& graph, const uint64_t source, const uint64_t target,
+                         ShortestPathResult<Weight>& result) {
+        const uint64_t n = graph.VertexCount();
+        auto& distance = result.distance;
+        auto& parent = result.parent;
+        auto run = [&](auto& heap) {
+            heap.Push(source, Weight{});
+            while (!heap.Empty()) {
+                const uint64_t u = heap.Pop();
+                if (u == target) break;
+                auto neighbors = graph.Neighbors(u);
+                auto weights = graph.Weights(u);
+                for (std::size_t i = 0; i < neighbors.size(); ++i) {
+                    const uint64_t v = neighbors[i];
+                    const Weight candidate = distance[u] + weights[i];
+                    if (candidate < distance[v]) {
+                        const bool queued = heap.Contains(v);
+                        distance[v] = candidate;
+                        parent[v] = u;
+                        if (queued) {
+                            heap.DecreaseKey(v, candidate);
+                        } else {
+                            heap.Push(v, candidate);
+                        }
+                    }
+                }
+            }
+        };
+        // 顶点数放得进 32 位时用 32 位下标, 节点更小
+        if (n < PairingHeap<Weight>::None) {
+            PairingHeap<Weight> heap(n);
+            run(heap);
+        } else {
+            PairingHeap<Weight, uint64_t> heap(n);
+            run(heap);
+        }
+    }
+}
+
+/*
+ * @function: 从 source 出发的 Dijkstra
+ * @param: target 不为 Unreached 时, target 出堆即停止 (点到点查询), 此时只有距离不超过 target 的顶点是最终结果
+ * @param: heap 选择优先队列, 基数堆要求边权为整数或 float/double
+ */
+template <typename VerTy, typename Weight>
+inline ShortestPathResult<Weight> Dijkstra(const AdjacencyList<VerTy, Weight>& graph, const uint64_t source,
+                                           const uint64_t target = Unreached,
+                                           const DijkstraHeap heap = DijkstraHeap::Auto) {
+    const uint64_t n = graph.VertexCount();
+    ShortestPathResult<Weight> result = _detail::EmptyPaths<Weight>(n);
+    if (source >= n) {
+        return result;
+    }
+    result.distance[source] = Weight{};
+    result.parent[source] = source;
+    if constexpr (_detail::RadixKeyable<Weight>) {
+        if (heap != DijkstraHeap::Pairing) {
+            _detail::RadixDijkstra(graph, source, target, result);
+            return result;
+        }
+    }
+    _detail::PairingDijkstra(graph, source, target, result);
+    return result;
+}
+
+template <typename Weight>
+struct DeltaSteppingOptions {
+    // * 桶宽, 不大于 0 时取 最大边权 / 平均度数 (Meyer & Sanders 对随机边权的建议)
+    Weight delta = Weight{};
+    // * 最多使用的线程数, 0 表示 hardware_concurrency
+    unsigned threads = 0;
+};
+
+/*
+ * @function: 并行 delta-stepping 单源最短路, 距离与 Dijkstra 相同
+ * @note: 各线程持有同一组 worker, 每处理完一个桶在 std::barrier 处同步一次, 不为每个桶创建线程
+ * @note: parent 在距离确定后由一次沿 "紧边" (dist[u] + w == dist[v]) 的遍历给出, 有零权边时也是一棵树
+ */
+template <typename VerTy, typename Weight>
+inline ShortestPathResult<Weight> DeltaStepping(const AdjacencyList<VerTy, Weight>& graph, const uint64_t source,
+                                                const DeltaSteppingOptions<Weight>& options = {}) {
+    const uint64_t n = graph.VertexCount();
+    ShortestPathResult<Weight> result = _detail::EmptyPaths<Weight>(n);
+    if (source >= n) {
+        return result;
+    }
+    auto& distance = result.distance;
+
+    Weight delta = options.delta;
+    if (!(Weight{} < delta)) {
+        auto all = graph.EdgeWeights();
+        Weight max_weight = all.empty() ? Weight{1} : *std::max_element(all.begin(), all.end());
+        double average_degree = std::max(1.0, static_cast<double>(all.size()) / static_cast<double>(n));
+        delta = static_cast<Weight>(static_cast<double>(max_weight) / average_degree);
+        if (!(Weight{} < delta)) delta = std::is_integral_v<Weight> ? Weight{1} : max_weight;
+        if (!(Weight{} < delta)) delta = Weight{1};
+    }
+    auto bin_of = [delta](const Weight d) { return static_cast<std::size_t>(d / delta); };
+
+    const unsigned workers = _detail::WorkerCount(graph.ArcCount(), 1 << 14, options.threads);
+    const bool concurrent = workers > 1;
+    distance[source] = Weight{};
+    std::vector<uint64_t> frontier {source};
+    std::vector<std::vector<std::vector<uint64_t>>> bins(workers);
+    std::size_t bin = 0;
+    bool done = false;
+    std::atomic<std::size_t> cursor {0};
+
+    // 所有线程处理完当前 frontier 后执行一次: 找到编号最小的非空桶, 把各线程的这个桶合并为新的 frontier
+    auto next_round = [&]() noexcept {
+        std::size_t next = std::numeric_limits<std::size_t>::max();
+        for (const auto& local : bins) {
+            for (std::size_t b = bin; b < local.size() && b < next; ++b) {
+                if (!local[b].empty()) {
+                    next = b;
+                    break;
+                }
+            }
+        }
+        frontier.clear();
+        cursor.store(0, std::memory_order_relaxed);
+        if (next == std::numeric_limits<std::size_t>::max()) {
+            done = true;
+            return;
+        }
+        bin = next;
+        for (auto& local : bins) {
+            if (next < local.size()) {
+                frontier.insert(frontier.end(), local[next].begin(), local[next].end());
+                local[next].clear();
+            }
+        }
+    };
+    std::barrier sync(static_cast<std::ptrdiff_t>(workers), next_round);
+
+    _detail::ParallelFor(workers, workers, [&](std::size_t, std::size_t, unsigned w) {
+        auto& local = bins[w];
+        while (!done) {
+            for (;;) {
+                const std::size_t begin = cursor.fetch_add(64, std::memory_order_relaxed);
+                if (begin >= frontier.size()) break;
+                const std::size_t end = std::min(frontier.size(), begin + 64);
+                for (std::size_t i = begin; i < end; ++i) {
+                    const uint64_t u = frontier[i];
+                    const Weight du = concurrent ? std::atomic_ref<Weight>(distance[u]).load(std::memory_order_relaxed)
+                                                 : distance[u];
+                    // 距离已经降到更早的桶, 这一项是过期的
+                    if (bin_of(du) < bin) continue;
+                    auto neighbors = graph.Neighbors(u);
+                    auto weights = graph.Weights(u);
+                    for (std::size_t k = 0; k < neighbors.size(); ++k) {
+                        const Weight candidate = du + weights[k];
+                        if (_detail::RelaxMin(distance[neighbors[k]], candidate, concurrent)) {
+                            const std::size_t target_bin = bin_of(candidate);
+                            if (target_bin >= local.size()) local.resize(target_bin + 1);
+                            local[target_bin].push_back(neighbors[k]);
+                        }
+                    }
+                }
+            }
+            sync.arrive_and_wait();
+        }
+    });
+
+    // 沿紧边从 source 遍历得到最短路树
+    auto& parent = result.parent;
+    parent[source] = source;
+    std::vector<uint64_t> queue {source};
+    for (std::size_t head = 0; head < queue.size(); ++head) {
+        const uint64_t u = queue[head];
+        auto neighbors = graph.Neighbors(u);
+        auto weights = graph.Weights(u);
+        for (std::size_t k = 0; k < neighbors.size(); ++k) {
+            const uint64_t v = neighbors[k];
+            if (parent[v] == Unreached && distance[u] + weights[k] == distance[v]) {
+                parent[v] = u;
+                queue.push_back(v);
+            }
+        }
+    }
+    return result;
+}
+
+// * GraphInstance (包括 GraphManager 中取得的图) 上直接运行, 第一次调用时构造 CSR
+template <typename VerTy, typename WeightType>
+inline ShortestPathResult<WeightType> Dijkstra(const GraphInstance<VerTy, WeightType>& graph, const uint64_t source,
+                                               const uint64_t target = Unreached,
+                                               const DijkstraHeap heap = DijkstraHeap::Auto) {
+    return Dijkstra(graph.List(), source, target, heap);
+}
+
+template <typename VerTy, typename WeightType>
+inline ShortestPathResult<WeightType> DeltaStepping(const GraphInstance<VerTy, WeightType>& graph, const uint64_t source,
+                                                    const DeltaSteppingOptions<WeightType>& options = {}) {
+    return DeltaStepping(graph.List(), source, options);
+}
+
+}
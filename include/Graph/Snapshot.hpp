@@ -0,0 +1,367 @@
+#pragma once
+/*
+ *  GraphInstance 的二进制快照: Save 写出, Open 直接 mmap, 查询就在映射上进行, 不反序列化
+ *
+ *  文件布局 (小端, 各段起点 64 字节对齐, 段之间补 0):
+ *
+ *   +-------------------------+  0
+ *   | SnapshotHeader          |  magic "MLGRAPH", 版本, 字节序, 类型大小, 顶点数/条目数/边数,
+ *   |                         |  每段的 {起点, 字节数, 校验和}, 头部自身的校验和
+ *   +-------------------------+
+ *   | present  uint64_t[]     |  顶点是否已初始化的位图, (n + 63) / 64 个字
+ *   | values   VerTy[n]       |  顶点的值, 未初始化的顶点为 VerTy()
+ *   | offsets  uint64_t[n+1]  |  CSR, 与 AdjacencyList 完全相同
+ *   | targets  uint64_t[m]    |
+ *   | weights  Weight[m]      |
+ *   +-------------------------+
+ *
+ *  Open 只读取并检查头部, 数据页在第一次访问时才由内核读入, 打开的代价与图的大小无关
+ *  各段的校验和与 CSR 结构 (offsets 单调, 目标顶点 < n) 需要读完整个文件, 所以只在 Verify() 或 SnapshotOptions::verify 时检查
+ */
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "GraphManager.hpp"
+#include "MappedFile.hpp"
+
+namespace Moonlight::Graph {
+
+inline constexpr uint32_t SnapshotVersion = 1;
+
+enum class SnapshotSection : uint32_t { Present = 0, Values, Offsets, Targets, Weights };
+inline constexpr uint32_t SnapshotSectionCount = 5;
+
+struct SnapshotHeader {
+    struct Section {
+        uint64_t offset;
+        uint64_t bytes;
+        uint64_t checksum;
+    };
+    char magic[8];
+    uint32_t version;
+    // * 写入 0x01020304, 读出的值不同说明文件来自字节序不同的机器
+    uint32_t byte_order;
+    uint32_t vertex_size;
+    uint32_t weight_size;
+    uint64_t vertex_count;
+    uint64_t arc_count;
+    uint64_t edge_count;
+    Section sections[SnapshotSectionCount];
+    // * 以上所有字节的校验和
+    uint64_t header_checksum;
+};
+static_assert(std::is_trivially_copyable_v<SnapshotHeader> && sizeof(SnapshotHeader) == 176);
+
+struct SnapshotOptions {
+    // * 打开时检查所有段的校验和 (读取整个文件)
+    bool verify = false;
+    // * 打开时请求内核提前把整个文件读入页缓存 (MADV_WILLNEED), 不阻塞
+    bool prefetch = false;
+};
+
+namespace _detail {
+
+    inline constexpr uint64_t SnapshotAlign = 64;
+    inline constexpr char SnapshotMagic[8] = {'M', 'L', 'G', 'R', 'A', 'P', 'H', '\0'};
+
+    /*
+    * @function: 64 位校验和, 采用 xxHash64 的轮函数, 4 路并行吃 32 字节, 最后做雪崩混合
+    * @note: 只用于检测损坏与截断, 与 xxHash64 的输出不兼容
+    */
+    inline uint64_t Checksum64(const void* data, const std::size_t size) noexcept {
+        constexpr uint64_t P1 = 0x9E3779B185EBCA87ULL, P2 = 0xC2B2AE3D27D4EB4FULL, P3 = 0x165667B19E3779F9ULL;
+        auto round = [](uint64_t acc, uint64_t word) { return std::rotl(acc + word * P2, 31) * P1; };
+        auto load = [](const unsigned char* p) { uint64_t word; std::memcpy(&word, p, 8); return word; };
+        const auto* p = static_cast<const unsigned char*>(data);
+        const auto* end = p + size;
+        uint64_t lanes[4] = {P1 + P2, P2, 0, 0 - P1};
+        for (; end - p >= 32; p += 32) {
+            for (int i = 0; i < 4; ++i) lanes[i] = round(lanes[i], load(p + 8 * i));
+        }
+        uint64_t hash = std::rotl(lanes[0], 1) + std::rotl(lanes[1], 7) + std::rotl(lanes[2], 12) + std::rotl(lanes[3], 18);
+        hash += size;
+        for (; end - p >= 8; p += 8) hash = std::rotl(hash ^ round(0, load(p)), 27) * P1 + P3;
+        for (; p < end; ++p) hash = std::rotl(hash ^ (*p * P3), 11) * P1;
+        hash ^= hash >> 33;
+        hash *= P2;
+        hash ^= hash >> 29;
+        hash *= P3;
+        return hash ^ (hash >> 32);
+    }
+
+    inline uint64_t HeaderChecksum(const SnapshotHeader& header) noexcept {
+        return Checksum64(&header, offsetof(SnapshotHeader, header_checksum));
+    }
+
+    // @return: 是否写满 bytes 个字节; 处理短写与 EINTR, 失败时 errno 保留
+    inline bool WriteAll(const int fd, const void* data, std::size_t bytes) noexcept {
+        const char* p = static_cast<const char*>(data);
+        while (bytes > 0) {
+            ssize_t n = ::write(fd, p, bytes);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            p += n;
+            bytes -= static_cast<std::size_t>(n);
+        }
+        return true;
+    }
+
+    /*
+    * @function: fsync path 所在的目录, 让改名这一目录项的修改也落盘
+    * @note: 有的文件系统不支持对目录 fsync (EINVAL), 此时忽略; 其他错误抛出 std::system_error
+    */
+    inline void SyncDirectory(const std::string& path) {
+        std::filesystem::path directory = std::filesystem::path(path).parent_path();
+        if (directory.empty()) directory = ".";
+        int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), "GraphSnapshot: open " + directory.string());
+        }
+        int result = ::fsync(fd);
+        int error = errno;
+        ::close(fd);
+        if (result != 0 && error != EINVAL) {
+            throw std::system_error(error, std::generic_category(), "GraphSnapshot: fsync " + directory.string());
+        }
+    }
+}
+
+/*
+ * 只读的图快照, 接口与 AdjacencyList 对齐 (Neighbors / Weights / Offsets ...), 另外提供顶点的值与边的查询
+ * 顶点与边权必须是平凡可复制的类型, 它们按内存中的表示直接写入文件
+ */
+template <typename VerTy = int, typename Weight = double>
+class GraphSnapshot {
+    static_assert(std::is_trivially_copyable_v<VerTy> && std::is_trivially_copyable_v<Weight>,
+                  "GraphSnapshot: vertex values and weights are stored by their object representation");
+    static_assert(alignof(VerTy) <= _detail::SnapshotAlign && alignof(Weight) <= _detail::SnapshotAlign);
+
+public:
+    GraphSnapshot() = default;
+    GraphSnapshot(GraphSnapshot&&) noexcept = default;
+    GraphSnapshot& operator=(GraphSnapshot&&) noexcept = default;
+
+    /*
+    * @function: 把 graph 写成快照; 先写到 path + ".tmp", fsync 后改名, 再 fsync 目录
+    *            写到一半失败或崩溃都不会破坏原来的文件
+    * @note: 通过 graph.List() 取得 CSR, 尚未合并的修改会先合并; 写失败时删除临时文件并抛出 std::system_error
+    */
+    static void Save(const GraphInstance<VerTy, Weight>& graph, const std::string& path) {
+        const auto& list = graph.List();
+        const uint64_t n = graph.VertexCount();
+        std::vector<uint64_t> present((n + 63) / 64, 0);
+        std::vector<VerTy> values(n);
+        for (uint64_t v = 0; v < n; ++v) {
+            if (const auto& value = graph.GetVertex(v)) {
+                present[v >> 6] |= uint64_t{1} << (v & 63);
+                values[v] = *value;
+            }
+        }
+        const std::span<const std::byte> payloads[SnapshotSectionCount] = {
+            std::as_bytes(std::span(present)), std::as_bytes(std::span(values)), std::as_bytes(list.Offsets()),
+            std::as_bytes(list.Targets()), std::as_bytes(list.EdgeWeights())};
+
+        SnapshotHeader header {};
+        std::memcpy(header.magic, _detail::SnapshotMagic, sizeof(header.magic));
+        header.version = SnapshotVersion;
+        header.byte_order = 0x01020304;
+        header.vertex_size = sizeof(VerTy);
+        header.weight_size = sizeof(Weight);
+        header.vertex_count = n;
+        header.arc_count = list.ArcCount();
+        header.edge_count = graph.EdgeCount();
+        uint64_t offset = AlignUp(sizeof(SnapshotHeader));
+        for (uint32_t s = 0; s < SnapshotSectionCount; ++s) {
+            header.sections[s] = {offset, payloads[s].size(), _detail::Checksum64(payloads[s].data(), payloads[s].size())};
+            offset = AlignUp(offset + payloads[s].size());
+        }
+        header.header_checksum = _detail::HeaderChecksum(header);
+
+        const std::string temp = path + ".tmp";
+        int fd = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), "GraphSnapshot: open " + temp);
+        }
+        // * 任何一步失败都关闭并删除临时文件, 原来的 path 保持不变
+        auto fail = [&](const char* step) {
+            int error = errno;
+            if (fd >= 0) ::close(fd);
+            ::unlink(temp.c_str());
+            throw std::system_error(error, std::generic_category(), std::string("GraphSnapshot: ") + step + " " + temp);
+        };
+        const char zeros[_detail::SnapshotAlign] = {};
+        uint64_t written = 0;
+        auto write = [&](const void* data, const uint64_t bytes) {
+            if (!_detail::WriteAll(fd, data, bytes)) fail("write");
+            written += bytes;
+        };
+        write(&header, sizeof(header));
+        for (uint32_t s = 0; s < SnapshotSectionCount; ++s) {
+            write(zeros, header.sections[s].offset - written);
+            write(payloads[s].data(), payloads[s].size());
+        }
+        // * 先让数据落盘再改名, 否则崩溃后改名可能已生效而数据还没写完
+        if (::fsync(fd) != 0) fail("fsync");
+        if (::close(std::exchange(fd, -1)) != 0) fail("close");
+        if (::rename(temp.c_str(), path.c_str()) != 0) fail("rename");
+        _detail::SyncDirectory(path);
+    }
+
+    /*
+    * @function: 映射快照文件, 检查头部之后立即返回
+    * @note: 文件无法打开时抛出 std::system_error; 格式 / 版本 / 类型大小不符或文件被截断时抛出 std::runtime_error
+    */
+    static GraphSnapshot Open(const std::string& path, const SnapshotOptions& options = {}) {
+        GraphSnapshot snapshot;
+        snapshot._m_file = _detail::MappedFile(path);
+        const char* data = snapshot._m_file.Data();
+        const uint64_t size = snapshot._m_file.Size();
+        auto fail = [&](const char* reason) {
+            throw std::runtime_error("GraphSnapshot: " + path + ": " + reason);
+        };
+        if (size < sizeof(SnapshotHeader)) fail("file is shorter than the header");
+        SnapshotHeader& header = snapshot._m_header;
+        std::memcpy(&header, data, sizeof(header));
+        if (std::memcmp(header.magic, _detail::SnapshotMagic, sizeof(header.magic)) != 0) fail("not a graph snapshot");
+        if (header.byte_order != 0x01020304) fail("written on a machine with a different byte order");
+        if (header.version != SnapshotVersion) fail("unsupported snapshot version");
+        if (header.header_checksum != _detail::HeaderChecksum(header)) fail("header checksum mismatch");
+        if (header.vertex_size != sizeof(VerTy) || header.weight_size != sizeof(Weight)) fail("vertex or weight type size mismatch");
+
+        const uint64_t n = header.vertex_count, m = header.arc_count;
+        // * 每个顶点在 offsets 中至少占 8 字节, 每条弧在 targets 中占 8 字节: 先用文件大小约束 n 与 m, 下面的乘法才不会溢出
+        if (n >= size / 8 || m > size / 8 || n > size / sizeof(VerTy) || m > size / sizeof(Weight)) {
+            fail("vertex or arc count exceeds the file size");
+        }
+        const uint64_t expected[SnapshotSectionCount] = {(n + 63) / 64 * 8, n * sizeof(VerTy), (n + 1) * 8, m * 8, m * sizeof(Weight)};
+        for (uint32_t s = 0; s < SnapshotSectionCount; ++s) {
+            const auto& section = header.sections[s];
+            if (section.bytes != expected[s] || section.offset % _detail::SnapshotAlign != 0 ||
+                section.offset > size || section.bytes > size - section.offset) {
+                fail("section table does not match the file");
+            }
+        }
+        auto section = [&]<typename Ty>(SnapshotSection s, std::type_identity<Ty>) {
+            const auto& entry = header.sections[static_cast<uint32_t>(s)];
+            return std::span<const Ty>(reinterpret_cast<const Ty*>(data + entry.offset), entry.bytes / sizeof(Ty));
+        };
+        snapshot._m_present = section(SnapshotSection::Present, std::type_identity<uint64_t>{});
+        snapshot._m_values = section(SnapshotSection::Values, std::type_identity<VerTy>{});
+        snapshot._m_offsets = section(SnapshotSection::Offsets, std::type_identity<uint64_t>{});
+        snapshot._m_targets = section(SnapshotSection::Targets, std::type_identity<uint64_t>{});
+        snapshot._m_weights = section(SnapshotSection::Weights, std::type_identity<Weight>{});
+        // * 只读首尾两个值, 不触及中间的页
+        if (snapshot._m_offsets.front() != 0 || snapshot._m_offsets.back() != m) fail("corrupted CSR offsets");
+
+        if (options.prefetch) {
+            snapshot._m_file.Advise(MADV_WILLNEED);
+        }
+        if (options.verify) {
+            if (!snapshot.VerifyChecksums()) fail("section checksum mismatch");
+            if (!snapshot.VerifyStructure()) fail("corrupted CSR offsets or targets");
+        }
+        return snapshot;
+    }
+
+    // @return: 所有段的校验和与头部一致, 且 CSR 结构合法; 需要读取整个文件
+    bool Verify() const noexcept {
+        return VerifyChecksums() && VerifyStructure();
+    }
+
+public:
+    uint64_t VertexCount() const noexcept {
+        return _m_header.vertex_count;
+    }
+    uint64_t ArcCount() const noexcept {
+        return _m_header.arc_count;
+    }
+    uint64_t EdgeCount() const noexcept {
+        return _m_header.edge_count;
+    }
+    // @return: 顶点 v 的值, 未初始化的顶点为 std::nullopt
+    std::optional<VerTy> Vertex(const uint64_t v) const noexcept {
+        if (v >= VertexCount() || !(_m_present[v >> 6] >> (v & 63) & 1)) {
+            return std::nullopt;
+        }
+        return _m_values[v];
+    }
+    uint64_t Degree(const uint64_t v) const noexcept {
+        return _m_offsets[v + 1] - _m_offsets[v];
+    }
+    std::span<const uint64_t> Neighbors(const uint64_t v) const noexcept {
+        return _m_targets.subspan(_m_offsets[v], Degree(v));
+    }
+    std::span<const Weight> Weights(const uint64_t v) const noexcept {
+        return _m_weights.subspan(_m_offsets[v], Degree(v));
+    }
+    // @return: 边 {u, v} 的权重, 不存在时为 std::nullopt; 在 u 的有序邻居中二分查找
+    std::optional<Weight> EdgeWeight(const uint64_t u, const uint64_t v) const noexcept {
+        if (u >= VertexCount()) {
+            return std::nullopt;
+        }
+        auto neighbors = Neighbors(u);
+        auto it = std::lower_bound(neighbors.begin(), neighbors.end(), v);
+        if (it == neighbors.end() || *it != v) {
+            return std::nullopt;
+        }
+        return Weights(u)[static_cast<std::size_t>(it - neighbors.begin())];
+    }
+    bool HasEdge(const uint64_t u, const uint64_t v) const noexcept {
+        return EdgeWeight(u, v).has_value();
+    }
+    std::span<const uint64_t> Offsets() const noexcept { return _m_offsets; }
+    std::span<const uint64_t> Targets() const noexcept { return _m_targets; }
+    std::span<const Weight> EdgeWeights() const noexcept { return _m_weights; }
+
+private:
+    static constexpr uint64_t AlignUp(const uint64_t offset) noexcept {
+        return (offset + _detail::SnapshotAlign - 1) / _detail::SnapshotAlign * _detail::SnapshotAlign;
+    }
+    bool VerifyChecksums() const noexcept {
+        for (uint32_t s = 0; s < SnapshotSectionCount; ++s) {
+            const auto& section = _m_header.sections[s];
+            if (_detail::Checksum64(_m_file.Data() + section.offset, section.bytes) != section.checksum) {
+                return false;
+            }
+        }
+        return true;
+    }
+    // * 校验和只能发现意外损坏; 这里保证 Neighbors / Degree 的下标与 Vertex(target) 不会越界
+    bool VerifyStructure() const noexcept {
+        if (!std::ranges::is_sorted(_m_offsets)) {
+            return false;
+        }
+        const uint64_t n = VertexCount();
+        return std::ranges::all_of(_m_targets, [n](const uint64_t target) { return target < n; });
+    }
+
+private:
+    _detail::MappedFile _m_file;
+    SnapshotHeader _m_header {};
+    std::span<const uint64_t> _m_present;
+    std::span<const VerTy> _m_values;
+    std::span<const uint64_t> _m_offsets;
+    std::span<const uint64_t> _m_targets;
+    std::span<const Weight> _m_weights;
+};
+
+}
@@ -0,0 +1,359 @@
+#pragma once
+/*
+ *  读多写少的并发红黑树:
+ *  1. 写者之间用互斥锁串行, 每次写入用路径复制 (PathCopy.hpp) 生成新版本, 再原子地发布新根
+ *  2. 读者不加锁: 进入 epoch 后读一次根指针, 之后访问的节点在本次读取期间都不会被修改或释放
+ *  3. 被新版本替换掉的节点挂到退休链表上, 等所有可能看到它们的读者离开后才真正释放 (epoch-based reclamation)
+ *
+ *       writer:  root' = PathCopy(root)  ->  publish root'  ->  retire(old path, e)  ->  epoch = e + 1
+ *       reader:  announce(epoch)  ->  load root  ->  ...  ->  announce(0)
+ *       free:    退休时 epoch 为 e 的节点, 在所有活跃读者宣告的 epoch 都 > e 之后释放
+ */
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "RBTree.hpp"
+#include "PathCopy.hpp"
+
+namespace RBTreeTools {
+
+    /*
+    * @function: epoch 宣告表, 每个线程占一个缓存行对齐的槽位
+    * @note: 槽位表按块追加增长, 不限制线程数; 块一经发布就不再移动或释放, 读者拿到的槽位地址始终有效
+    * @note: 线程退出时归还编号, 之后创建的线程复用它, 所以表的大小只取决于同时存在的线程数
+    */
+    class EpochDomain {
+    public:
+        static constexpr std::uint64_t Inactive = 0;
+
+        EpochDomain() = default;
+        EpochDomain(const EpochDomain&) = delete;
+        EpochDomain& operator=(const EpochDomain&) = delete;
+        ~EpochDomain() {
+            for (auto& chunk : _m_chunks) {
+                delete[] chunk.load(std::memory_order_relaxed);
+            }
+        }
+
+        // @function: 读者进入临界区, 可嵌套
+        void Enter() noexcept {
+            Slot& slot = SlotOf(ThreadIndex());
+            if (slot.depth++ == 0) {
+                // * seq_cst: 宣告必须先于之后对根指针的读取被写者看到
+                slot.epoch.store(_m_epoch.load(std::memory_order_acquire), std::memory_order_seq_cst);
+            }
+        }
+        void Exit() noexcept {
+            Slot& slot = SlotOf(ThreadIndex());
+            if (--slot.depth == 0) {
+                slot.epoch.store(Inactive, std::memory_order_release);
+            }
+        }
+
+        std::uint64_t Current() const noexcept {
+            return _m_epoch.load(std::memory_order_relaxed);
+        }
+        // @function: 写者发布新版本后推进 epoch, 只能由持有写锁的线程调用
+        void Advance() noexcept {
+            _m_epoch.fetch_add(1, std::memory_order_seq_cst);
+        }
+
+        // @return: 所有活跃读者宣告的最小 epoch, 没有活跃读者时为当前 epoch; 小于它的退休节点可以释放
+        std::uint64_t Oldest() const noexcept {
+            std::uint64_t oldest = Current();
+            for (std::size_t c = 0; c < MaxChunks; ++c) {
+                // * seq_cst: 新块的发布与其中的宣告都在读者读取根指针之前, 写者若没看到块, 读者必然看到了新根
+                const Slot* chunk = _m_chunks[c].load(std::memory_order_seq_cst);
+                if (!chunk) {
+                    break;
+                }
+                for (std::size_t i = 0; i < ChunkCapacity(c); ++i) {
+                    std::uint64_t epoch = chunk[i].epoch.load(std::memory_order_seq_cst);
+                    if (epoch != Inactive && epoch < oldest) {
+                        oldest = epoch;
+                    }
+                }
+            }
+            return oldest;
+        }
+
+    private:
+        struct alignas(64) Slot {
+            std::atomic<std::uint64_t> epoch {Inactive};
+            std::size_t depth {0};  // * 只被所属线程访问
+        };
+
+        // * 第 c 块有 FirstChunk << c 个槽位, 块 c 覆盖编号 [FirstChunk * (2^c - 1), FirstChunk * (2^(c+1) - 1))
+        static constexpr std::size_t FirstChunk = 64;
+        static constexpr std::size_t MaxChunks = std::numeric_limits<std::size_t>::digits - 6;
+
+        static constexpr std::size_t ChunkCapacity(std::size_t c) noexcept {
+            return FirstChunk << c;
+        }
+
+        // * epoch 从 1 开始, 0 表示槽位空闲
+        std::atomic<std::uint64_t> _m_epoch {1};
+        std::atomic<Slot*> _m_chunks[MaxChunks] {};
+
+        // @function: 编号对应的槽位, 所在的块还不存在时分配并用 CAS 发布; 并发发布时败者释放自己的块
+        Slot& SlotOf(std::size_t index) noexcept {
+            const std::size_t c = static_cast<std::size_t>(std::bit_width(index / FirstChunk + 1)) - 1;
+            const std::size_t offset = index - FirstChunk * ((std::size_t(1) << c) - 1);
+            Slot* chunk = _m_chunks[c].load(std::memory_order_acquire);
+            if (!chunk) {
+                // * 分配失败时无法安全地宣告 epoch
+                Slot* fresh = new Slot[ChunkCapacity(c)];
+                if (_m_chunks[c].compare_exchange_strong(chunk, fresh, std::memory_order_seq_cst)) {
+                    chunk = fresh;
+                } else {
+                    delete[] fresh;
+                }
+            }
+            return chunk[offset];
+        }
+
+    private:
+        // * 所有 EpochDomain 共用一套线程编号; 编号只在线程创建与退出时分配 / 归还, 用互斥锁即可
+        struct ThreadRegistry {
+            std::mutex lock;
+            std::vector<std::size_t> released;
+            std::size_t next = 0;
+        };
+        struct ThreadIndexHolder {
+            std::size_t index;
+            ThreadIndexHolder() {
+                ThreadRegistry& registry = Registry();
+                std::lock_guard guard(registry.lock);
+                if (registry.released.empty()) {
+                    index = registry.next++;
+                } else {
+                    index = registry.released.back();
+                    registry.released.pop_back();
+                }
+                // * 预留到编号总数, 析构时的 push_back 不会再分配内存
+                registry.released.reserve(registry.next);
+            }
+            ~ThreadIndexHolder() {
+                ThreadRegistry& registry = Registry();
+                std::lock_guard guard(registry.lock);
+                registry.released.push_back(index);
+            }
+        };
+        static ThreadRegistry& Registry() noexcept {
+            static ThreadRegistry registry;
+            return registry;
+        }
+        static std::size_t ThreadIndex() noexcept {
+            thread_local ThreadIndexHolder holder;
+            return holder.index;
+        }
+    };
+}
+
+/*
+* @function: 无锁读, 串行写的红黑树
+* @note: 节点为 RBTreeTools::PathCopyNode<Ty>, 发布后只读, 所以读者拿到的总是某个完整版本
+* @note: 析构时不得有并发访问
+*/
+template <typename Ty, class Alloc = std::allocator<RBTreeTools::PathCopyNode<Ty>>>
+class ConcurrentRBTree {
+public:
+    using value_type = Ty;
+    using allocator_type = Alloc;
+    using node_type = typename std::allocator_traits<Alloc>::value_type;
+
+    /*
+    * @function: 读者守卫, 存活期间 Root() 指向的版本不会被释放
+    * @note: 需要在同一个版本上做多次查询时使用, 例如先 Find 再遍历
+    */
+    class ReadGuard {
+    public:
+        explicit ReadGuard(const ConcurrentRBTree& tree) noexcept : _m_domain(&tree._m_domain) {
+            _m_domain->Enter();
+            _m_root = tree._m_root.load(std::memory_order_seq_cst);
+        }
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+        ~ReadGuard() {
+            _m_domain->Exit();
+        }
+
+        const node_type* Root() const noexcept {
+            return _m_root;
+        }
+        bool Contains(const Ty& val) const {
+            return RBTreeTools::PathCopyFind(_m_root, val) != nullptr;
+        }
+        // @function: 中序访问该版本中的所有值
+        template <typename Visitor>
+        void ForEach(Visitor&& visit) const {
+            ForEach(_m_root, visit);
+        }
+
+    private:
+        RBTreeTools::EpochDomain* _m_domain;
+        const node_type* _m_root;
+
+        template <typename Visitor>
+        static void ForEach(const node_type* node, Visitor& visit) {
+            while (node) {
+                ForEach(node->left, visit);
+                visit(node->val);
+                node = node->right;
+            }
+        }
+    };
+
+public:
+    ConcurrentRBTree() = default;
+    explicit ConcurrentRBTree(const Alloc& alloc) : _m_alloc(alloc) {}
+    ConcurrentRBTree(const ConcurrentRBTree&) = delete;
+    ConcurrentRBTree& operator=(const ConcurrentRBTree&) = delete;
+    ~ConcurrentRBTree() {
+        DestroyTree(_m_root.load(std::memory_order_relaxed));
+        for (auto& [epoch, node] : _m_retired) {
+            FreeNode(node);
+        }
+    }
+
+    ReadGuard Read() const noexcept {
+        return ReadGuard(*this);
+    }
+
+    bool Contains(const Ty& val) const {
+        return Read().Contains(val);
+    }
+
+    // @return: 找到时返回值的拷贝; 节点指针离开守卫后不再安全, 所以不返回节点
+    std::optional<Ty> Find(const Ty& val) const {
+        ReadGuard guard(*this);
+        const node_type* node = RBTreeTools::PathCopyFind(guard.Root(), val);
+        return node ? std::optional<Ty>(node->val) : std::nullopt;
+    }
+
+    std::size_t Size() const noexcept {
+        return _m_size.load(std::memory_order_relaxed);
+    }
+
+    // @return: val 不存在并已插入时返回 true
+    template <typename U>
+    bool Insert(U&& val) {
+        std::lock_guard<std::mutex> lock(_m_write_mutex);
+        WritePolicy policy{*this, _m_domain.Current()};
+        node_type* root = _m_root.load(std::memory_order_relaxed);
+        node_type* new_root = RBTreeTools::PathCopyInsert(root, std::forward<U>(val), policy);
+        if (new_root == root) {
+            return false;
+        }
+        Publish(new_root);
+        _m_size.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // @return: val 存在并已删除时返回 true
+    bool Erase(const Ty& val) {
+        std::lock_guard<std::mutex> lock(_m_write_mutex);
+        WritePolicy policy{*this, _m_domain.Current()};
+        node_type* root = _m_root.load(std::memory_order_relaxed);
+        node_type* new_root = RBTreeTools::PathCopyErase(root, val, policy);
+        if (new_root == root) {
+            return false;
+        }
+        Publish(new_root);
+        _m_size.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // @function: 立即尝试回收退休节点, 返回仍在等待的节点数
+    std::size_t Reclaim() {
+        std::lock_guard<std::mutex> lock(_m_write_mutex);
+        ReclaimRetired();
+        return _m_retired.size();
+    }
+
+    Alloc GetAllocator() const {
+        return _m_alloc;
+    }
+
+private:
+    using AllocTraits = std::allocator_traits<Alloc>;
+    // * 退休节点累积到这个数量后才扫描一次宣告表
+    static constexpr std::size_t ReclaimThreshold = 1024;
+
+    struct WritePolicy {
+        ConcurrentRBTree& tree;
+        std::uint64_t epoch;
+
+        template <typename U>
+        node_type* Create(U&& val) {
+            return tree.NewNode(std::forward<U>(val), RBTreeTools::Color::Red, nullptr, nullptr);
+        }
+        node_type* Clone(const node_type* node) {
+            return tree.NewNode(node->val, node->color, node->left, node->right);
+        }
+        void Retire(node_type* node) {
+            tree._m_retired.emplace_back(epoch, node);
+        }
+        void Destroy(node_type* node) {
+            tree.FreeNode(node);
+        }
+    };
+
+    std::atomic<node_type*> _m_root {nullptr};
+    std::atomic<std::size_t> _m_size {0};
+    mutable RBTreeTools::EpochDomain _m_domain;
+    std::mutex _m_write_mutex;
+    std::vector<std::pair<std::uint64_t, node_type*>> _m_retired;
+    [[no_unique_address]] Alloc _m_alloc;
+
+private:
+    template <typename... Args>
+    node_type* NewNode(Args&&... args) {
+        node_type* node = AllocTraits::allocate(_m_alloc, 1);
+        AllocTraits::construct(_m_alloc, node, std::forward<Args>(args)...);
+        return node;
+    }
+    void FreeNode(node_type* node) {
+        AllocTraits::destroy(_m_alloc, node);
+        AllocTraits::deallocate(_m_alloc, node, 1);
+    }
+    void DestroyTree(node_type* node) {
+        while (node) {
+            DestroyTree(node->left);
+            node_type* right = node->right;
+            FreeNode(node);
+            node = right;
+        }
+    }
+
+    // @function: 发布新根后推进 epoch, 这样之后进入的读者一定看到新版本
+    void Publish(node_type* new_root) {
+        _m_root.store(new_root, std::memory_order_seq_cst);
+        _m_domain.Advance();
+        if (_m_retired.size() >= ReclaimThreshold) {
+            ReclaimRetired();
+        }
+    }
+
+    void ReclaimRetired() {
+        std::uint64_t oldest = _m_domain.Oldest();
+        std::size_t kept = 0;
+        for (auto& entry : _m_retired) {
+            if (entry.first < oldest) {
+                FreeNode(entry.second);
+            } else {
+                _m_retired[kept++] = entry;
+            }
+        }
+        _m_retired.resize(kept);
+    }
+};
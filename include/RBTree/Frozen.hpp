@@ -0,0 +1,260 @@
+#pragma once
+/*
+ *  只读的 Eytzinger (BFS 序) 快照:
+ *  建好之后只查询的树, 用一块按层序排列的连续数组代替指针树
+ *    - 下标 k 的左右孩子为 2k 与 2k+1 (下标从 1 开始), 不存任何指针, 每个元素只占 sizeof(Ty)
+ *    - 查找时每层只做一次比较并把结果直接并入下标: k = 2k + (a[k] < key), 循环体中没有分支
+ *    - 数组按缓存行对齐, 下标 16k..16k+15 (int) 正好是一条缓存行, 即 k 往下第 4 层的全部后代,
+ *      每一步预取这条缓存行, 访存延迟被之后的 4 层比较覆盖
+ *
+ *         sorted:  1 2 3 4 5 6 7            [1]=4
+ *         layout:  _ 4 2 6 1 3 5 7       [2]=2    [3]=6
+ *                                      [4]=1 [5]=3 [6]=5 [7]=7
+ *
+ *  Freeze(tree) 由 RBTree 中序 O(n) 生成快照, Thaw<Alloc>() 再 O(n) 建回可修改的 RBTree
+ */
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "RBTree.hpp"
+
+template <typename Ty, class Compare = std::less<Ty>>
+class FrozenRBTree {
+public:
+    using value_type = Ty;
+    using key_compare = Compare;
+
+    static constexpr std::size_t CacheLine = 64;
+    // * 每步预取 k * PrefetchStride 处的缓存行, 即往下 log2(PrefetchStride) 层的后代
+    static constexpr std::size_t PrefetchStride = std::max<std::size_t>(1, CacheLine / sizeof(Ty));
+
+    FrozenRBTree() = default;
+    explicit FrozenRBTree(const Compare& comp) : _m_comp(comp) {}
+
+    /*
+    * @function: 由严格递增的序列 O(n) 生成快照
+    * @param: [first, last) 按 comp 严格递增
+    * @note: 元素的拷贝抛出异常时, 已经构造的元素被析构, 数组被释放, 异常继续向外传播
+    */
+    template <std::forward_iterator It>
+    FrozenRBTree(It first, It last, const Compare& comp = Compare()) : _m_comp(comp) {
+        Allocate(static_cast<std::size_t>(std::distance(first, last)));
+        std::size_t built = 0;
+        try {
+            Fill(1, first, built);
+        } catch (...) {
+            DestroyInOrder(1, built);
+            Deallocate();
+            throw;
+        }
+    }
+
+    FrozenRBTree(const FrozenRBTree& other) : _m_comp(other._m_comp) {
+        Allocate(other._m_size);
+        std::size_t k = 1;
+        try {
+            for (; k <= _m_size; ++k) {
+                ::new (static_cast<void*>(_m_data + k)) Ty(other._m_data[k]);
+            }
+        } catch (...) {
+            while (--k >= 1) {
+                _m_data[k].~Ty();
+            }
+            Deallocate();
+            throw;
+        }
+    }
+    FrozenRBTree(FrozenRBTree&& other) noexcept
+        : _m_data(std::exchange(other._m_data, nullptr)), _m_size(std::exchange(other._m_size, 0)),
+          _m_comp(std::move(other._m_comp)) {}
+    FrozenRBTree& operator=(FrozenRBTree other) noexcept {
+        std::swap(_m_data, other._m_data);
+        std::swap(_m_size, other._m_size);
+        std::swap(_m_comp, other._m_comp);
+        return *this;
+    }
+    ~FrozenRBTree() {
+        Release();
+    }
+
+    /*
+    * @function: 第一个不小于 val 的元素
+    * @return: 不存在时返回 nullptr
+    */
+    template <typename Key = Ty>
+    const Ty* LowerBound(const Key& val) const {
+        std::size_t k = Descend([&](const Ty& here) { return _m_comp(here, val); });
+        return k ? _m_data + k : nullptr;
+    }
+    // @return: 第一个大于 val 的元素, 不存在时返回 nullptr
+    template <typename Key = Ty>
+    const Ty* UpperBound(const Key& val) const {
+        std::size_t k = Descend([&](const Ty& here) { return !_m_comp(val, here); });
+        return k ? _m_data + k : nullptr;
+    }
+    // @return: 等于 val 的元素, 不存在时返回 nullptr
+    template <typename Key = Ty>
+    const Ty* Find(const Key& val) const {
+        const Ty* lower = LowerBound(val);
+        return lower && !_m_comp(val, *lower) ? lower : nullptr;
+    }
+    template <typename Key = Ty>
+    bool Contains(const Key& val) const {
+        return Find(val) != nullptr;
+    }
+
+    // @function: 按 comp 的顺序访问所有元素
+    template <typename Visitor>
+    void ForEach(Visitor&& visit) const {
+        ForEach(1, visit);
+    }
+
+    /*
+    * @function: 导出为可修改的 RBTree, O(n)
+    */
+    template <class Alloc = std::allocator<RBTreeTools::RBNode<Ty>>>
+    RBTree<Ty, Alloc, Compare> Thaw(const Alloc& alloc = Alloc()) const {
+        std::vector<Ty> sorted;
+        sorted.reserve(_m_size);
+        ForEach([&](const Ty& val) { sorted.push_back(val); });
+        RBTree<Ty, Alloc, Compare> tree(_m_comp, alloc);
+        tree.BuildFromSorted(sorted.begin(), sorted.end());
+        return tree;
+    }
+
+    std::size_t Size() const noexcept {
+        return _m_size;
+    }
+    bool Empty() const noexcept {
+        return _m_size == 0;
+    }
+    // * Eytzinger 序的原始数组, 下标 1..Size()
+    const Ty* Data() const noexcept {
+        return _m_data;
+    }
+    key_compare key_comp() const {
+        return _m_comp;
+    }
+
+private:
+    static constexpr std::align_val_t Alignment {std::max(CacheLine, alignof(Ty))};
+
+    Ty* _m_data {nullptr};  // * _m_data[0] 不使用, 只为让下标从 1 开始
+    std::size_t _m_size {0};
+    [[no_unique_address]] Compare _m_comp {};
+
+private:
+    void Allocate(std::size_t n) {
+        _m_size = n;
+        if (n) {
+            _m_data = static_cast<Ty*>(::operator new(sizeof(Ty) * (n + 1), Alignment));
+        }
+    }
+    void Release() noexcept {
+        if (!_m_data) {
+            return;
+        }
+        for (std::size_t k = 1; k <= _m_size; ++k) {
+            _m_data[k].~Ty();
+        }
+        Deallocate();
+    }
+    // @function: 只释放数组, 不析构元素
+    void Deallocate() noexcept {
+        if (_m_data) {
+            ::operator delete(_m_data, Alignment);
+        }
+        _m_data = nullptr;
+        _m_size = 0;
+    }
+
+    /*
+    * @function: 中序遍历隐式树, 把有序序列依次放到各自的层序位置
+    * @param: built 已经构造的元素个数, 抛出异常时交给 DestroyInOrder 回滚
+    */
+    template <typename It>
+    void Fill(std::size_t k, It& next, std::size_t& built) {
+        if (k > _m_size) {
+            return;
+        }
+        Fill(2 * k, next, built);
+        ::new (static_cast<void*>(_m_data + k)) Ty(*next);
+        ++built;
+        ++next;
+        Fill(2 * k + 1, next, built);
+    }
+    // @function: 按 Fill 的顺序析构前 remaining 个元素
+    void DestroyInOrder(std::size_t k, std::size_t& remaining) noexcept {
+        if (k > _m_size || remaining == 0) {
+            return;
+        }
+        DestroyInOrder(2 * k, remaining);
+        if (remaining == 0) {
+            return;
+        }
+        _m_data[k].~Ty();
+        --remaining;
+        DestroyInOrder(2 * k + 1, remaining);
+    }
+
+    template <typename Visitor>
+    void ForEach(std::size_t k, Visitor& visit) const {
+        if (k > _m_size) {
+            return;
+        }
+        ForEach(2 * k, visit);
+        visit(_m_data[k]);
+        ForEach(2 * k + 1, visit);
+    }
+
+    /*
+    * @function: 无分支下降, go_right(x) 为真时进入右子树
+    * @note: 走出数组后, k 的二进制中末尾连续的 1 是最后一次向左之后向右走的步数,
+    * @note: 去掉这些 1 以及最后一次向左的那一位, 剩下的就是最后一个向左走的节点, 即答案; 从未向左走时为 0
+    */
+    template <typename GoRight>
+    std::size_t Descend(GoRight&& go_right) const {
+        std::size_t k = 1;
+        const auto base = reinterpret_cast<std::uintptr_t>(_m_data);
+        while (k <= _m_size) {
+            // * 预取只是提示, 地址越过数组末尾也不会出错; 用整数运算避免越界指针
+        #if defined(__GNUC__) || defined(__clang__)
+            __builtin_prefetch(reinterpret_cast<const void*>(base + k * PrefetchStride * sizeof(Ty)));
+        #endif
+            k = 2 * k + static_cast<std::size_t>(go_right(_m_data[k]));
+        }
+        return k >> (std::countr_one(k) + 1);
+    }
+};
+
+namespace RBTreeTools {
+
+    /*
+    * @function: 把以 root 为根的树冻结为 Eytzinger 快照, O(n)
+    * @param: comp 与建树时相同的比较器
+    */
+    template <TreeNode NodeTp, typename Compare = std::less<typename NodeTp::value_type>>
+    inline static FrozenRBTree<typename NodeTp::value_type, Compare> Freeze(NodeTp* root, const Compare& comp = Compare()) {
+        std::vector<typename NodeTp::value_type> sorted;
+        if (root) {
+            Traversal<NodeTp>(root, [&](NodeTp* node) {
+                sorted.push_back(node->val);
+            });
+        }
+        return FrozenRBTree<typename NodeTp::value_type, Compare>(sorted.begin(), sorted.end(), comp);
+    }
+
+    template <typename Ty, class Alloc, class Compare>
+    inline static FrozenRBTree<Ty, Compare> Freeze(const RBTree<Ty, Alloc, Compare>& tree) {
+        return Freeze(tree.Root(), tree.key_comp());
+    }
+}
@@ -0,0 +1,309 @@
+#pragma once
+/*
+ *  下标链接的红黑树: 所有节点连续存放在一个 std::vector 中, 孩子/父节点用 32 位下标表示
+ *  颜色放在父下标的最高位, 因此最多容纳 2^31 - 1 个节点
+ *
+ *  IndexedRBNode<int>: left(4) + right(4) + parent|color(4) + val(4) = 16 bytes
+ *  RBNode<int>:        val(4) + color(4) + 3 * ptr(24)              = 32 bytes (malloc 后占 48)
+ *
+ *  节点之间没有指针, Ty 可平凡复制时整个 Nodes() 可以直接 memcpy 或原样写盘,
+ *  读回后用 IndexedRBTree(nodes, root) 恢复
+ *  节点只增不删, 扩容时所有下标保持不变
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "RBTree.hpp"
+
+namespace RBTreeTools {
+
+    template <typename Ty>
+    struct IndexedRBNode {
+        using value_type = Ty;
+        using index_type = std::uint32_t;
+
+        index_type left;
+        index_type right;
+        index_type parent_color;  // * 低 31 位为父下标, 最高位为 1 表示黑色
+        Ty val;
+    };
+}
+
+template <typename Ty, class Compare = std::less<Ty>>
+class IndexedRBTree {
+public:
+    using value_type = Ty;
+    using node_type = RBTreeTools::IndexedRBNode<Ty>;
+    using index_type = typename node_type::index_type;
+    using key_compare = Compare;
+
+    // * NIL 下标, 同时也是父下标字段能表示的最大值
+    static constexpr index_type Nil = 0x7FFFFFFFu;
+
+    IndexedRBTree() = default;
+    explicit IndexedRBTree(const Compare& comp) : _m_comp(comp) {}
+    // @function: 由 Nodes()/RootIndex() 导出的数据恢复一棵树, 不做任何校验
+    IndexedRBTree(std::vector<node_type> nodes, index_type root, const Compare& comp = Compare())
+        : _m_nodes(std::move(nodes)), _m_root(root), _m_comp(comp) {}
+
+    /*
+    * @function: 插入 val
+    * @return: 新节点的下标; 值已存在时返回已有节点的下标
+    */
+    template <typename U>
+    index_type Insert(U&& val) {
+        index_type parent = Nil;
+        index_type current = _m_root;
+        bool go_left = false;
+        while (current != Nil) {
+            parent = current;
+            const Ty& here = _m_nodes[current].val;
+            if (_m_comp(val, here)) {
+                go_left = true;
+                current = _m_nodes[current].left;
+            } else if (_m_comp(here, val)) {
+                go_left = false;
+                current = _m_nodes[current].right;
+            } else {
+                return current;
+            }
+        }
+        if (_m_nodes.size() >= Nil) [[unlikely]] {
+            throw std::length_error("IndexedRBTree: too many nodes for 31-bit indices");
+        }
+        // push_back 可能使引用失效, 之后只通过下标访问
+        index_type node = static_cast<index_type>(_m_nodes.size());
+        _m_nodes.push_back(node_type{Nil, Nil, parent, Ty(std::forward<U>(val))});
+        if (parent == Nil) {
+            _m_root = node;
+        } else if (go_left) {
+            _m_nodes[parent].left = node;
+        } else {
+            _m_nodes[parent].right = node;
+        }
+        InsertFixup(node);
+        return node;
+    }
+
+    // @return: 值为 val 的节点下标, 不存在时返回 Nil
+    template <typename Key = Ty>
+    index_type Find(const Key& val) const {
+        index_type current = _m_root;
+        while (current != Nil) {
+            const Ty& here = _m_nodes[current].val;
+            if (_m_comp(val, here)) {
+                current = _m_nodes[current].left;
+            } else if (_m_comp(here, val)) {
+                current = _m_nodes[current].right;
+            } else {
+                return current;
+            }
+        }
+        return Nil;
+    }
+    template <typename Key = Ty>
+    bool Contains(const Key& val) const {
+        return Find(val) != Nil;
+    }
+
+    // @return: 第一个不小于 val 的节点下标, 不存在时返回 Nil
+    template <typename Key = Ty>
+    index_type LowerBound(const Key& val) const {
+        index_type result = Nil;
+        for (index_type current = _m_root; current != Nil; ) {
+            if (_m_comp(_m_nodes[current].val, val)) {
+                current = _m_nodes[current].right;
+            } else {
+                result = current;
+                current = _m_nodes[current].left;
+            }
+        }
+        return result;
+    }
+    // @return: 第一个大于 val 的节点下标, 不存在时返回 Nil
+    template <typename Key = Ty>
+    index_type UpperBound(const Key& val) const {
+        index_type result = Nil;
+        for (index_type current = _m_root; current != Nil; ) {
+            if (_m_comp(val, _m_nodes[current].val)) {
+                result = current;
+                current = _m_nodes[current].left;
+            } else {
+                current = _m_nodes[current].right;
+            }
+        }
+        return result;
+    }
+
+    // @function: 中序访问所有值, 沿父下标回溯, 不申请任何内存
+    template <typename Visitor>
+    void Traversal(Visitor&& visit) const {
+        for (index_type node = Minimum(_m_root); node != Nil; node = Successor(node)) {
+            visit(_m_nodes[node].val);
+        }
+    }
+
+    const Ty& Value(index_type node) const noexcept {
+        return _m_nodes[node].val;
+    }
+    index_type Left(index_type node) const noexcept {
+        return _m_nodes[node].left;
+    }
+    index_type Right(index_type node) const noexcept {
+        return _m_nodes[node].right;
+    }
+    index_type Parent(index_type node) const noexcept {
+        return _m_nodes[node].parent_color & Nil;
+    }
+    // @note: NIL 视为黑色
+    RBTreeTools::Color ColorOf(index_type node) const noexcept {
+        return node == Nil || (_m_nodes[node].parent_color & BlackBit)
+            ? RBTreeTools::Color::Black : RBTreeTools::Color::Red;
+    }
+
+    index_type RootIndex() const noexcept {
+        return _m_root;
+    }
+    // * 连续存放的全部节点, 与 RootIndex() 一起即可完整描述这棵树
+    const std::vector<node_type>& Nodes() const noexcept {
+        return _m_nodes;
+    }
+    std::size_t Size() const noexcept {
+        return _m_nodes.size();
+    }
+    bool Empty() const noexcept {
+        return _m_nodes.empty();
+    }
+    void Reserve(std::size_t n) {
+        _m_nodes.reserve(n);
+    }
+    void Clear() noexcept {
+        _m_nodes.clear();
+        _m_root = Nil;
+    }
+    key_compare key_comp() const {
+        return _m_comp;
+    }
+
+private:
+    static constexpr index_type BlackBit = 0x80000000u;
+
+    std::vector<node_type> _m_nodes;
+    index_type _m_root {Nil};
+    [[no_unique_address]] Compare _m_comp {};
+
+private:
+    void SetParent(index_type node, index_type parent) noexcept {
+        index_type& field = _m_nodes[node].parent_color;
+        field = (field & BlackBit) | parent;
+    }
+    void SetColor(index_type node, RBTreeTools::Color color) noexcept {
+        index_type& field = _m_nodes[node].parent_color;
+        field = color == RBTreeTools::Color::Black ? (field | BlackBit) : (field & Nil);
+    }
+
+    index_type Minimum(index_type node) const noexcept {
+        while (node != Nil && _m_nodes[node].left != Nil) {
+            node = _m_nodes[node].left;
+        }
+        return node;
+    }
+    index_type Successor(index_type node) const noexcept {
+        if (_m_nodes[node].right != Nil) {
+            return Minimum(_m_nodes[node].right);
+        }
+        index_type parent = Parent(node);
+        while (parent != Nil && node == _m_nodes[parent].right) {
+            node = parent;
+            parent = Parent(parent);
+        }
+        return parent;
+    }
+
+    // @function: 把 x 的 parent 中指向 x 的位置换成 y
+    void ReplaceChild(index_type parent, index_type x, index_type y) noexcept {
+        if (parent == Nil) {
+            _m_root = y;
+        } else if (_m_nodes[parent].left == x) {
+            _m_nodes[parent].left = y;
+        } else {
+            _m_nodes[parent].right = y;
+        }
+    }
+
+    // * 旋转与 RBTreeTools::LeftRotate/RightRotate 相同, 只是指针换成了下标
+    void LeftRotate(index_type x) noexcept {
+        index_type y = _m_nodes[x].right;
+        index_type b = _m_nodes[y].left;
+        _m_nodes[x].right = b;
+        if (b != Nil) SetParent(b, x);
+        index_type parent = Parent(x);
+        SetParent(y, parent);
+        ReplaceChild(parent, x, y);
+        _m_nodes[y].left = x;
+        SetParent(x, y);
+    }
+    void RightRotate(index_type x) noexcept {
+        index_type y = _m_nodes[x].left;
+        index_type b = _m_nodes[y].right;
+        _m_nodes[x].left = b;
+        if (b != Nil) SetParent(b, x);
+        index_type parent = Parent(x);
+        SetParent(y, parent);
+        ReplaceChild(parent, x, y);
+        _m_nodes[y].right = x;
+        SetParent(x, y);
+    }
+
+    // * 与 RBTreeTools::InsertFixup 的四种情况一一对应
+    void InsertFixup(index_type node) noexcept {
+        using RBTreeTools::Color;
+        while (node != _m_root && ColorOf(Parent(node)) == Color::Red) {
+            index_type parent = Parent(node);
+            index_type grand = Parent(parent);
+            if (parent == _m_nodes[grand].left) {
+                index_type uncle = _m_nodes[grand].right;
+                if (ColorOf(uncle) == Color::Red) {
+                    // Case 1: uncle is red
+                    SetColor(parent, Color::Black);
+                    SetColor(uncle, Color::Black);
+                    SetColor(grand, Color::Red);
+                    node = grand;
+                } else {
+                    if (node == _m_nodes[parent].right) {
+                        // Case 2: triangle
+                        node = parent;
+                        LeftRotate(node);
+                    }
+                    // Case 3: line
+                    SetColor(Parent(node), Color::Black);
+                    SetColor(grand, Color::Red);
+                    RightRotate(grand);
+                }
+            } else {
+                // Mirror version
+                index_type uncle = _m_nodes[grand].left;
+                if (ColorOf(uncle) == Color::Red) {
+                    SetColor(parent, Color::Black);
+                    SetColor(uncle, Color::Black);
+                    SetColor(grand, Color::Red);
+                    node = grand;
+                } else {
+                    if (node == _m_nodes[parent].left) {
+                        node = parent;
+                        RightRotate(node);
+                    }
+                    SetColor(Parent(node), Color::Black);
+                    SetColor(grand, Color::Red);
+                    LeftRotate(grand);
+                }
+            }
+        }
+        SetColor(_m_root, Color::Black);
+    }
+};
@@ -1,7 +1,20 @@
 #pragma once
+/*
+ *  树的统一接口, 两种形式:
+ *  1. TreeInterface 概念: 编译期接口, 泛型代码以树的类型为模板参数, 所有调用都可以内联,
+ *     Traverse 接受任意可调用对象, 没有 std::function 的开销
+ *  2. ITree 虚基类: 运行时多态, 需要时用 ErasedTree<Impl> 把满足概念的树包装成 ITree
+ *
+ *       template <TreeInterface Tree>            ITree<int>& tree = erased;    // ErasedTree<BPlusTree<int>>
+ *       bool Has(const Tree& t, int v) {         tree.Find(v);                 // 一次虚调用
+ *           return t.Find(v) != nullptr;         tree.Traverse(nullptr, fn);   // 每个元素一次 std::function 调用
+ *       }
+ */
 
+#include <concepts>
 #include <memory>
 #include <functional>
+#include <utility>
 template <typename Ty, class Alloc=std::allocator<Ty>>
 struct ITreeNode {
 public: 
@@ -18,6 +31,10 @@ public:
     virtual const value_type& GetValue() const = 0;
 };
 
+// * 纯虚析构函数仍然需要定义, 否则派生类无法析构
+template <typename Ty, class Alloc>
+inline ITreeNode<Ty, Alloc>::~ITreeNode() = default;
+
 template <typename Ty, class Alloc=std::allocator<Ty>>
 class ITree{
 public:
@@ -41,4 +58,78 @@ public:
 
     /// 若支持分配器访问
     virtual allocator_type GetAllocator() const = 0;
-};
\ No newline at end of file
+};
+
+template <typename Ty, class Alloc>
+inline ITree<Ty, Alloc>::~ITree() = default;
+
+/*
+* 编译期树接口, 与 ITree 的约定相同:
+*   Insert(value_type&&) / Remove(const value_type&) / Find(const value_type&) const 返回元素句柄 pointer,
+*   Traverse(root, visit) 从 root 所指的元素开始 (nullptr 表示最小元素) 按序对每个句柄调用 visit
+* ITree 本身也满足这个概念, 因此泛型代码同时接受具体的树和 ITree&
+*/
+template <typename Tree>
+concept TreeInterface = requires(Tree& tree, const Tree& ctree, typename Tree::value_type val,
+                                 typename Tree::const_pointer root) {
+    typename Tree::value_type;
+    typename Tree::allocator_type;
+    typename Tree::pointer;
+    typename Tree::const_pointer;
+    { tree.Insert(std::move(val)) } -> std::convertible_to<typename Tree::pointer>;
+    { tree.Remove(std::as_const(val)) } -> std::convertible_to<typename Tree::pointer>;
+    { ctree.Find(std::as_const(val)) } -> std::convertible_to<typename Tree::pointer>;
+    ctree.Traverse(root, [](typename Tree::pointer) {});
+    { ctree.GetAllocator() } -> std::convertible_to<typename Tree::allocator_type>;
+};
+
+/*
+* @function: 把满足 TreeInterface 的树包装成 ITree, 供确实需要运行时多态的调用方使用
+* @note: Impl 的句柄必须派生自 ITreeNode<value_type, allocator_type>
+* @note: 包装后每次调用都多一次虚调用, Traverse 对每个元素多一次 std::function 调用; 
+* @note: 性能敏感的路径请通过 Get() 直接访问 Impl
+*/
+template <TreeInterface Impl>
+class ErasedTree final : public ITree<typename Impl::value_type, typename Impl::allocator_type> {
+public:
+    using base_type       = ITree<typename Impl::value_type, typename Impl::allocator_type>;
+    using value_type      = typename base_type::value_type;
+    using allocator_type  = typename base_type::allocator_type;
+    using pointer         = typename base_type::pointer;
+    using const_pointer   = typename base_type::const_pointer;
+    using visitor         = typename base_type::visitor;
+    static_assert(std::convertible_to<typename Impl::pointer, pointer>,
+        "ErasedTree: Impl handles must derive from ITreeNode");
+
+    template <typename... Args>
+    explicit ErasedTree(Args&&... args) : _m_impl(std::forward<Args>(args)...) {}
+
+    pointer Insert(value_type&& value) override {
+        return _m_impl.Insert(std::move(value));
+    }
+    pointer Remove(const value_type& value) override {
+        return _m_impl.Remove(value);
+    }
+    pointer Find(const value_type& value) const override {
+        return _m_impl.Find(value);
+    }
+    // * root 必须是这棵树返回的句柄, 因此可以安全地转回 Impl 的句柄类型
+    void Traverse(const_pointer root, visitor visit) const override {
+        _m_impl.Traverse(static_cast<typename Impl::const_pointer>(root), [&](typename Impl::pointer node) {
+            visit(node);
+        });
+    }
+    allocator_type GetAllocator() const override {
+        return _m_impl.GetAllocator();
+    }
+
+    Impl& Get() noexcept {
+        return _m_impl;
+    }
+    const Impl& Get() const noexcept {
+        return _m_impl;
+    }
+
+private:
+    Impl _m_impl;
+};
@@ -0,0 +1,134 @@
+#pragma once
+/*
+ *  区间树: 节点按区间左端点 (左端点相同再按右端点) 排序,
+ *  每个节点额外记录以自己为根的子树中最大的右端点
+ *  max(x) = max(x.hi, max(x.left), max(x.right))
+ *  与顺序统计树一样由 RBTree.hpp 中的 UpdateAugment/UpdatePath 在旋转/插入/删除时维护
+ *
+ *                 [15,23] max=30
+ *                /              \
+ *        [8,9] max=10       [25,30] max=30
+ *        /       \
+ *   [5,8] max=8  [6,10] max=10
+ *
+ *  查询 [lo, hi] 时 max < lo 的子树整棵跳过, 左端点 > hi 的节点的右子树整棵跳过
+ */
+
+#include <memory>
+#include <vector>
+
+#include "RBTree.hpp"
+
+namespace RBTreeTools {
+
+    // * 闭区间 [lo, hi], 要求 !(hi < lo)
+    template <typename Ty>
+    struct Interval {
+        Ty lo;
+        Ty hi;
+
+        bool operator<(const Interval& other) const {
+            return lo < other.lo || (!(other.lo < lo) && hi < other.hi);
+        }
+        bool operator==(const Interval& other) const {
+            return !(*this < other) && !(other < *this);
+        }
+        // @function: 两个闭区间是否相交
+        bool Overlaps(const Ty& other_lo, const Ty& other_hi) const {
+            return !(other_hi < lo) && !(hi < other_lo);
+        }
+    };
+
+    template <typename Ty>
+    struct IntervalRBNode {
+        using value_type = Interval<Ty>;
+        using node_type = IntervalRBNode<Ty>;
+        Interval<Ty> val;
+        Color color;
+        node_type * parent;
+        node_type * left;
+        node_type * right;
+        Ty max_hi;
+
+        explicit IntervalRBNode()
+            : val(), color(Color::Black), parent(nullptr), left(nullptr), right(nullptr), max_hi() {}
+
+        explicit IntervalRBNode (Interval<Ty> val, node_type *parent=nullptr, node_type *left=nullptr, node_type *right=nullptr)
+            : val(std::move(val)), color(Color::Black), parent (parent), left(left), right(right), max_hi(this->val.hi) {}
+
+        // @function: 由左右孩子重新计算子树中最大的右端点
+        void Update() noexcept {
+            max_hi = val.hi;
+            if (left && max_hi < left->max_hi) max_hi = left->max_hi;
+            if (right && max_hi < right->max_hi) max_hi = right->max_hi;
+        }
+
+        bool operator<(const IntervalRBNode& elem) const {
+            return this->val < elem.val;
+        }
+        bool operator==(const IntervalRBNode& elem) const {
+            return this->val == elem.val;
+        }
+    };
+
+    template <typename NodeTp>
+    concept IntervalNode = RBTreeNode<NodeTp> && requires(NodeTp node) {
+        node.val.lo;
+        node.val.hi;
+        { node.max_hi < node.val.hi } -> std::convertible_to<bool>;
+    };
+
+    /*
+    * @function: 按左端点顺序访问所有与闭区间 [lo, hi] 相交的节点
+    * @note: 报告 k 个结果的代价为 O(min(n, (k + 1) log n)):
+    * @note: 访问到却不报告的节点要么在查找 hi 的路径上, 要么是某个被报告节点的祖先
+    */
+    template <IntervalNode NodeTp, typename Ty, typename Visitor>
+    inline static void ForEachOverlapping(NodeTp* root, const Ty& lo, const Ty& hi, Visitor&& visit) {
+        // 右子树用循环, 左子树递归, 递归深度不超过树高
+        NodeTp* current = root;
+        while (current && !(current->max_hi < lo)) {
+            ForEachOverlapping(current->left, lo, hi, visit);
+            if (hi < current->val.lo) {
+                // 右子树的左端点都不小于 current 的左端点, 也都 > hi
+                return;
+            }
+            if (!(current->val.hi < lo)) {
+                visit(current);
+            }
+            current = current->right;
+        }
+    }
+
+    // @return: 所有与闭区间 [lo, hi] 相交的节点, 按左端点排序
+    template <IntervalNode NodeTp, typename Ty>
+    inline static std::vector<NodeTp*> Overlapping(NodeTp* root, const Ty& lo, const Ty& hi) {
+        std::vector<NodeTp*> result;
+        if (!(hi < lo)) {
+            ForEachOverlapping(root, lo, hi, [&](NodeTp* node) { result.push_back(node); });
+        }
+        return result;
+    }
+
+    // @return: 所有包含 point 的节点 (刺穿查询), 按左端点排序
+    template <IntervalNode NodeTp, typename Ty>
+    inline static std::vector<NodeTp*> Overlapping(NodeTp* root, const Ty& point) {
+        return Overlapping(root, point, point);
+    }
+
+    // @return: 子树中最大的右端点, root 不能为空
+    template <IntervalNode NodeTp>
+    inline static const auto& MaxEndpoint(const NodeTp* root) noexcept {
+        return root->max_hi;
+    }
+}
+
+/*
+ * 区间树就是节点类型为 IntervalRBNode 的 RBTree, 插入/删除/EraseRange 等全部复用原有实现:
+ *   IntervalRBTree<int> ranges;
+ *   ranges.Insert(RBTreeTools::Interval<int>{3, 8});
+ *   auto hits = RBTreeTools::Overlapping(ranges.Root(), 5);
+ * 完全相同的区间只保留一个
+ */
+template <typename Ty, class Alloc = std::allocator<RBTreeTools::IntervalRBNode<Ty>>>
+using IntervalRBTree = RBTree<RBTreeTools::Interval<Ty>, Alloc>;
@@ -0,0 +1,158 @@
+#pragma once
+/*
+ *  每棵树独享的节点内存池:
+ *  1. 节点从大块连续内存中按顺序切出, 插入不再是 "一个 key 一次 malloc"
+ *  2. 删除归还的节点进入空闲链表, 下次分配优先复用
+ *  3. 销毁整棵树时直接丢弃所有内存块, 不需要逐个 deallocate
+ */
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace RBTreeTools {
+
+    template <typename NodeTp, std::size_t NodesPerBlock = 4096>
+    class NodePool {
+    public:
+        static_assert(NodesPerBlock > 0, "NodePool: NodesPerBlock must be positive");
+
+        NodePool() = default;
+        NodePool(const NodePool&) = delete;
+        NodePool& operator=(const NodePool&) = delete;
+        NodePool(NodePool&& other) noexcept
+            : _m_blocks(std::move(other._m_blocks)),
+              _m_free(std::exchange(other._m_free, nullptr)),
+              _m_cursor(std::exchange(other._m_cursor, nullptr)),
+              _m_end(std::exchange(other._m_end, nullptr)),
+              _m_live(std::exchange(other._m_live, 0)) {}
+        ~NodePool() {
+            ReleaseAll();
+        }
+
+        // @function: 取一个未构造的节点槽位, 优先从空闲链表中复用
+        NodeTp* Allocate() {
+            Slot* slot = _m_free;
+            if (slot) [[likely]] {
+                _m_free = slot->next;
+            } else {
+                if (_m_cursor == _m_end) [[unlikely]] {
+                    Grow();
+                }
+                slot = _m_cursor++;
+            }
+            ++_m_live;
+            return reinterpret_cast<NodeTp*>(slot);
+        }
+
+        // @function: 归还一个已经析构的节点槽位到空闲链表
+        void Deallocate(NodeTp* node) noexcept {
+            Slot* slot = reinterpret_cast<Slot*>(node);
+            slot->next = _m_free;
+            _m_free = slot;
+            --_m_live;
+        }
+
+        // @function: 丢弃全部内存块, 池中所有节点同时失效
+        // @note: 不会调用节点析构函数
+        void ReleaseAll() noexcept {
+            for (Slot* block : _m_blocks) {
+                ::operator delete(block, std::align_val_t{alignof(Slot)});
+            }
+            _m_blocks.clear();
+            _m_free = _m_cursor = _m_end = nullptr;
+            _m_live = 0;
+        }
+
+        std::size_t Size() const noexcept {
+            return _m_live;
+        }
+        std::size_t Capacity() const noexcept {
+            return _m_blocks.size() * NodesPerBlock;
+        }
+
+    private:
+        union Slot {
+            Slot* next;
+            alignas(NodeTp) unsigned char storage[sizeof(NodeTp)];
+        };
+
+        std::vector<Slot*> _m_blocks;
+        Slot* _m_free   {nullptr};   // * 空闲链表头
+        Slot* _m_cursor {nullptr};   // * 当前块中下一个未使用的槽位
+        Slot* _m_end    {nullptr};   // * 当前块末尾
+        std::size_t _m_live {0};
+
+    private:
+        void Grow() {
+            _m_blocks.reserve(_m_blocks.size() + 1);
+            auto* block = static_cast<Slot*>(
+                ::operator new(sizeof(Slot) * NodesPerBlock, std::align_val_t{alignof(Slot)}));
+            _m_blocks.push_back(block);
+            _m_cursor = block;
+            _m_end = block + NodesPerBlock;
+        }
+    };
+
+    /*
+    * @function: 符合 Allocator 要求的 NodePool 适配器, 可直接作为 InsertRBTree/DestroyRBTree 的 alloc
+    * @note: 默认构造时新建一个池, 拷贝共享同一个池, 因此每棵 RBTree<Ty, PoolAllocator<...>> 独享一个池
+    * @note: 只服务单节点分配, n != 1 时退回 std::allocator
+    */
+    template <typename NodeTp, std::size_t NodesPerBlock = 4096>
+    class PoolAllocator {
+    public:
+        using value_type = NodeTp;
+        using pool_type  = NodePool<NodeTp, NodesPerBlock>;
+        using propagate_on_container_move_assignment = std::true_type;
+
+        template <typename Other>
+        struct rebind {
+            using other = PoolAllocator<Other, NodesPerBlock>;
+        };
+
+        PoolAllocator() : _m_pool(std::make_shared<pool_type>()) {}
+        explicit PoolAllocator(std::shared_ptr<pool_type> pool) : _m_pool(std::move(pool)) {}
+        // * 移动与拷贝相同, 共享同一个池: 被移走的分配器仍然可以分配, _m_pool 永远不为空
+        PoolAllocator(const PoolAllocator&) = default;
+        PoolAllocator(PoolAllocator&& other) noexcept : _m_pool(other._m_pool) {}
+        PoolAllocator& operator=(const PoolAllocator&) = default;
+        PoolAllocator& operator=(PoolAllocator&& other) noexcept {
+            _m_pool = other._m_pool;
+            return *this;
+        }
+        template <typename Other>
+        PoolAllocator(const PoolAllocator<Other, NodesPerBlock>&) : PoolAllocator() {}
+
+        NodeTp* allocate(std::size_t n) {
+            if (n != 1) [[unlikely]] {
+                return std::allocator<NodeTp>{}.allocate(n);
+            }
+            return _m_pool->Allocate();
+        }
+        void deallocate(NodeTp* p, std::size_t n) noexcept {
+            if (n != 1) [[unlikely]] {
+                std::allocator<NodeTp>{}.deallocate(p, n);
+                return;
+            }
+            _m_pool->Deallocate(p);
+        }
+
+        // * DestroyRBTree 检测到该接口后整块释放
+        void ReleaseAll() noexcept {
+            _m_pool->ReleaseAll();
+        }
+        pool_type& Pool() const noexcept {
+            return *_m_pool;
+        }
+
+        bool operator==(const PoolAllocator& other) const noexcept {
+            return _m_pool == other._m_pool;
+        }
+
+    private:
+        std::shared_ptr<pool_type> _m_pool;
+    };
+}
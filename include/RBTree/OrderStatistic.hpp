@@ -0,0 +1,121 @@
+#pragma once
+/*
+ *  顺序统计树: 每个节点额外记录以自己为根的子树大小
+ *  size(x) = size(x.left) + size(x.right) + 1
+ *  旋转/插入/删除时由 RBTree.hpp 中的 UpdateAugment/UpdatePath 维护,
+ *  在此基础上 Rank/Select/CountInRange 都只需从根走一条路径, O(log n)
+ */
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+#include "RBTree.hpp"
+
+namespace RBTreeTools {
+
+    template <typename Ty>
+    struct OSRBNode {
+        using value_type = Ty;
+        using node_type = OSRBNode<Ty>;
+        Ty val;
+        Color color;
+        node_type * parent;
+        node_type * left;
+        node_type * right;
+        std::size_t size;
+
+        explicit OSRBNode()
+            : val(Ty{}), color(Color::Black), parent(nullptr), left(nullptr), right(nullptr), size(1) {}
+
+        explicit OSRBNode (Ty val, node_type *parent=nullptr, node_type *left=nullptr, node_type *right=nullptr)
+            : val(std::move(val)), color(Color::Black), parent (parent), left(left), right(right), size(1) {}
+
+        // @function: 由左右孩子重新计算子树大小
+        void Update() noexcept {
+            size = 1 + (left ? left->size : 0) + (right ? right->size : 0);
+        }
+
+        bool operator<(const OSRBNode& elem) const {
+            return this->val < elem.val;
+        }
+        bool operator==(const OSRBNode& elem) const {
+            return this->val == elem.val;
+        }
+    };
+
+    template <typename NodeTp>
+    concept OrderStatisticNode = RBTreeNode<NodeTp> && requires(NodeTp node) {
+        { node.size } -> std::convertible_to<std::size_t>;
+    };
+
+    template <OrderStatisticNode NodeTp>
+    inline static std::size_t SubtreeSize(const NodeTp* node) noexcept {
+        return node ? node->size : 0;
+    }
+
+    /*
+    * @function: 统计树中小于 val (inclusive 时为小于等于) 的元素个数
+    * @param: comp 必须与建树时使用的比较器相同, "小于" 即按 comp 排在前面
+    */
+    template <OrderStatisticNode NodeTp, typename Ty = typename NodeTp::value_type,
+                typename Compare = std::less<typename NodeTp::value_type>>
+    inline static std::size_t CountLess(const NodeTp* root, const Ty& val, bool inclusive = false, Compare comp = {}) {
+        std::size_t count = 0;
+        const NodeTp* current = root;
+        while (current) {
+            bool go_right = inclusive ? !comp(val, current->val) : comp(current->val, val);
+            if (go_right) {
+                count += SubtreeSize(current->left) + 1;
+                current = current->right;
+            } else {
+                current = current->left;
+            }
+        }
+        return count;
+    }
+
+    /*
+    * @function: val 的排名, 即树中严格小于 val 的元素个数
+    * @note: val 不必在树中; Rank(val) / SubtreeSize(root) 即 val 所处的百分位
+    */
+    template <OrderStatisticNode NodeTp, typename Ty = typename NodeTp::value_type,
+                typename Compare = std::less<typename NodeTp::value_type>>
+    inline static std::size_t Rank(const NodeTp* root, const Ty& val, Compare comp = {}) {
+        return CountLess(root, val, false, comp);
+    }
+
+    /*
+    * @function: 第 k 小的节点 (k 从 0 开始)
+    * @return: k >= SubtreeSize(root) 时返回 nullptr
+    */
+    template <OrderStatisticNode NodeTp>
+    inline static NodeTp* Select(NodeTp* root, std::size_t k) {
+        NodeTp* current = root;
+        while (current) {
+            std::size_t left_size = SubtreeSize(current->left);
+            if (k < left_size) {
+                current = current->left;
+            } else if (k == left_size) {
+                return current;
+            } else {
+                k -= left_size + 1;
+                current = current->right;
+            }
+        }
+        return nullptr;
+    }
+
+    // @function: 统计落在闭区间 [lo, hi] 内的元素个数, 区间按 comp 的顺序理解
+    template <OrderStatisticNode NodeTp, typename Ty = typename NodeTp::value_type,
+                typename Compare = std::less<typename NodeTp::value_type>>
+    inline static std::size_t CountInRange(const NodeTp* root, const Ty& lo, const Ty& hi, Compare comp = {}) {
+        if (comp(hi, lo)) {
+            return 0;
+        }
+        return CountLess(root, hi, true, comp) - CountLess(root, lo, false, comp);
+    }
+}
+
+template <typename Ty, class Alloc = std::allocator<RBTreeTools::OSRBNode<Ty>>, class Compare = std::less<Ty>>
+using OrderStatisticRBTree = RBTree<Ty, Alloc, Compare>;
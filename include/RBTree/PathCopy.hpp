@@ -0,0 +1,283 @@
+#pragma once
+/*
+ *  路径复制 (path copying) 的红黑树插入/删除:
+ *  已发布的节点永不修改, 一次写入只复制从根到目标的 O(log n) 个节点
+ *  (加上修复过程中被重新染色/旋转的兄弟、叔叔、侄子节点), 其余子树与旧版本共享
+ *
+ *  节点没有父指针 (共享的子树可能同时属于多个版本), 下降路径记录在定长数组里充当父指针
+ *  内存的申请与回收由 Policy 决定:
+ *    policy.Create(val)   申请一个新的红色节点
+ *    policy.Clone(node)   复制一个已发布的节点, 之后可以随意修改副本;
+ *                         节点没有被其他版本共享时可以直接返回 node 本身 (原地修改), 此时不会调用 Retire
+ *    policy.Retire(node)  旧节点已被副本替换 (并发版本交给 epoch 回收, 持久化版本减引用计数)
+ *    policy.Destroy(node) 释放一个从未发布过的副本
+ */
+
+#include <cstddef>
+#include <utility>
+
+#include "RBTree.hpp"
+
+namespace RBTreeTools {
+
+    // * 红黑树高度 < 2log2(n+1) <= 128, 删除修复最多再插入一层
+    constexpr std::size_t PathCopyMaxDepth = 130;
+
+    // * 无父指针的节点: 发布之后只读
+    template <typename Ty>
+    struct PathCopyNode {
+        using value_type = Ty;
+        using node_type = PathCopyNode<Ty>;
+        Ty val;
+        Color color;
+        node_type * left;
+        node_type * right;
+
+        explicit PathCopyNode (Ty val, Color color=Color::Red, node_type *left=nullptr, node_type *right=nullptr)
+            : val(std::move(val)), color(color), left(left), right(right) {}
+    };
+
+    namespace _detail {
+        template <typename NodeTp>
+        inline NodeTp*& ChildOf(NodeTp* node, bool right) noexcept {
+            return right ? node->right : node->left;
+        }
+
+        template <typename NodeTp>
+        inline bool IsRed(const NodeTp* node) noexcept {
+            return node && node->color == Color::Red;
+        }
+
+        // @function: 沿 right 方向的反方向旋转 node, 返回顶上来的孩子
+        //            right == false 时为左旋 (右孩子上提), right == true 时为右旋
+        template <typename NodeTp>
+        inline NodeTp* RotateDown(NodeTp* node, bool right) noexcept {
+            NodeTp* up = ChildOf(node, !right);
+            ChildOf(node, !right) = ChildOf(up, right);
+            ChildOf(up, right) = node;
+            return up;
+        }
+
+        // * 复制出来的路径: nodes[i] 为第 i 层的副本, dirs[i] 为从 nodes[i] 走向下一层的方向
+        template <typename NodeTp>
+        struct CopiedPath {
+            NodeTp* root {nullptr};
+            NodeTp* nodes[PathCopyMaxDepth];
+            bool dirs[PathCopyMaxDepth];
+
+            // @function: 把第 i 层的位置替换为 node (i < 0 表示替换根)
+            void Link(std::ptrdiff_t i, NodeTp* node) noexcept {
+                if (i < 0) {
+                    root = node;
+                } else {
+                    ChildOf(nodes[i], dirs[i]) = node;
+                }
+            }
+        };
+
+        // @function: 取得 node 的可写版本, 复制出新节点时让旧节点退休
+        template <typename NodeTp, typename Policy>
+        inline NodeTp* Own(NodeTp* node, Policy& policy) {
+            NodeTp* copy = policy.Clone(node);
+            if (copy != node) {
+                policy.Retire(node);
+            }
+            return copy;
+        }
+
+        // @function: 把 parent 在 right 方向上的孩子换成它的可写版本
+        template <typename NodeTp, typename Policy>
+        inline NodeTp* CloneChild(NodeTp* parent, bool right, Policy& policy) {
+            NodeTp* old = ChildOf(parent, right);
+            if (!old) {
+                return nullptr;
+            }
+            NodeTp* copy = Own(old, policy);
+            ChildOf(parent, right) = copy;
+            return copy;
+        }
+    }
+
+    template <typename NodeTp, typename Ty>
+    inline static const NodeTp* PathCopyFind(const NodeTp* root, const Ty& val) {
+        while (root) {
+            if (val < root->val) {
+                root = root->left;
+            } else if (root->val < val) {
+                root = root->right;
+            } else {
+                return root;
+            }
+        }
+        return nullptr;
+    }
+
+    /*
+    * @function: 插入 val, 返回新版本的根; val 已存在时原样返回 root, 不复制任何节点
+    */
+    template <typename NodeTp, typename Ty, typename Policy>
+    inline static NodeTp* PathCopyInsert(NodeTp* root, Ty&& val, Policy& policy) {
+        using _detail::ChildOf;
+        using _detail::IsRed;
+        if (PathCopyFind(root, val)) {
+            return root;
+        }
+        if (!root) {
+            NodeTp* node = policy.Create(std::forward<Ty>(val));
+            node->color = Color::Black;
+            return node;
+        }
+
+        _detail::CopiedPath<NodeTp> path;
+        path.root = _detail::Own(root, policy);
+        path.nodes[0] = path.root;
+        std::ptrdiff_t i = 0;
+        while (true) {
+            bool right = !(val < path.nodes[i]->val);
+            path.dirs[i] = right;
+            NodeTp* child = _detail::CloneChild(path.nodes[i], right, policy);
+            if (!child) {
+                break;
+            }
+            path.nodes[++i] = child;
+        }
+        NodeTp* node = policy.Create(std::forward<Ty>(val));
+        node->color = Color::Red;
+        ChildOf(path.nodes[i], path.dirs[i]) = node;
+        path.nodes[++i] = node;
+
+        // 插入修复: nodes[i] 为红色的 z, nodes[i-1] 为父节点, nodes[i-2] 为祖父节点
+        while (i >= 2 && IsRed(path.nodes[i - 1])) {
+            NodeTp* parent = path.nodes[i - 1];
+            NodeTp* grand = path.nodes[i - 2];
+            bool parent_dir = path.dirs[i - 2];
+            if (IsRed(ChildOf(grand, !parent_dir))) {
+                // Case 1: uncle is red, 叔叔是共享节点, 先复制再染色
+                NodeTp* uncle = _detail::CloneChild(grand, !parent_dir, policy);
+                uncle->color = Color::Black;
+                parent->color = Color::Black;
+                grand->color = Color::Red;
+                i -= 2;
+                continue;
+            }
+            if (path.dirs[i - 1] != parent_dir) {
+                // Case 2: triangle
+                ChildOf(grand, parent_dir) = _detail::RotateDown(parent, parent_dir);
+                std::swap(path.nodes[i], path.nodes[i - 1]);
+                parent = path.nodes[i - 1];
+            }
+            // Case 3: line
+            parent->color = Color::Black;
+            grand->color = Color::Red;
+            path.Link(i - 3, _detail::RotateDown(grand, !parent_dir));
+            break;
+        }
+        path.root->color = Color::Black;
+        return path.root;
+    }
+
+    /*
+    * @function: 删除 val, 返回新版本的根; val 不存在时原样返回 root
+    */
+    template <typename NodeTp, typename Ty, typename Policy>
+    inline static NodeTp* PathCopyErase(NodeTp* root, const Ty& val, Policy& policy) {
+        using _detail::ChildOf;
+        using _detail::IsRed;
+        if (!PathCopyFind(root, val)) {
+            return root;
+        }
+
+        _detail::CopiedPath<NodeTp> path;
+        path.root = _detail::Own(root, policy);
+        path.nodes[0] = path.root;
+        std::ptrdiff_t i = 0;
+        // 复制到目标节点
+        while (val < path.nodes[i]->val || path.nodes[i]->val < val) {
+            bool right = path.nodes[i]->val < val;
+            path.dirs[i] = right;
+            path.nodes[i + 1] = _detail::CloneChild(path.nodes[i], right, policy);
+            ++i;
+        }
+        // 有两个孩子时继续复制到中序后继, 把后继的值搬上来, 转为删除后继
+        if (path.nodes[i]->left && path.nodes[i]->right) {
+            NodeTp* target = path.nodes[i];
+            path.dirs[i] = true;
+            path.nodes[i + 1] = _detail::CloneChild(target, true, policy);
+            ++i;
+            while (path.nodes[i]->left) {
+                path.dirs[i] = false;
+                path.nodes[i + 1] = _detail::CloneChild(path.nodes[i], false, policy);
+                ++i;
+            }
+            std::swap(target->val, path.nodes[i]->val);
+        }
+
+        NodeTp* removed = path.nodes[i];
+        NodeTp* child = removed->left ? removed->left : removed->right;
+        bool removed_red = IsRed(removed);
+        path.Link(i - 1, child);
+        policy.Destroy(removed);
+        std::ptrdiff_t parent_index = i - 1;
+
+        // 删除红节点不影响黑高
+        if (!removed_red && path.root) {
+            if (IsRed(child)) {
+                // 顶替上来的孩子是红色: 复制后染黑即可
+                NodeTp* copy = _detail::Own(child, policy);
+                path.Link(parent_index, copy);
+                copy->color = Color::Black;
+            } else {
+                // 双黑修复: x 位于 nodes[parent_index] 的 dirs[parent_index] 方向
+                while (parent_index >= 0) {
+                    NodeTp* parent = path.nodes[parent_index];
+                    bool dir = path.dirs[parent_index];
+                    NodeTp* sibling = _detail::CloneChild(parent, !dir, policy);
+                    if (IsRed(sibling)) {
+                        // Case 1: 兄弟为红, 旋转后转化为兄弟为黑的情况
+                        sibling->color = Color::Black;
+                        parent->color = Color::Red;
+                        path.Link(parent_index - 1, _detail::RotateDown(parent, dir));
+                        path.nodes[parent_index] = sibling;
+                        path.dirs[parent_index] = dir;
+                        path.nodes[parent_index + 1] = parent;
+                        path.dirs[parent_index + 1] = dir;
+                        ++parent_index;
+                        sibling = _detail::CloneChild(parent, !dir, policy);
+                    }
+                    if (!IsRed(sibling->left) && !IsRed(sibling->right)) {
+                        // Case 2: 兄弟的两个孩子都是黑色, 兄弟染红, 双黑上移
+                        sibling->color = Color::Red;
+                        if (IsRed(parent)) {
+                            parent->color = Color::Black;
+                            break;
+                        }
+                        --parent_index;
+                        continue;
+                    }
+                    NodeTp* far = nullptr;
+                    if (!IsRed(ChildOf(sibling, !dir))) {
+                        // Case 3: 近侄子为红, 远侄子为黑, 旋转兄弟; 旋转后原兄弟 (已是副本) 成为远侄子
+                        NodeTp* near = _detail::CloneChild(sibling, dir, policy);
+                        near->color = Color::Black;
+                        sibling->color = Color::Red;
+                        ChildOf(parent, !dir) = _detail::RotateDown(sibling, !dir);
+                        far = sibling;
+                        sibling = near;
+                    } else {
+                        far = _detail::CloneChild(sibling, !dir, policy);
+                    }
+                    // Case 4: 远侄子为红
+                    sibling->color = parent->color;
+                    parent->color = Color::Black;
+                    far->color = Color::Black;
+                    path.Link(parent_index - 1, _detail::RotateDown(parent, dir));
+                    break;
+                }
+            }
+        }
+        if (path.root) {
+            path.root->color = Color::Black;
+        }
+        return path.root;
+    }
+}
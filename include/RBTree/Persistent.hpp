@@ -0,0 +1,225 @@
+#pragma once
+/*
+ *  持久化 (可快照) 红黑树:
+ *  1. 插入/删除通过路径复制 (PathCopy.hpp) 只复制被改动路径上的 O(log n) 个节点, 其余节点在版本间共享
+ *  2. 每个节点带原子引用计数 = 指向它的父节点个数 + 以它为根的句柄个数
+ *  3. 快照就是复制句柄: 根引用计数 +1, O(1), 不加锁
+ *  4. 引用计数为 1 的节点只属于当前句柄, 写入时直接原地修改, 没有快照时开销与普通红黑树相当
+ *
+ *       v1 = tree.Snapshot()        v1 ---> [A] <--- tree
+ *       tree.Insert(x)              v1 ---> [A]      [A'] <--- tree
+ *                                           / \      /  \
+ *                                         [B] [C]  [B]  [C']   B 被两个版本共享
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "RBTree.hpp"
+#include "PathCopy.hpp"
+
+namespace RBTreeTools {
+
+    template <typename Ty>
+    struct PersistentNode {
+        using value_type = Ty;
+        using node_type = PersistentNode<Ty>;
+        Ty val;
+        Color color;
+        node_type * left;
+        node_type * right;
+        std::atomic<std::uint32_t> refs;
+
+        explicit PersistentNode (Ty val, Color color=Color::Red, node_type *left=nullptr, node_type *right=nullptr)
+            : val(std::move(val)), color(color), left(left), right(right), refs(1) {}
+    };
+}
+
+/*
+* @function: 值语义的持久化红黑树句柄, 拷贝即快照
+* @note: 不同句柄可以在不同线程中读写; 同一个句柄不能被并发写
+* @note: 节点可能在线程间共享, alloc 需要线程安全 (默认的 std::allocator 满足)
+*/
+template <typename Ty, class Alloc = std::allocator<RBTreeTools::PersistentNode<Ty>>>
+class PersistentRBTree {
+public:
+    using value_type = Ty;
+    using allocator_type = Alloc;
+    using node_type = typename std::allocator_traits<Alloc>::value_type;
+
+    PersistentRBTree() = default;
+    explicit PersistentRBTree(const Alloc& alloc) : _m_alloc(alloc) {}
+    PersistentRBTree(const PersistentRBTree& other)
+        : _m_root(Acquire(other._m_root)), _m_size(other._m_size), _m_alloc(other._m_alloc) {}
+    PersistentRBTree(PersistentRBTree&& other) noexcept
+        : _m_root(std::exchange(other._m_root, nullptr)), _m_size(std::exchange(other._m_size, 0)),
+          _m_alloc(other._m_alloc) {}
+    PersistentRBTree& operator=(const PersistentRBTree& other) {
+        if (this != &other) {
+            node_type* root = Acquire(other._m_root);
+            Release(_m_root);
+            _m_root = root;
+            _m_size = other._m_size;
+            _m_alloc = other._m_alloc;
+        }
+        return *this;
+    }
+    PersistentRBTree& operator=(PersistentRBTree&& other) noexcept {
+        if (this != &other) {
+            Release(_m_root);
+            _m_root = std::exchange(other._m_root, nullptr);
+            _m_size = std::exchange(other._m_size, 0);
+            _m_alloc = other._m_alloc;
+        }
+        return *this;
+    }
+    ~PersistentRBTree() {
+        Release(_m_root);
+    }
+
+    // @function: O(1) 快照, 之后对 *this 的修改不会影响返回的版本
+    PersistentRBTree Snapshot() const {
+        return *this;
+    }
+
+    // @return: val 不存在并已插入时返回 true
+    template <typename U>
+    bool Insert(U&& val) {
+        if (RBTreeTools::PathCopyFind(_m_root, val)) {
+            return false;
+        }
+        WritePolicy policy{*this};
+        _m_root = RBTreeTools::PathCopyInsert(_m_root, std::forward<U>(val), policy);
+        ++_m_size;
+        return true;
+    }
+
+    // @return: val 存在并已删除时返回 true
+    bool Erase(const Ty& val) {
+        if (!RBTreeTools::PathCopyFind(_m_root, val)) {
+            return false;
+        }
+        WritePolicy policy{*this};
+        _m_root = RBTreeTools::PathCopyErase(_m_root, val, policy);
+        --_m_size;
+        return true;
+    }
+
+    // @function: 返回插入/删除后的新版本, *this 保持不变
+    template <typename U>
+    PersistentRBTree Inserted(U&& val) const {
+        PersistentRBTree next(*this);
+        next.Insert(std::forward<U>(val));
+        return next;
+    }
+    PersistentRBTree Erased(const Ty& val) const {
+        PersistentRBTree next(*this);
+        next.Erase(val);
+        return next;
+    }
+
+    // @return: 指向树中的值, 在本句柄下一次修改或析构前有效
+    const Ty* Find(const Ty& val) const {
+        const node_type* node = RBTreeTools::PathCopyFind(_m_root, val);
+        return node ? &node->val : nullptr;
+    }
+    bool Contains(const Ty& val) const {
+        return RBTreeTools::PathCopyFind(_m_root, val) != nullptr;
+    }
+
+    // @function: 中序访问所有值
+    template <typename Visitor>
+    void ForEach(Visitor&& visit) const {
+        ForEach(_m_root, visit);
+    }
+
+    const node_type* Root() const noexcept {
+        return _m_root;
+    }
+    std::size_t Size() const noexcept {
+        return _m_size;
+    }
+    bool Empty() const noexcept {
+        return _m_size == 0;
+    }
+    void Clear() {
+        Release(std::exchange(_m_root, nullptr));
+        _m_size = 0;
+    }
+    Alloc GetAllocator() const {
+        return _m_alloc;
+    }
+
+private:
+    using AllocTraits = std::allocator_traits<Alloc>;
+
+    struct WritePolicy {
+        PersistentRBTree& tree;
+
+        template <typename U>
+        node_type* Create(U&& val) {
+            return tree.NewNode(std::forward<U>(val), RBTreeTools::Color::Red, nullptr, nullptr);
+        }
+        // * 只被当前版本引用的节点原地修改; 共享的节点复制一份, 副本的孩子多了一个父节点
+        node_type* Clone(node_type* node) {
+            if (node->refs.load(std::memory_order_acquire) == 1) {
+                return node;
+            }
+            Acquire(node->left);
+            Acquire(node->right);
+            return tree.NewNode(node->val, node->color, node->left, node->right);
+        }
+        // * 旧节点少了一个父节点 (副本取代了它在当前版本中的位置)
+        void Retire(node_type* node) {
+            tree.Release(node);
+        }
+        // * 被删除的节点: 它的孩子已经被重新挂到别处, 只释放节点本身
+        void Destroy(node_type* node) {
+            tree.FreeNode(node);
+        }
+    };
+
+    node_type* _m_root {nullptr};
+    std::size_t _m_size {0};
+    [[no_unique_address]] Alloc _m_alloc;
+
+private:
+    static node_type* Acquire(node_type* node) noexcept {
+        if (node) {
+            node->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+        return node;
+    }
+    // @function: 引用计数减一, 归零时释放节点并递归释放孩子
+    void Release(node_type* node) {
+        while (node && node->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            Release(node->left);
+            node_type* right = node->right;
+            FreeNode(node);
+            node = right;
+        }
+    }
+
+    template <typename... Args>
+    node_type* NewNode(Args&&... args) {
+        node_type* node = AllocTraits::allocate(_m_alloc, 1);
+        AllocTraits::construct(_m_alloc, node, std::forward<Args>(args)...);
+        return node;
+    }
+    void FreeNode(node_type* node) {
+        AllocTraits::destroy(_m_alloc, node);
+        AllocTraits::deallocate(_m_alloc, node, 1);
+    }
+
+    template <typename Visitor>
+    static void ForEach(const node_type* node, Visitor& visit) {
+        while (node) {
+            ForEach(node->left, visit);
+            visit(node->val);
+            node = node->right;
+        }
+    }
+};
@@ -8,14 +8,27 @@
  *  5. 所有叶子节点都是黑的 (NIL)
  */
 
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
 #include <memory>
-#include <stack>
+#include <mutex>
+#include <vector>
 #include <utility>
 #include <type_traits>
 #include <concepts>
 #include <functional>
 #include <iostream>
 
+#ifdef MOONLIGHT_RBTREE_STATS
+#define RBTREE_STAT(counter, n) (::RBTreeTools::_detail::ThreadCounters().counter += (n))
+#else
+#define RBTREE_STAT(counter, n) ((void)0)
+#endif
+
 namespace RBTreeTools {
     
     enum class Position {
@@ -29,24 +42,30 @@ namespace RBTreeTools {
         return c == Color::Red;    
     }
     template <typename NodePtr, typename Compare = std::less<>>
-    concept TreeNode = requires(NodePtr node, std::remove_pointer_t<NodePtr>::value_type val, Compare comp){
+    concept TreeNode = requires(NodePtr node, typename std::remove_pointer_t<NodePtr>::value_type val, Compare comp){
         // 检查成员存在且为指针类型
-        { node.parent } -> std::convertible_to<std::add_pointer_t<NodePtr>>;
         { node.left } -> std::convertible_to<std::add_pointer_t<NodePtr>>;
         { node.right } -> std::convertible_to<std::add_pointer_t<NodePtr>>;
         { node.val };
-        { typename std::remove_pointer_t<NodePtr>::value_type };
-        { typename std::remove_pointer_t<NodePtr>::node_type };
+        typename std::remove_pointer_t<NodePtr>::value_type;
+        typename std::remove_pointer_t<NodePtr>::node_type;
         // 确保不是方法而是成员变量
-        requires std::is_member_object_pointer_v<decltype(&NodePtr::parent)>;
         requires std::is_member_object_pointer_v<decltype(&NodePtr::left)>;
         requires std::is_member_object_pointer_v<decltype(&NodePtr::right)>;
         requires std::is_member_object_pointer_v<decltype(&NodePtr::val)>;
+        // 父指针是成员变量, 或者通过 Parent()/SetParent() 访问 (父指针中可能压缩了别的信息)
+        requires requires {
+            { node.parent } -> std::convertible_to<std::add_pointer_t<NodePtr>>;
+            requires std::is_member_object_pointer_v<decltype(&NodePtr::parent)>;
+        } || requires(const NodePtr& cnode, NodePtr* ptr) {
+            { cnode.Parent() } -> std::convertible_to<std::add_pointer_t<NodePtr>>;
+            node.SetParent(ptr);
+        };
         // 内部或外部存在比较器
         requires requires {
-            { val < node->val } -> std::convertible_to<bool>;
+            { val < node.val } -> std::convertible_to<bool>;
         } || requires {
-            { comp(val, node->val) } -> std::convertible_to<bool>;
+            { comp(val, node.val) } -> std::convertible_to<bool>;
         };
     };
 
@@ -55,31 +74,218 @@ namespace RBTreeTools {
     concept RBTreeNode = requires(NodePtr node){
         // 继承基础树节点约束
         requires TreeNode<NodePtr, typename NodePtr::value_type>;  
-        // 检查颜色成员（允许bool/enum/自定义类型）
-        { node.color } -> std::convertible_to<Color>;
-        // 确保是成员变量
-        requires std::is_member_object_pointer_v<decltype(&NodePtr::color)>;
+        // 颜色是成员变量, 或者通过 GetColor()/SetColor() 访问
         requires requires { 
+            // 检查颜色成员（允许bool/enum/自定义类型）
+            { node.color } -> std::convertible_to<Color>;
+            // 确保是成员变量
+            requires std::is_member_object_pointer_v<decltype(&NodePtr::color)>;
             { node.color = Color::Red } -> std::same_as<Color&>; // 可写
-            { const_cast<const NodePtr>(node).color } -> std::same_as<Color>; // 可读 
+            { const_cast<const NodePtr&>(node).color } -> std::convertible_to<Color>; // 可读 
+        } || requires(const NodePtr& cnode) {
+            { cnode.GetColor() } -> std::convertible_to<Color>;
+            node.SetColor(Color::Red);
         };
     };
 
+    // * 比较器带 is_transparent 时允许用与 value_type 不同的类型查找, 如用 std::string_view 查 std::string
+    template <typename Compare>
+    concept TransparentCompare = requires { typename Compare::is_transparent; };
+
+    /*
+    * 访问器: 所有算法只通过下面四个函数读写父指针和颜色,
+    * 这样 RBNode (成员变量) 与 CompactRBNode (颜色压在父指针最低位) 共用同一套实现
+    */
+    template <typename NodeTp>
+    inline static NodeTp* ParentOf(const NodeTp* node) noexcept {
+        if constexpr (requires { node->Parent(); }) {
+            return node->Parent();
+        } else {
+            return node->parent;
+        }
+    }
+
+    template <typename NodeTp>
+    inline static void SetParent(NodeTp* node, NodeTp* parent) noexcept {
+        if constexpr (requires { node->SetParent(parent); }) {
+            node->SetParent(parent);
+        } else {
+            node->parent = parent;
+        }
+    }
+
+    // @note: NIL (nullptr) 视为黑色 (规则5)
+    template <typename NodeTp>
+    inline static Color ColorOf(const NodeTp* node) noexcept {
+        if (!node) {
+            return Color::Black;
+        }
+        if constexpr (requires { node->GetColor(); }) {
+            return node->GetColor();
+        } else {
+            return node->color;
+        }
+    }
+
+    template <typename NodeTp>
+    inline static void SetColor(NodeTp* node, Color color) noexcept {
+        if constexpr (requires { node->SetColor(color); }) {
+            node->SetColor(color);
+        } else {
+            node->color = color;
+        }
+    }
+
+    /*
+    * 增强节点: 节点若提供 Update(), 表示它在子树上维护了附加信息 (子树大小, 区间最大端点等),
+    * 旋转和插入/删除改变子树结构后, 会自底向上调用 Update() 重新计算; 普通节点上这两个函数为空
+    */
+    template <typename NodeTp>
+    inline static void UpdateAugment(NodeTp* node) noexcept {
+        if constexpr (requires { node->Update(); }) {
+            node->Update();
+        }
+    }
+
+    // @function: 从 node 开始一直更新到根
+    template <typename NodeTp>
+    inline static void UpdatePath(NodeTp* node) noexcept {
+        if constexpr (requires { node->Update(); }) {
+            for (; node; node = ParentOf(node)) {
+                node->Update();
+            }
+        }
+    }
+
+    /*
+    * 热路径计数器: 编译时定义 MOONLIGHT_RBTREE_STATS (CMake 选项 MOONLIGHT_RBTREE_STATS=ON) 后,
+    * 旋转、修复中的重新着色与循环次数、Find 的调用与比较次数累加到当前线程的计数块;
+    * 未定义时 RBTREE_STAT 展开为空, 热路径上没有任何额外指令, 计数器始终为 0
+    * 计数块按线程存放并独占缓存行, 互不争用; 每个线程的计数块登记在全局列表中,
+    * SnapshotCounters() 随时汇总所有存活线程, 线程退出时它的计数并入已退出线程的总和, 不会丢失
+    */
+    struct OpCounters {
+        std::uint64_t rotations {0};
+        std::uint64_t recolors {0};
+        std::uint64_t insert_fixup_iterations {0};
+        std::uint64_t remove_fixup_iterations {0};
+        std::uint64_t finds {0};
+        std::uint64_t find_comparisons {0};
+
+        OpCounters& operator+=(const OpCounters& other) noexcept {
+            rotations += other.rotations;
+            recolors += other.recolors;
+            insert_fixup_iterations += other.insert_fixup_iterations;
+            remove_fixup_iterations += other.remove_fixup_iterations;
+            finds += other.finds;
+            find_comparisons += other.find_comparisons;
+            return *this;
+        }
+    };
+
+#ifdef MOONLIGHT_RBTREE_STATS
+    constexpr bool StatsEnabled = true;
+#else
+    constexpr bool StatsEnabled = false;
+#endif
+
+    namespace _detail {
+        // * 只有所属线程写入, 用 load + store 代替带 lock 前缀的 fetch_add; 其他线程随时可以读取
+        struct RelaxedCounter {
+            std::atomic<std::uint64_t> value {0};
+
+            void operator+=(std::uint64_t n) noexcept {
+                value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+            }
+            std::uint64_t Load() const noexcept {
+                return value.load(std::memory_order_relaxed);
+            }
+        };
+
+        struct alignas(64) CounterBlock {
+            RelaxedCounter rotations;
+            RelaxedCounter recolors;
+            RelaxedCounter insert_fixup_iterations;
+            RelaxedCounter remove_fixup_iterations;
+            RelaxedCounter finds;
+            RelaxedCounter find_comparisons;
+
+            OpCounters Load() const noexcept {
+                return {rotations.Load(), recolors.Load(), insert_fixup_iterations.Load(),
+                        remove_fixup_iterations.Load(), finds.Load(), find_comparisons.Load()};
+            }
+            void Reset() noexcept {
+                for (RelaxedCounter* counter : {&rotations, &recolors, &insert_fixup_iterations,
+                                                &remove_fixup_iterations, &finds, &find_comparisons}) {
+                    counter->value.store(0, std::memory_order_relaxed);
+                }
+            }
+        };
+
+        // * 登记与注销只发生在线程第一次计数和退出时, 用互斥锁即可
+        struct CounterRegistry {
+            std::mutex lock;
+            std::vector<const CounterBlock*> live;
+            OpCounters exited;  // * 已退出线程的计数之和
+        };
+        inline CounterRegistry& Counters() noexcept {
+            static CounterRegistry registry;
+            return registry;
+        }
+
+        struct CounterBlockHolder {
+            CounterBlock block;
+            CounterBlockHolder() {
+                CounterRegistry& registry = Counters();
+                std::lock_guard guard(registry.lock);
+                registry.live.push_back(&block);
+            }
+            ~CounterBlockHolder() {
+                CounterRegistry& registry = Counters();
+                std::lock_guard guard(registry.lock);
+                registry.exited += block.Load();
+                registry.live.erase(std::find(registry.live.begin(), registry.live.end(), &block));
+            }
+        };
+
+        inline CounterBlock& ThreadCounters() noexcept {
+            thread_local CounterBlockHolder holder;
+            return holder.block;
+        }
+    }
+
+    // @return: 当前线程的计数
+    inline OpCounters LocalCounters() noexcept {
+        return _detail::ThreadCounters().Load();
+    }
+    // @function: 清零当前线程的计数, 不影响其他线程与已退出线程的总和
+    inline void ResetCounters() noexcept {
+        _detail::ThreadCounters().Reset();
+    }
+    /*
+    * @function: 汇总所有存活线程与已退出线程的计数
+    * @note: 存活线程的计数是各自在读取那一刻的值, 并发计数时结果不是同一时刻的快照
+    */
+    inline OpCounters SnapshotCounters() {
+        _detail::CounterRegistry& registry = _detail::Counters();
+        std::lock_guard guard(registry.lock);
+        OpCounters total = registry.exited;
+        for (const _detail::CounterBlock* block : registry.live) {
+            total += block->Load();
+        }
+        return total;
+    }
+
+    /*
+    * @function: NIL 叶子
+    * @note: 规则5 中的 NIL 统一用 nullptr 表示, 所有算法都以 !node 判断叶子,
+    * @note: 因此 NIL 不占用任何内存, Alloc 只在 CreateNode/DestoryNode/DestroyRBTree 上生效
+    */
     template <RBTreeNode NodeTp,
-                typename Ty, 
+                typename Ty = typename NodeTp::value_type, 
                 class Alloc = std::allocator<typename NodeTp::node_type>>
-    inline static NodeTp* Nil() {
-        using NodePtr = NodeTp*;
-        using AllocTraits = std::allocator_traits<Alloc>;
-        // comment: 懒汉单例
-        static NodePtr nil = [] {
-            Alloc alloc;
-            NodePtr ptr = AllocTraits::allocate(alloc, 1);
-            std::construct_at(ptr, Ty{}, nullptr, nullptr, nullptr);
-            return ptr;
-        }();
-
-        return nil;
+    constexpr NodeTp* Nil() noexcept {
+        return nullptr;
     }
 
 
@@ -94,10 +300,10 @@ namespace RBTreeTools {
         node_type * right;
 
         explicit RBNode()
-            : val(Ty{}), parent(Nil()), left(Nil()), right(Nil()), color(Color::Black) {}
+            : val(Ty{}), color(Color::Black), parent(nullptr), left(nullptr), right(nullptr) {}
 
-        explicit RBNode (Ty val, node_type *parent=Nil(), node_type *left=Nil(), node_type *right=Nil()) 
-            : val(val), parent (parent), left(left), right(right), color(Color::Black) {}
+        explicit RBNode (Ty val, node_type *parent=nullptr, node_type *left=nullptr, node_type *right=nullptr) 
+            : val(std::move(val)), color(Color::Black), parent (parent), left(left), right(right) {}
 
         bool operator<(const RBNode& elem) const {
             return this->val < elem.val;
@@ -107,57 +313,165 @@ namespace RBTreeTools {
         }
     };
 
-    template <typename Ty, RBTreeNode NodeTp=RBNode<Ty>>
-    inline static NodeTp* CreateNode(
-        Ty&& val
-    ) {
-        using NodePtr = NodeTp;
-        using Alloc = std::allocator<NodePtr>;
+    /*
+    * 紧凑节点: 颜色存放在父指针的最低位 (节点至少 2 字节对齐, 该位恒为 0)
+    * RBNode<int64_t>:        val(8) + color(4) + pad(4) + 3 * ptr(24) = 40 bytes
+    * CompactRBNode<int64_t>: 3 * word(24) + val(8)                    = 32 bytes, 一条缓存行放两个
+    */
+    template <typename Ty>
+    struct CompactRBNode {
+        using value_type = Ty;
+        using node_type = CompactRBNode<Ty>;
+        node_type * left;
+        node_type * right;
+        Ty val;
+
+        explicit CompactRBNode()
+            : left(nullptr), right(nullptr), val(Ty{}), _m_parent_color(Black) {}
+
+        explicit CompactRBNode (Ty val, node_type *parent=nullptr, node_type *left=nullptr, node_type *right=nullptr) 
+            : left(left), right(right), val(std::move(val)),
+              _m_parent_color(reinterpret_cast<std::uintptr_t>(parent) | Black) {}
+
+        node_type* Parent() const noexcept {
+            return reinterpret_cast<node_type*>(_m_parent_color & ~ColorMask);
+        }
+        void SetParent(node_type* parent) noexcept {
+            _m_parent_color = reinterpret_cast<std::uintptr_t>(parent) | (_m_parent_color & ColorMask);
+        }
+        Color GetColor() const noexcept {
+            return (_m_parent_color & ColorMask) ? Color::Black : Color::Red;
+        }
+        void SetColor(Color color) noexcept {
+            _m_parent_color = (_m_parent_color & ~ColorMask) | (color == Color::Black ? Black : 0);
+        }
+
+        bool operator<(const CompactRBNode& elem) const {
+            return this->val < elem.val;
+        }
+        bool operator==(const CompactRBNode& elem) const {
+            return this->val == elem.val;
+        }
+
+    private:
+        static constexpr std::uintptr_t ColorMask = 1;
+        static constexpr std::uintptr_t Black = 1;
+        std::uintptr_t _m_parent_color;
+    };
+
+    /*
+    * @function: 通过分配器 alloc 申请并构造一个节点, 新节点的左右孩子与父节点均为 NIL
+    * @param: alloc 节点分配器, 可以是 std::allocator, 也可以是 NodePool.hpp 中的 PoolAllocator
+    */
+    template <RBTreeNode NodeTp, class Alloc, typename Ty>
+    inline static NodeTp* CreateNode(Alloc& alloc, Ty&& val) {
         using AllocTraits = std::allocator_traits<Alloc>;
 
-        Alloc alloc;
-        NodePtr nil = Nil();
-        NodePtr* addr = AllocTraits::allocate(alloc, 1);
-        std::construct_at(addr, std::forward<Ty>(val), nil, nil, nil);
+        NodeTp* nil = Nil<NodeTp>();
+        NodeTp* addr = AllocTraits::allocate(alloc, 1);
+        AllocTraits::construct(alloc, addr, std::forward<Ty>(val), nil, nil, nil);
         return addr;
     }
+
+    template <typename Ty, RBTreeNode NodeTp=RBNode<std::remove_cvref_t<Ty>>>
+    inline static NodeTp* CreateNode(
+        Ty&& val
+    ) {
+        std::allocator<NodeTp> alloc;
+        return CreateNode<NodeTp>(alloc, std::forward<Ty>(val));
+    }
     // template <typename Ty>
     // inline static Node<Ty>* CreateNode(Ty&& val) {
     //     return CreateNode<Node, std::remove_cvref_t<Ty>>(std::forward<Ty>(val));
     // }
+
+    // @function: 析构并归还单个节点, 不处理其孩子
     template <RBTreeNode NodeTp, 
-                typename Ty, 
-                class Alloc=std::allocator<Ty>>
-    static NodeTp* DestoryNode(NodeTp* node) {
-        std::destroy_at(node);
-        return node;
+                class Alloc=std::allocator<typename NodeTp::node_type>>
+    static void DestoryNode(NodeTp* node, Alloc& alloc) {
+        using AllocTraits = std::allocator_traits<Alloc>;
+        AllocTraits::destroy(alloc, node);
+        AllocTraits::deallocate(alloc, node, 1);
+    }
+
+    template <RBTreeNode NodeTp>
+    static void DestoryNode(NodeTp* node) {
+        std::allocator<typename NodeTp::node_type> alloc;
+        DestoryNode(node, alloc);
     }
 
+    // @function: 只析构以 node 为根的所有节点, 不归还内存
+    template <RBTreeNode NodeTp, class Alloc>
+    static void DestroyValues(NodeTp* node, Alloc& alloc) {
+        if (!node) {
+            return;
+        }
+        DestroyValues(node->left, alloc);
+        DestroyValues(node->right, alloc);
+        std::allocator_traits<Alloc>::destroy(alloc, node);
+    }
+
+    /*
+    * @function: 释放以 node 为根的整棵树
+    * @note: 若分配器提供 ReleaseAll() (如 PoolAllocator), 则只析构节点(可平凡析构时连析构都省掉),
+    * @note: 然后整块丢弃内存; 此时 node 必须是该分配器所服务的整棵树的根
+    */
     template <RBTreeNode NodeTp, 
-                typename Ty, 
                 class Alloc=std::allocator<typename NodeTp::node_type>>
-    static NodeTp* DestroyRBTree(NodeTp* node) {
-        if (node->left) [[likely]] {
-            DestoryNode(node->left);
+    static void DestroyRBTree(NodeTp* node, Alloc& alloc) {
+        if (!node) [[unlikely]] {
+            return;
         }
-        if (node->right) [[likely]] {
-            DestoryNode(node->right);
+        if constexpr (requires { alloc.ReleaseAll(); }) {
+            if constexpr (!std::is_trivially_destructible_v<NodeTp>) {
+                DestroyValues(node, alloc);
+            }
+            alloc.ReleaseAll();
+        } else {
+            DestroyRBTree(node->left, alloc);
+            DestroyRBTree(node->right, alloc);
+            DestoryNode(node, alloc);
         }
-        DestoryNode(node);
+    }
+
+    template <RBTreeNode NodeTp>
+    static void DestroyRBTree(NodeTp* node) {
+        std::allocator<typename NodeTp::node_type> alloc;
+        DestroyRBTree(node, alloc);
+    }
+
+    // @function: 逐个归还以 node 为根的子树, 用于释放从一棵树上摘下来的一部分
+    // @note: 与 DestroyRBTree 不同, 不会触发 PoolAllocator 的整块释放
+    // @return: 归还的节点个数
+    template <RBTreeNode NodeTp, class Alloc>
+    static std::size_t DestroySubtree(NodeTp* node, Alloc& alloc) {
+        std::size_t count = 0;
+        while (node) {
+            count += DestroySubtree(node->left, alloc);
+            NodeTp* right = node->right;
+            DestoryNode(node, alloc);
+            ++count;
+            node = right;
+        }
+        return count;
     }
 
     // @return nullptr: 没找到
-    template <TreeNode NodeTp, typename Ty=NodeTp::value_type>
-    inline static NodeTp* Find(NodeTp* root, const Ty& val){
+    // @param: comp 与建树时相同的严格弱序; 透明比较器下 val 可以是任何可与 value_type 比较的类型
+    template <TreeNode NodeTp, typename Ty=NodeTp::value_type, 
+                typename Compare=std::less<typename NodeTp::value_type>>
+    inline static NodeTp* Find(NodeTp* root, const Ty& val, Compare comp = {}){
     #ifndef NDEBUG
-        static_assert(std::same_as<typename NodeTp::value_type, Ty>, "Find: 查找类型不一致");
+        static_assert(TransparentCompare<Compare> || std::same_as<typename NodeTp::value_type, Ty>,
+            "Find: 查找类型不一致 (异构查找需要透明比较器)");
     #endif
         NodeTp* current = root;
-        
+        RBTREE_STAT(finds, 1);
         while (current) {
-            if (val < current->val)
+            RBTREE_STAT(find_comparisons, 1);
+            if (comp(val, current->val))
                 current = current->left;
-            else if (val > current->val)
+            else if (RBTREE_STAT(find_comparisons, 1), comp(current->val, val))
                 current = current->right;
             else
                 return current;
@@ -193,15 +507,15 @@ namespace RBTreeTools {
     */
     template <TreeNode NodeTp>
     inline static void Transplant(NodeTp*& root, NodeTp* u, NodeTp* v) {
-        if (!u->parent)
+        NodeTp* parent = ParentOf(u);
+        if (!parent)
             root = v; // u 是根节点，替换 root 本身
-        else if (u == u->parent->left)
-            u->parent->left = v; // u 是左孩子，用 v 替换
+        else if (u == parent->left)
+            parent->left = v; // u 是左孩子，用 v 替换
         else
-            u->parent->right = v; // u 是右孩子，用 v 替换
+            parent->right = v; // u 是右孩子，用 v 替换
         if (v)
-            v->parent = u->parent; // 设置 v 的新父节点
-        u->parent = v->parent;
+            SetParent(v, parent); // 设置 v 的新父节点
     }
 
     /*
@@ -209,26 +523,26 @@ namespace RBTreeTools {
     */
     template <TreeNode NodeTp>
     inline static Position Which(NodeTp* node){
-        if (!node->parent){
+        NodeTp* parent = ParentOf(node);
+        if (!parent){
             return Position::Root;
         }
-        if (node->parent->left == node){
+        if (parent->left == node){
             return Position::Left;
         }
-        if (node->parent->right == node){
-            return Position::Right;
-        }
+        return Position::Right;
     }
 
     template <TreeNode NodeTp>
     inline static NodeTp* Uncle(NodeTp* node){
-        if (!node || !node->parent || !node->parent->parent){
+        if (!node || !ParentOf(node) || !ParentOf(ParentOf(node))){
             return nullptr;
         }
-        if (Which(node->parent) == Position::Left){
-            return node->parent->parent->right;
-        } else if (Which(node->parent) == Position::Right) {
-            return node->parent->parent->left;
+        NodeTp* parent = ParentOf(node);
+        if (Which(parent) == Position::Left){
+            return ParentOf(parent)->right;
+        } else if (Which(parent) == Position::Right) {
+            return ParentOf(parent)->left;
         } else{
             return nullptr;
         }
@@ -241,32 +555,169 @@ namespace RBTreeTools {
         return node;
     }
 
+    template <TreeNode NodeTp>
+    inline static NodeTp* Maximum(NodeTp* node) {
+        while (node && node->right)
+            node = node->right;
+        return node;
+    }
+
+    // @function: 中序后继, 沿父指针回溯, 不申请任何内存
+    // @return: node 为最大节点时返回 nullptr
+    template <TreeNode NodeTp>
+    inline static NodeTp* Successor(NodeTp* node) {
+        if (node->right)
+            return Minimum(node->right);
+        NodeTp* parent = ParentOf(node);
+        while (parent && node == parent->right) {
+            node = parent;
+            parent = ParentOf(parent);
+        }
+        return parent;
+    }
+
+    // @function: 中序前驱
+    // @return: node 为最小节点时返回 nullptr
+    template <TreeNode NodeTp>
+    inline static NodeTp* Predecessor(NodeTp* node) {
+        if (node->left)
+            return Maximum(node->left);
+        NodeTp* parent = ParentOf(node);
+        while (parent && node == parent->left) {
+            node = parent;
+            parent = ParentOf(parent);
+        }
+        return parent;
+    }
+
+    // @return: 第一个不小于 val 的节点, 不存在时返回 nullptr
+    template <TreeNode NodeTp, typename Ty=NodeTp::value_type,
+                typename Compare=std::less<typename NodeTp::value_type>>
+    inline static NodeTp* LowerBound(NodeTp* root, const Ty& val, Compare comp = {}) {
+        NodeTp* result = nullptr;
+        while (root) {
+            if (comp(root->val, val)) {
+                root = root->right;
+            } else {
+                result = root;
+                root = root->left;
+            }
+        }
+        return result;
+    }
+
+    // @return: 第一个大于 val 的节点, 不存在时返回 nullptr
+    template <TreeNode NodeTp, typename Ty=NodeTp::value_type,
+                typename Compare=std::less<typename NodeTp::value_type>>
+    inline static NodeTp* UpperBound(NodeTp* root, const Ty& val, Compare comp = {}) {
+        NodeTp* result = nullptr;
+        while (root) {
+            if (comp(val, root->val)) {
+                result = root;
+                root = root->left;
+            } else {
+                root = root->right;
+            }
+        }
+        return result;
+    }
+
+    // @function: 提前把节点所在的缓存行取进缓存, 不影响语义
+    template <typename NodeTp>
+    inline static void Prefetch(const NodeTp* node) noexcept {
+    #if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(node);
+    #endif
+    }
+
+    // * FindMany 同时推进的查找条数, 足够覆盖一次访存延迟, 状态又能留在寄存器/L1 中
+    constexpr std::size_t FindManyWidth = 8;
+
+    /*
+    * @function: 批量查找, 按 [first, last) 的顺序把结果写入 out, 未找到时写 nullptr
+    * @note: 每 FindManyWidth 条查找为一组, 轮流各下降一层并预取各自的下一个节点,
+    * @note: 一条查找等待缓存缺失时, 其余查找的比较与之重叠, 单条查找则只能串行地等每一次缺失
+    * @return: 写完后的 out
+    */
+    template <TreeNode NodeTp, std::forward_iterator It, typename OutIt,
+                typename Compare=std::less<typename NodeTp::value_type>>
+    inline static OutIt FindMany(NodeTp* root, It first, It last, OutIt out, Compare comp = {}) {
+    #ifndef NDEBUG
+        static_assert(TransparentCompare<Compare> 
+            || std::same_as<typename NodeTp::value_type, std::iter_value_t<It>>,
+            "FindMany: 查找类型不一致 (异构查找需要透明比较器)");
+    #endif
+        It keys[FindManyWidth];
+        NodeTp* cursor[FindManyWidth];
+        NodeTp* found[FindManyWidth];
+        while (first != last) {
+            std::size_t count = 0;
+            for (; count < FindManyWidth && first != last; ++count, ++first) {
+                keys[count] = first;
+                cursor[count] = root;
+                found[count] = nullptr;
+            }
+            for (bool active = true; active; ) {
+                active = false;
+                for (std::size_t i = 0; i < count; ++i) {
+                    NodeTp* node = cursor[i];
+                    if (!node) {
+                        continue;
+                    }
+                    if (comp(*keys[i], node->val)) {
+                        node = node->left;
+                    } else if (comp(node->val, *keys[i])) {
+                        node = node->right;
+                    } else {
+                        found[i] = node;
+                        node = nullptr;
+                    }
+                    if (node) {
+                        Prefetch(node);
+                        active = true;
+                    }
+                    cursor[i] = node;
+                }
+            }
+            out = std::copy(found, found + count, out);
+        }
+        return out;
+    }
+
     template <TreeNode NodeTp, typename Ty=NodeTp::value_type>
     inline static NodeTp* RemoveBinTree(NodeTp*& root, const Ty& val) {
         NodeTp* z = Find(root, val);
-        if (!z) return false;
+        if (!z) return nullptr;
 
+        NodeTp* changed = ParentOf(z); // 结构发生变化的最低节点
         if (!z->left) {
             Transplant(root, z, z->right);
         } else if (!z->right) {
             Transplant(root, z, z->left);
         } else {
             NodeTp* y = Minimum(z->right); // 找中序后继
-            if (y->parent != z) {
+            changed = y;
+            if (ParentOf(y) != z) {
+                changed = ParentOf(y);
                 Transplant(root, y, y->right);
                 y->right = z->right;
-                if (y->right) y->right->parent = y;
+                if (y->right) SetParent(y->right, y);
             }
             Transplant(root, z, y);
             y->left = z->left;
-            if (y->left) y->left->parent = y;
+            if (y->left) SetParent(y->left, y);
         }
+        UpdatePath(changed);
 
         return z;
     }
 
-    template <typename NodeTp>
-    inline static NodeTp* InsertBinTree(NodeTp*& root, NodeTp* node){
+    /*
+    * @function: 从 start 开始向下查找插入位置, 把 node 挂上去
+    * @param: start 子树值域包含 node->val 的节点 (root 或 FingerStart 的结果)
+    */
+    template <typename NodeTp, typename Compare=std::less<typename NodeTp::value_type>>
+    inline static NodeTp* InsertBinTree(NodeTp*& root, NodeTp* start, NodeTp* node, Compare comp = {}){
         using NodePtr = NodeTp*;
         if (!root){
             root = node;
@@ -276,65 +727,84 @@ namespace RBTreeTools {
         //     node->color = Color::Black;
         //     return node;
         // }
-        NodePtr nil  = Nil();
-        NodePtr current = root;
+        NodePtr nil  = Nil<NodeTp>();
+        NodePtr current = start;
         NodePtr parent = nullptr;
         while (current != nil) {
             parent = current;
-            if (node->val < current->val) {
+            if (comp(node->val, current->val)) {
                 current = current->left;
-            } else if (node->val > current->val) {
+            } else if (comp(current->val, node->val)) {
                 current = current->right;
             } else {
                 // 重复值，不插入，直接返回已有节点（也可以允许插入）
                 return current;
             }
         }
-        node->parent = parent;
+        SetParent(node, parent);
         if (!parent)
             std::cerr << "parent is nullptr\n";
         if (!node)
             std::cerr << "node is nullptr\n";
-        if (node->val < parent->val) {
+        if (comp(node->val, parent->val)) {
             parent->left = node;
         } else {
             parent->right = node;
         }
+        UpdatePath(parent);
 
         return node;
     }
-    template <TreeNode NodeTp>
-    inline static void Traversal(NodeTp* root, std::function<void(NodeTp*)> visit){
-        using NodePtr = NodeTp*;
-        std::stack<NodePtr> stack;
-        NodePtr current = root;
-        while(current || !stack.empty()){
-            while(current){
-                stack.push(current);
-                current = current->left;
+
+    template <typename NodeTp, typename Compare=std::less<typename NodeTp::value_type>>
+    inline static NodeTp* InsertBinTree(NodeTp*& root, NodeTp* node, Compare comp = {}){
+        return InsertBinTree(root, root, node, comp);
+    }
+    // @function: 从 first 开始沿父指针按中序访问, 回溯到 root 即停止
+    template <TreeNode NodeTp, typename Visitor>
+    inline static void TraversalFrom(NodeTp* first, NodeTp* root, Visitor& visit){
+        NodeTp* current = first;
+        while (current) {
+            NodeTp* next = current->right;
+            if (next) {
+                next = Minimum(next);
+            } else {
+                NodeTp* node = current;
+                while (node != root && node == ParentOf(node)->right) {
+                    node = ParentOf(node);
+                }
+                next = node == root ? nullptr : ParentOf(node);
             }
-            
-            current = stack.top();
-            stack.pop();
 
             visit(current);
 
-            current = current->right;
+            current = next;
         }
     }
 
-    template <TreeNode NodeTp, typename Ty>
-    inline static void Traversal(const NodeTp* root, std::function<void(NodeTp*)> visit){
-        std::stack<NodeTp*> stack;
+    /*
+    * @function: 中序遍历以 root 为根的子树, 对每个节点调用 visit(node)
+    * @note: visit 是模板参数, 可以被内联; 栈是函数内的定长数组, 不申请堆内存
+    * @note: 红黑树高度不超过 2log(n+1) < 128, 栈不会满; 对退化的树则改为沿父指针回溯
+    */
+    template <TreeNode NodeTp, typename Visitor>
+        requires std::invocable<Visitor&, NodeTp*>
+    inline static void Traversal(NodeTp* root, Visitor&& visit){
+        constexpr std::size_t Capacity = 128;
+        NodeTp* stack[Capacity];
+        std::size_t depth = 0;
         NodeTp* current = root;
-        while(current || !stack.empty()){
+        while(current || depth){
             while(current){
-                stack.push(current);
+                if (depth == Capacity) [[unlikely]] {
+                    TraversalFrom(Minimum(current), root, visit);
+                    return;
+                }
+                stack[depth++] = current;
                 current = current->left;
             }
             
-            current = stack.top();
-            stack.pop();
+            current = stack[--depth];
 
             visit(current);
 
@@ -342,6 +812,60 @@ namespace RBTreeTools {
         }
     }
 
+    /*
+    * 双向迭代器: 解引用得到节点中的值, 与 std::set 的迭代器一致
+    * 迭代器保存指向树根指针的地址, 因此插入导致根变化后 --end() 依然正确
+    */
+    template <TreeNode NodeTp>
+    class RBTreeIterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type        = typename NodeTp::value_type;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const value_type*;
+        using reference         = const value_type&;
+
+        RBTreeIterator() = default;
+        RBTreeIterator(NodeTp* node, NodeTp* const* root) noexcept : _m_node(node), _m_root(root) {}
+
+        reference operator*() const noexcept {
+            return _m_node->val;
+        }
+        pointer operator->() const noexcept {
+            return &_m_node->val;
+        }
+        RBTreeIterator& operator++() noexcept {
+            _m_node = Successor(_m_node);
+            return *this;
+        }
+        RBTreeIterator operator++(int) noexcept {
+            RBTreeIterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+        // @note: end() 自减得到最大节点
+        RBTreeIterator& operator--() noexcept {
+            _m_node = _m_node ? Predecessor(_m_node) : Maximum(*_m_root);
+            return *this;
+        }
+        RBTreeIterator operator--(int) noexcept {
+            RBTreeIterator tmp = *this;
+            --*this;
+            return tmp;
+        }
+        bool operator==(const RBTreeIterator& other) const noexcept {
+            return _m_node == other._m_node;
+        }
+
+        NodeTp* Node() const noexcept {
+            return _m_node;
+        }
+
+    private:
+        NodeTp* _m_node {nullptr};
+        NodeTp* const* _m_root {nullptr};
+    };
+
     /*
     * 左旋操作：将节点 x 向左旋转，使其右子节点 y 成为新的父节点
     * 图示（左旋）：
@@ -358,6 +882,7 @@ namespace RBTreeTools {
     template <RBTreeNode NodeTp>
     static void LeftRotate(NodeTp*& root, NodeTp* x) {
         if (!x || !x->right) [[unlikely]] return;
+        RBTREE_STAT(rotations, 1);
 
         NodeTp* y = x->right;
         NodeTp* B = y->left;
@@ -367,19 +892,22 @@ namespace RBTreeTools {
         x->right = B;
 
         if (B)
-            B->parent = x;
+            SetParent(B, x);
 
-        y->parent = x->parent;
+        NodeTp* P = ParentOf(x);
+        SetParent(y, P);
 
-        if (!x->parent) {
+        if (!P) {
             root = y;
-        } else if (x->parent->left == x) {
-            x->parent->left = y;
+        } else if (P->left == x) {
+            P->left = y;
         } else {
-            x->parent->right = y;
+            P->right = y;
         }
 
-        x->parent = y;
+        SetParent(x, y);
+        UpdateAugment(x);
+        UpdateAugment(y);
     }
 
     /*
@@ -399,6 +927,7 @@ namespace RBTreeTools {
     template <RBTreeNode NodeTp>
     static void RightRotate(NodeTp*& root, NodeTp* x) {
         if (!x || !x->left) [[unlikely]] return;
+        RBTREE_STAT(rotations, 1);
 
         NodeTp* y = x->left;
         NodeTp* B = y->right;
@@ -408,19 +937,22 @@ namespace RBTreeTools {
         x->left = B;
 
         if (B)
-            B->parent = x;
+            SetParent(B, x);
 
-        y->parent = x->parent;
+        NodeTp* P = ParentOf(x);
+        SetParent(y, P);
 
-        if (!x->parent) {
+        if (!P) {
             root = y;
-        } else if (x->parent->right == x) {
-            x->parent->right = y;
+        } else if (P->right == x) {
+            P->right = y;
         } else {
-            x->parent->left = y;
+            P->left = y;
         }
 
-        x->parent = y;
+        SetParent(x, y);
+        UpdateAugment(x);
+        UpdateAugment(y);
     }
 
     /*
@@ -460,99 +992,929 @@ namespace RBTreeTools {
     * case 3: Z.uncle = black (triangle)
     * case 4: Z.uncle = black (line)
     */ 
-    template <RBTreeNode NodeTp, typename Ty=NodeTp::value_type>
-    inline static NodeTp* InsertRBTree(NodeTp*& root, Ty&& val){
-    #ifndef NDEBUG
-        static_assert(std::same_as<typename NodeTp::value_type, Ty>, 
-            "InsertRBTree: Insert Type must be consistent with value_type of RBNode");
-    #endif
-
+    /*
+    * @function: 对刚挂到树上的红色节点 res 做插入修复
+    * @return: 树的黑高是否因此加 1 (修复一路上推到根, 根最后由红染黑)
+    */
+    template <RBTreeNode NodeTp>
+    inline static bool InsertFixup(NodeTp*& root, NodeTp* res){
         using NodePtr = NodeTp*;
-        NodePtr node = CreateNode(std::forward<Ty>(val)); // 完美转发
-        node->color = Color::Red;
-
-        NodePtr& raw_root = reinterpret_cast<NodePtr&>(root);  // 强制统一类型
-        NodePtr res = InsertBinTree(root, node);
-
-        while (res != root && res->parent->color == Color::Red) {
-            if (Which(res->parent) == Position::Left) {
-                NodePtr uncle = res->parent->parent->right;
-                if (uncle && uncle->color == Color::Red) {
+        while (res != root && ColorOf(ParentOf(res)) == Color::Red) {
+            RBTREE_STAT(insert_fixup_iterations, 1);
+            NodePtr parent = ParentOf(res);
+            NodePtr grand = ParentOf(parent);
+            if (Which(parent) == Position::Left) {
+                NodePtr uncle = grand->right;
+                if (ColorOf(uncle) == Color::Red) {
                     // Case 1: uncle is red
-                    res->parent->color = Color::Black;
-                    uncle->color = Color::Black;
-                    res->parent->parent->color = Color::Red;
-                    res = res->parent->parent;
+                    SetColor(parent, Color::Black);
+                    SetColor(uncle, Color::Black);
+                    SetColor(grand, Color::Red);
+                    RBTREE_STAT(recolors, 3);
+                    res = grand;
                 } else {
                     if (Which(res) == Position::Right) {
                         // Case 2: triangle
-                        res = res->parent;
+                        res = parent;
                         LeftRotate(root, res);
                     }
                     // Case 3: line
-                    res->parent->color = Color::Black;
-                    res->parent->parent->color = Color::Red;
-                    RightRotate(root, res->parent->parent);
+                    SetColor(ParentOf(res), Color::Black);
+                    SetColor(grand, Color::Red);
+                    RBTREE_STAT(recolors, 2);
+                    RightRotate(root, grand);
                 }
             } else {
                 // Mirror version
-                NodePtr uncle = res->parent->parent->left;
-                if (uncle && uncle->color == Color::Red) {
-                    res->parent->color = Color::Black;
-                    uncle->color = Color::Black;
-                    res->parent->parent->color = Color::Red;
-                    res = res->parent->parent;
+                NodePtr uncle = grand->left;
+                if (ColorOf(uncle) == Color::Red) {
+                    SetColor(parent, Color::Black);
+                    SetColor(uncle, Color::Black);
+                    SetColor(grand, Color::Red);
+                    RBTREE_STAT(recolors, 3);
+                    res = grand;
                 } else {
                     if (Which(res) == Position::Left) {
-                        res = res->parent;
+                        res = parent;
                         RightRotate(root, res);
                     }
-                    res->parent->color = Color::Black;
-                    res->parent->parent->color = Color::Red;
-                    LeftRotate(root, res->parent->parent);
+                    SetColor(ParentOf(res), Color::Black);
+                    SetColor(grand, Color::Red);
+                    RBTREE_STAT(recolors, 2);
+                    LeftRotate(root, grand);
                 }
             }
         }
-        root->color = Color::Black;
-        return res;
+        const bool grew = ColorOf(root) == Color::Red;
+        SetColor(root, Color::Black);
+        return grew;
+    }
+
+    /*
+    * @return: 新插入的节点; 若值已存在则返回已有节点, 新申请的节点会立即归还给 alloc
+    */
+    template <RBTreeNode NodeTp, typename Ty, class Alloc,
+                typename Compare=std::less<typename NodeTp::value_type>>
+    inline static NodeTp* InsertRBTree(NodeTp*& root, Ty&& val, Alloc& alloc, Compare comp = {}){
+    #ifndef NDEBUG
+        static_assert(std::same_as<typename NodeTp::value_type, std::remove_cvref_t<Ty>>, 
+            "InsertRBTree: Insert Type must be consistent with value_type of RBNode");
+    #endif
+
+        using NodePtr = NodeTp*;
+        NodePtr node = CreateNode<NodeTp>(alloc, std::forward<Ty>(val)); // 完美转发
+        SetColor(node, Color::Red);
+
+        NodePtr res = InsertBinTree(root, node, comp);
+        if (res != node) {
+            DestoryNode(node, alloc);
+            return res;
+        }
+        InsertFixup(root, node);
+        return node;
+    }
+
+    template <RBTreeNode NodeTp, typename Ty=NodeTp::value_type>
+    inline static NodeTp* InsertRBTree(NodeTp*& root, Ty&& val){
+        std::allocator<typename NodeTp::node_type> alloc;
+        return InsertRBTree(root, std::forward<Ty>(val), alloc);
     }
 
-    // @return true: 删除成功
+    /*
+    * 手指查找 (finger search): 从上一次访问的节点 finger 出发, 只向上爬到子树值域包含 val 的最低祖先,
+    * 再从那里向下查找; val 离 finger 越近, 爬升和下降的路径越短 (最坏仍为 O(log n))
+    *
+    *   val 在 finger 右侧时, 一路作为右孩子向上的祖先都小于 finger, 也小于 val, 不需要比较;
+    *   第一个作为左孩子向上的祖先 p 是 finger 子树的上界: val < p 时 finger 的子树就包含 val,
+    *   否则从 p 继续; 左侧对称
+    *
+    *   有序插入时 finger 为上一次插入的节点 (最大值), 向上只沿右链走指针, 没有上界,
+    *   直接挂在 finger 下面, 每次只比较 O(1) 次
+    */
+    // @return: 子树值域包含 val 的最低节点, 或值等于 val 的节点
+    template <TreeNode NodeTp, typename Ty, typename Compare=std::less<typename NodeTp::value_type>>
+    inline static NodeTp* FingerStart(NodeTp* finger, const Ty& val, Compare comp = {}) {
+        NodeTp* current = finger;
+        while (true) {
+            bool right = comp(current->val, val);
+            if (!right && !comp(val, current->val)) {
+                return current;
+            }
+            // 向上越过所有与 val 同侧的孩子边
+            NodeTp* child = current;
+            NodeTp* parent = ParentOf(child);
+            while (parent && (right ? parent->right : parent->left) == child) {
+                child = parent;
+                parent = ParentOf(parent);
+            }
+            if (!parent || (right ? comp(val, parent->val) : comp(parent->val, val))) {
+                return current;
+            }
+            current = parent;
+        }
+    }
+
+    // @return: 从 finger 出发找到的值为 val 的节点, 不存在时返回 nullptr; finger 为空时从 root 开始
+    template <TreeNode NodeTp, typename Ty, typename Compare=std::less<typename NodeTp::value_type>>
+    inline static NodeTp* FingerFind(NodeTp* root, NodeTp* finger, const Ty& val, Compare comp = {}) {
+        if (!finger) {
+            return Find(root, val, comp);
+        }
+        return Find(FingerStart(finger, val, comp), val, comp);
+    }
+
+    /*
+    * @function: 以 hint 为手指插入 val, hint 通常是上一次插入返回的节点
+    * @param: hint 为空时等同于 InsertRBTree
+    * @return: 新插入的节点; 若值已存在则返回已有节点
+    * @note: 插入修复本身均摊 O(1), 有序或基本有序的输入每次插入只需 O(1) 次比较
+    */
+    template <RBTreeNode NodeTp, typename Ty, class Alloc,
+                typename Compare=std::less<typename NodeTp::value_type>>
+    inline static NodeTp* InsertHint(NodeTp*& root, NodeTp* hint, Ty&& val, Alloc& alloc, Compare comp = {}){
+    #ifndef NDEBUG
+        static_assert(std::same_as<typename NodeTp::value_type, std::remove_cvref_t<Ty>>, 
+            "InsertHint: Insert Type must be consistent with value_type of RBNode");
+    #endif
+        if (!hint || !root) {
+            return InsertRBTree(root, std::forward<Ty>(val), alloc, comp);
+        }
+        NodeTp* start = FingerStart(hint, val, comp);
+        if (!comp(start->val, val) && !comp(val, start->val)) {
+            return start;
+        }
+        NodeTp* node = CreateNode<NodeTp>(alloc, std::forward<Ty>(val));
+        SetColor(node, Color::Red);
+        NodeTp* res = InsertBinTree(root, start, node, comp);
+        if (res != node) {
+            DestoryNode(node, alloc);
+            return res;
+        }
+        InsertFixup(root, node);
+        return node;
+    }
+
+    template <RBTreeNode NodeTp, typename Ty=NodeTp::value_type>
+    inline static NodeTp* InsertHint(NodeTp*& root, NodeTp* hint, Ty&& val){
+        std::allocator<typename NodeTp::node_type> alloc;
+        return InsertHint(root, hint, std::forward<Ty>(val), alloc);
+    }
+
+    /*
+    * @function: 把 val 作为新的最大值挂到当前最大节点 max 的右侧, 调用方保证 max 中的值 < val
+    * @note: 不做任何比较, 也不从某个手指向上爬; 之后只有插入修复, 均摊 O(1)
+    */
+    template <RBTreeNode NodeTp, typename Ty, class Alloc>
+    inline static NodeTp* AppendMax(NodeTp*& root, NodeTp* max, Ty&& val, Alloc& alloc){
+        NodeTp* node = CreateNode<NodeTp>(alloc, std::forward<Ty>(val));
+        SetColor(node, Color::Red);
+        SetParent(node, max);
+        max->right = node;
+        UpdatePath(max);
+        InsertFixup(root, node);
+        return node;
+    }
+
+    /*
+    * @function: 把 n 个按中序依次给出的节点链接成一棵红黑树, 不做任何旋转
+    * @param: next 每次调用返回中序下一个节点
+    * @param: red_depth 深度等于 red_depth 的节点染红, 其余染黑
+    * @note: 取中点建树, 所有节点深度 <= floor(log2 n), 而所有 NIL 的深度 >= floor(log2 n),
+    * @note: 因此把最深一层染红后, 每条路径上黑节点数都是 floor(log2 n)
+    */
+    template <RBTreeNode NodeTp, typename NextNode>
+    inline static NodeTp* LinkSorted(std::size_t n, std::size_t depth, std::size_t red_depth,
+                                     NextNode& next, NodeTp* parent) {
+        if (n == 0) {
+            return nullptr;
+        }
+        std::size_t left_size = (n - 1) / 2;
+        NodeTp* left = LinkSorted<NodeTp>(left_size, depth + 1, red_depth, next, nullptr);
+        NodeTp* node = next();
+        SetParent(node, parent);
+        node->left = left;
+        if (left) SetParent(left, node);
+        node->right = LinkSorted<NodeTp>(n - 1 - left_size, depth + 1, red_depth, next, node);
+        UpdateAugment(node);
+        SetColor(node, (depth == red_depth && depth != 0) ? Color::Red : Color::Black);
+        return node;
+    }
+
+    template <RBTreeNode NodeTp, typename NextNode>
+    inline static NodeTp* LinkSorted(std::size_t n, NextNode&& next) {
+        if (n == 0) {
+            return nullptr;
+        }
+        return LinkSorted<NodeTp>(n, 0, std::bit_width(n) - 1, next, nullptr);
+    }
+
+    /*
+    * @function: O(n) 地由有序序列建树, 按深度着色
+    * @param: [first, last) 严格递增的序列
+    * @return: 新树的根
+    */
+    template <RBTreeNode NodeTp, std::forward_iterator It, class Alloc>
+    inline static NodeTp* BuildFromSorted(It first, It last, Alloc& alloc) {
+        auto n = static_cast<std::size_t>(std::distance(first, last));
+        return LinkSorted<NodeTp>(n, [&]() {
+            return CreateNode<NodeTp>(alloc, *first++);
+        });
+    }
+
+    template <std::forward_iterator It, 
+                RBTreeNode NodeTp = RBNode<typename std::iterator_traits<It>::value_type>>
+    inline static NodeTp* BuildFromSorted(It first, It last) {
+        std::allocator<typename NodeTp::node_type> alloc;
+        return BuildFromSorted<NodeTp>(first, last, alloc);
+    }
+
+    /*
+    * @function: 批量插入 [first, last), 先排序去重, 再与已有的树合并
+    * @note: 批量足够大 (m * log2(n) >= n) 时, 把原树节点按中序取出与新值归并, 
+    * @note: 复用原节点重新链接, 总代价 O(n + m log m) 且没有旋转;
+    * @note: 否则按有序顺序逐个插入, 相邻的插入路径大多落在同一批缓存行上
+    * @return: 实际新插入的节点个数
+    */
+    template <RBTreeNode NodeTp, std::input_iterator It, class Alloc,
+                typename Compare=std::less<typename NodeTp::value_type>>
+    inline static std::size_t InsertRange(NodeTp*& root, It first, It last, Alloc& alloc, Compare comp = {}) {
+        using Ty = typename NodeTp::value_type;
+        std::vector<Ty> batch(first, last);
+        std::sort(batch.begin(), batch.end(), comp);
+        batch.erase(std::unique(batch.begin(), batch.end(), [&](const Ty& a, const Ty& b) {
+            return !comp(a, b) && !comp(b, a);
+        }), batch.end());
+
+        auto insert_each = [&]() {
+            std::size_t inserted = 0;
+            for (auto& val : batch) {
+                NodeTp* node = CreateNode<NodeTp>(alloc, std::move(val));
+                SetColor(node, Color::Red);
+                if (InsertBinTree(root, node, comp) != node) {
+                    DestoryNode(node, alloc);
+                    continue;
+                }
+                InsertFixup(root, node);
+                ++inserted;
+            }
+            return inserted;
+        };
+        // 黑高 bh 的树至少有 2^bh - 1 个节点, 先用 O(log n) 的下界排除明显的小批量
+        std::size_t black_height = 0;
+        for (NodeTp* node = root; node; node = node->left) {
+            black_height += ColorOf(node) == Color::Black;
+        }
+        if (black_height < 64 
+            && batch.size() * 2 * black_height < (std::size_t{1} << black_height) - 1) {
+            return insert_each();
+        }
+
+        std::vector<NodeTp*> nodes;
+        if (root) {
+            Traversal<NodeTp>(root, [&](NodeTp* node) {
+                nodes.push_back(node);
+            });
+        }
+        std::size_t n = nodes.size();
+        if (batch.size() * std::bit_width(n) < n) {
+            return insert_each();
+        }
+
+        std::vector<NodeTp*> merged;
+        merged.reserve(n + batch.size());
+        auto old_it = nodes.begin();
+        auto new_it = batch.begin();
+        while (old_it != nodes.end() || new_it != batch.end()) {
+            if (new_it == batch.end() || (old_it != nodes.end() && comp((*old_it)->val, *new_it))) {
+                merged.push_back(*old_it++);
+            } else if (old_it == nodes.end() || comp(*new_it, (*old_it)->val)) {
+                merged.push_back(CreateNode<NodeTp>(alloc, std::move(*new_it++)));
+            } else {
+                // 已存在的值保持原节点
+                merged.push_back(*old_it++);
+                ++new_it;
+            }
+        }
+        std::size_t inserted = merged.size() - n;
+        auto cursor = merged.begin();
+        root = LinkSorted<NodeTp>(merged.size(), [&]() {
+            return *cursor++;
+        });
+        return inserted;
+    }
+
+    template <RBTreeNode NodeTp, std::input_iterator It>
+    inline static std::size_t InsertRange(NodeTp*& root, It first, It last) {
+        std::allocator<typename NodeTp::node_type> alloc;
+        return InsertRange(root, first, last, alloc);
+    }
+
+    /* 删除修复: x 顶替了被删除的黑节点, 所在路径少了一个黑节点 ("双黑"), w 为 x 的兄弟
+    * case 1: w = red                            => 旋转 parent, 转为 w 为黑的情况
+    * case 2: w = black, w 的两个孩子都是黑的      => w 染红, 双黑上移到 parent
+    * case 3: w = black, 近侄子红, 远侄子黑        => 旋转 w, 转为 case 4
+    * case 4: w = black, 远侄子红                  => 旋转 parent, 结束
+    * @param: parent x 的父节点; x 可能是 NIL, 因此需要单独传入
+    */
+    template <RBTreeNode NodeTp>
+    inline static void RemoveFixup(NodeTp*& root, NodeTp* x, NodeTp* parent){
+        using NodePtr = NodeTp*;
+        while (x != root && ColorOf(x) == Color::Black) {
+            RBTREE_STAT(remove_fixup_iterations, 1);
+            if (x == parent->left) {
+                NodePtr sibling = parent->right;
+                if (ColorOf(sibling) == Color::Red) {
+                    // Case 1
+                    SetColor(sibling, Color::Black);
+                    SetColor(parent, Color::Red);
+                    RBTREE_STAT(recolors, 2);
+                    LeftRotate(root, parent);
+                    sibling = parent->right;
+                }
+                if (ColorOf(sibling->left) == Color::Black && ColorOf(sibling->right) == Color::Black) {
+                    // Case 2
+                    SetColor(sibling, Color::Red);
+                    RBTREE_STAT(recolors, 1);
+                    x = parent;
+                    parent = ParentOf(x);
+                } else {
+                    if (ColorOf(sibling->right) == Color::Black) {
+                        // Case 3
+                        SetColor(sibling->left, Color::Black);
+                        SetColor(sibling, Color::Red);
+                        RBTREE_STAT(recolors, 2);
+                        RightRotate(root, sibling);
+                        sibling = parent->right;
+                    }
+                    // Case 4
+                    SetColor(sibling, ColorOf(parent));
+                    SetColor(parent, Color::Black);
+                    SetColor(sibling->right, Color::Black);
+                    RBTREE_STAT(recolors, 3);
+                    LeftRotate(root, parent);
+                    x = root;
+                }
+            } else {
+                // Mirror version
+                NodePtr sibling = parent->left;
+                if (ColorOf(sibling) == Color::Red) {
+                    SetColor(sibling, Color::Black);
+                    SetColor(parent, Color::Red);
+                    RBTREE_STAT(recolors, 2);
+                    RightRotate(root, parent);
+                    sibling = parent->left;
+                }
+                if (ColorOf(sibling->left) == Color::Black && ColorOf(sibling->right) == Color::Black) {
+                    SetColor(sibling, Color::Red);
+                    RBTREE_STAT(recolors, 1);
+                    x = parent;
+                    parent = ParentOf(x);
+                } else {
+                    if (ColorOf(sibling->left) == Color::Black) {
+                        SetColor(sibling->right, Color::Black);
+                        SetColor(sibling, Color::Red);
+                        RBTREE_STAT(recolors, 2);
+                        LeftRotate(root, sibling);
+                        sibling = parent->left;
+                    }
+                    SetColor(sibling, ColorOf(parent));
+                    SetColor(parent, Color::Black);
+                    SetColor(sibling->left, Color::Black);
+                    RBTREE_STAT(recolors, 3);
+                    RightRotate(root, parent);
+                    x = root;
+                }
+            }
+        }
+        if (x) {
+            SetColor(x, Color::Black);
+        }
+    }
+
+    /*
+    * @function: 把节点 z 从树中摘下并做删除修复, 不释放 z
+    * @note: z 有两个孩子时由中序后继 y 顶替 z 的位置和颜色, 真正从路径上消失的是 y 原来的位置;
+    * @note: 先从结构变化的最低点 UpdatePath, 再做修复, 这样修复中的旋转看到的附加信息都是正确的
+    * @return: 已与树断开的 z
+    */
+    template <RBTreeNode NodeTp>
+    inline static NodeTp* RemoveNode(NodeTp*& root, NodeTp* z){
+        using NodePtr = NodeTp*;
+        NodePtr x = nullptr;
+        NodePtr x_parent = nullptr;
+        Color removed_color = ColorOf(z);
+        if (!z->left || !z->right) {
+            x = z->left ? z->left : z->right;
+            x_parent = ParentOf(z);
+            Transplant(root, z, x);
+        } else {
+            NodePtr y = Minimum(z->right);
+            removed_color = ColorOf(y);
+            x = y->right;
+            if (ParentOf(y) == z) {
+                x_parent = y;
+            } else {
+                x_parent = ParentOf(y);
+                Transplant(root, y, y->right);
+                y->right = z->right;
+                SetParent(y->right, y);
+            }
+            Transplant(root, z, y);
+            y->left = z->left;
+            SetParent(y->left, y);
+            SetColor(y, ColorOf(z));
+        }
+        UpdatePath(x_parent);
+        if (removed_color == Color::Black) {
+            RemoveFixup(root, x, x_parent);
+        }
+        z->left = z->right = nullptr;
+        SetParent(z, static_cast<NodePtr>(nullptr));
+        return z;
+    }
+
+    // @return true: 删除成功, 节点已归还给 alloc
     // @return false: 删除失败(不存在节点)
-    template <RBTreeNode NodeTp, typename Ty>
-    inline static NodeTp* RemoveRBTree(NodeTp*& root, const Ty val){
+    template <RBTreeNode NodeTp, typename Ty, class Alloc,
+                typename Compare=std::less<typename NodeTp::value_type>>
+    inline static bool RemoveRBTree(NodeTp*& root, const Ty& val, Alloc& alloc, Compare comp = {}){
     #ifndef NDEBUG
-        static_assert(std::same_as<typename NodeTp::value_type, Ty>, 
+        static_assert(TransparentCompare<Compare> || std::same_as<typename NodeTp::value_type, Ty>, 
             "RemoveRBTree: Remove Type must be consistent with value_type of RBNode");
     #endif
-        NodeTp* target = Find(root, val);
+        NodeTp* target = Find(root, val, comp);
         if (!target){
-            return nullptr;
+            return false;
+        }
+        DestoryNode(RemoveNode(root, target), alloc);
+        return true;
+    }
+
+    template <RBTreeNode NodeTp, typename Ty=NodeTp::value_type>
+    inline static bool RemoveRBTree(NodeTp*& root, const Ty& val){
+        std::allocator<typename NodeTp::node_type> alloc;
+        return RemoveRBTree(root, val, alloc);
+    }
+
+    /*
+    * 树形统计, 用于判断变慢的原因是输入倾斜还是树过深:
+    *   depth_histogram[d]        深度为 d 的节点个数 (根的深度为 0)
+    *   black_height_histogram[h] 子树黑高为 h 的节点个数 (从该节点到 NIL 路径上的黑节点数, 含自身)
+    * 红黑树保证 max_depth < 2 * black_height; 平均深度远大于 log2(size) 说明插入顺序对树形影响很大
+    */
+    struct TreeStats {
+        std::size_t size {0};
+        std::size_t black_height {0};
+        std::size_t max_depth {0};
+        double average_depth {0};
+        std::vector<std::size_t> depth_histogram;
+        std::vector<std::size_t> black_height_histogram;
+    };
+
+    namespace _detail {
+        template <RBTreeNode NodeTp>
+        inline std::size_t CollectStats(const NodeTp* node, std::size_t depth, TreeStats& stats, std::size_t& depth_sum) {
+            if (!node) {
+                return 0;
+            }
+            if (stats.depth_histogram.size() <= depth) {
+                stats.depth_histogram.resize(depth + 1);
+            }
+            ++stats.depth_histogram[depth];
+            depth_sum += depth;
+            std::size_t left = CollectStats(node->left, depth + 1, stats, depth_sum);
+            CollectStats(node->right, depth + 1, stats, depth_sum);
+            std::size_t black_height = left + (ColorOf(node) == Color::Black);
+            if (stats.black_height_histogram.size() <= black_height) {
+                stats.black_height_histogram.resize(black_height + 1);
+            }
+            ++stats.black_height_histogram[black_height];
+            return black_height;
+        }
+    }
+
+    // @function: O(n) 遍历整棵树, 计算深度与黑高分布; 与热路径计数器不同, 不需要编译开关
+    template <RBTreeNode NodeTp>
+    inline static TreeStats Stats(const NodeTp* root) {
+        TreeStats stats;
+        std::size_t depth_sum = 0;
+        stats.black_height = _detail::CollectStats(root, 0, stats, depth_sum);
+        for (std::size_t count : stats.depth_histogram) {
+            stats.size += count;
+        }
+        stats.max_depth = stats.depth_histogram.empty() ? 0 : stats.depth_histogram.size() - 1;
+        stats.average_depth = stats.size ? static_cast<double>(depth_sum) / stats.size : 0.0;
+        return stats;
+    }
+
+    /*
+     *  Join / Split (集合运算见 SetOps.hpp):
+     *  Join(L, bh(L), k, R, bh(R))  要求 L 中所有值 < k < R 中所有值, 沿较高那棵树的脊下降到黑高相同处挂上 k,
+     *                 再用插入修复消除红红冲突, O(|bh(L) - bh(R)| + 1); 返回新树及其黑高
+     *  Split(T, bh(T), key)  把 T 拆成 < key 的部分, 等于 key 的节点, > key 的部分, 连同两部分的黑高返回;
+     *                 沿查找路径自底向上 Join, 各次 Join 的黑高差之和不超过 bh(T), 总共 O(log n)
+     *  黑高由调用方一路传递, 不重新数; 不带黑高的重载先沿最左路径数一次, 多出一次 O(log n)
+     *  Join2(L, R)    没有中间节点的连接: RemoveNode 摘下 L 的最大节点作为 k, 再 Join, O(log n)
+     *  EraseRange(T, lo, hi) 两次 Split 取出 [lo, hi] 这一段 (k 个节点) 整体释放, 再 Join2 接回两端, O(k + log n)
+     */
+    template <RBTreeNode NodeTp>
+    struct SplitResult {
+        NodeTp* left   {nullptr};  // * 全部 < key
+        NodeTp* middle {nullptr};  // * 等于 key 的节点, 已与树断开; 不存在时为 nullptr
+        NodeTp* right  {nullptr};  // * 全部 > key
+        std::size_t left_bh  {0};  // * left 的黑高
+        std::size_t right_bh {0};  // * right 的黑高
+    };
+
+    template <RBTreeNode NodeTp>
+    struct JoinResult {
+        NodeTp* root {nullptr};
+        std::size_t black_height {0};
+    };
+
+    // @function: 黑高, 只沿最左路径统计, O(log n); NIL 的黑高为 0
+    template <RBTreeNode NodeTp>
+    inline static std::size_t BlackHeight(const NodeTp* root) noexcept {
+        std::size_t height = 0;
+        for (; root; root = root->left) {
+            height += ColorOf(root) == Color::Black;
         }
-        RemoveBinTree(root, val);
-        // Fix: 
-    }            
+        return height;
+    }
+
+    // @function: 孩子 child 经 DetachAsRoot 摘下 (根染黑) 之后的黑高, node_bh 为其父节点 node 的黑高, O(1)
+    template <RBTreeNode NodeTp>
+    inline static std::size_t DetachedHeight(const NodeTp* node, std::size_t node_bh, const NodeTp* child) noexcept {
+        return node_bh - (ColorOf(node) == Color::Black) + (child && ColorOf(child) == Color::Red);
+    }
+
+    // @function: 把子树从父节点上摘下来作为独立的树, 根染黑 (染黑总是合法的)
+    template <RBTreeNode NodeTp>
+    inline static NodeTp* DetachAsRoot(NodeTp* node) noexcept {
+        if (node) {
+            SetParent(node, static_cast<NodeTp*>(nullptr));
+            SetColor(node, Color::Black);
+        }
+        return node;
+    }
+    // @function: DetachAsRoot 并修正黑高 (红根染黑后黑高加 1)
+    template <RBTreeNode NodeTp>
+    inline static JoinResult<NodeTp> DetachAsTree(NodeTp* node, std::size_t black_height) noexcept {
+        black_height += node && ColorOf(node) == Color::Red;
+        return {DetachAsRoot(node), black_height};
+    }
+
+    /*
+    * @function: 连接 left, key, right 三部分
+    * @param: left_bh / right_bh 两棵树的黑高 (按它们当前根的颜色计算)
+    * @param: key 一个已脱离任何树的节点, 其左右孩子会被覆盖
+    * @return: 新树的根与黑高
+    */
+    template <RBTreeNode NodeTp>
+    inline static JoinResult<NodeTp> Join(NodeTp* left_tree, std::size_t left_tree_bh, NodeTp* key,
+                                          NodeTp* right_tree, std::size_t right_tree_bh) {
+        auto [left, left_bh] = DetachAsTree(left_tree, left_tree_bh);
+        auto [right, right_bh] = DetachAsTree(right_tree, right_tree_bh);
+
+        if (left_bh == right_bh) {
+            key->left = left;
+            key->right = right;
+            SetParent(key, static_cast<NodeTp*>(nullptr));
+            if (left) SetParent(left, key);
+            if (right) SetParent(right, key);
+            SetColor(key, Color::Black);
+            UpdateAugment(key);
+            return {key, left_bh + 1};
+        }
+
+        // 沿较高那棵树靠近另一棵树的一侧下降, 找到黑高等于矮树黑高的黑节点 c, 用 key 替换它
+        bool go_right = left_bh > right_bh;
+        NodeTp* root = go_right ? left : right;
+        NodeTp* shorter = go_right ? right : left;
+        const std::size_t root_bh = go_right ? left_bh : right_bh;
+        std::size_t height = root_bh;
+        std::size_t target = go_right ? right_bh : left_bh;
+        NodeTp* parent = nullptr;
+        NodeTp* c = root;
+        while (c && (ColorOf(c) == Color::Red || height > target)) {
+            if (ColorOf(c) == Color::Black) {
+                --height;
+            }
+            parent = c;
+            c = go_right ? c->right : c->left;
+        }
+
+        if (go_right) {
+            key->left = c;
+            key->right = shorter;
+            parent->right = key;
+        } else {
+            key->left = shorter;
+            key->right = c;
+            parent->left = key;
+        }
+        SetParent(key, parent);
+        if (c) SetParent(c, key);
+        if (shorter) SetParent(shorter, key);
+        SetColor(key, Color::Red);
+        UpdatePath(key);
+        const bool grew = InsertFixup(root, key);
+        return {root, root_bh + grew};
+    }
+
+    // @function: 不知道黑高时的 Join, 先各数一次黑高
+    template <RBTreeNode NodeTp>
+    inline static NodeTp* Join(NodeTp* left, NodeTp* key, NodeTp* right) {
+        return Join(left, BlackHeight(left), key, right, BlackHeight(right)).root;
+    }
+
+    /*
+    * @function: 以 key 为界拆分 root, root 被消耗
+    * @param: black_height root 的黑高
+    */
+    template <RBTreeNode NodeTp, typename Ty, typename Compare>
+    inline static SplitResult<NodeTp> Split(NodeTp* root, std::size_t black_height, const Ty& key, Compare comp) {
+        if (!root) {
+            return {};
+        }
+        const std::size_t left_bh = DetachedHeight(root, black_height, root->left);
+        const std::size_t right_bh = DetachedHeight(root, black_height, root->right);
+        NodeTp* left = DetachAsRoot(root->left);
+        NodeTp* right = DetachAsRoot(root->right);
+        if (comp(key, root->val)) {
+            SplitResult<NodeTp> result = Split(left, left_bh, key, comp);
+            JoinResult<NodeTp> joined = Join(result.right, result.right_bh, root, right, right_bh);
+            result.right = joined.root;
+            result.right_bh = joined.black_height;
+            return result;
+        }
+        if (comp(root->val, key)) {
+            SplitResult<NodeTp> result = Split(right, right_bh, key, comp);
+            JoinResult<NodeTp> joined = Join(left, left_bh, root, result.left, result.left_bh);
+            result.left = joined.root;
+            result.left_bh = joined.black_height;
+            return result;
+        }
+        root->left = root->right = nullptr;
+        SetParent(root, static_cast<NodeTp*>(nullptr));
+        UpdateAugment(root);
+        return {left, root, right, left_bh, right_bh};
+    }
+
+    template <RBTreeNode NodeTp, typename Ty = typename NodeTp::value_type,
+                typename Compare = std::less<typename NodeTp::value_type>>
+    inline static SplitResult<NodeTp> Split(NodeTp* root, const Ty& key, Compare comp = {}) {
+        return Split(root, BlackHeight(root), key, comp);
+    }
+
+    /*
+    * @function: 连接 left 与 right (left 中所有值 < right 中所有值), 取 left 的最大节点作为连接点
+    * @note: 最大节点用 RemoveNode 摘下 O(log n), 删除修复可能使黑高减 1, 因此沿最左路径重新数一次 O(log n),
+    * @note: 再 Join O(|bh(L) - bh(R)| + 1); 合计 O(log n)
+    */
+    template <RBTreeNode NodeTp>
+    inline static JoinResult<NodeTp> Join2(NodeTp* left, std::size_t left_bh, NodeTp* right, std::size_t right_bh) {
+        if (!left) {
+            return DetachAsTree(right, right_bh);
+        }
+        left = DetachAsRoot(left);
+        NodeTp* key = RemoveNode(left, Maximum(left));
+        return Join(left, BlackHeight(left), key, right, right_bh);
+    }
+
+    template <RBTreeNode NodeTp>
+    inline static NodeTp* Join2(NodeTp* left, NodeTp* right) {
+        return Join2(left, BlackHeight(left), right, BlackHeight(right)).root;
+    }
+
+    /*
+    * @function: 删除闭区间 [lo, hi] 内的全部 k 个值
+    * @note: Split(lo) 与 Split(hi) 各 O(log n), 逐个归还中间一段 O(k), Join2 接回两端 O(log n); 合计 O(k + log n)
+    */
+    template <RBTreeNode NodeTp, typename Ty, class Alloc, typename Compare>
+    inline static std::size_t EraseRange(NodeTp*& root, const Ty& lo, const Ty& hi, Alloc& alloc, Compare comp) {
+        if (!root || comp(hi, lo)) {
+            return 0;
+        }
+        SplitResult<NodeTp> below = Split(root, BlackHeight(root), lo, comp);
+        SplitResult<NodeTp> above = Split(below.right, below.right_bh, hi, comp);
+        std::size_t erased = DestroySubtree(below.middle, alloc)
+                           + DestroySubtree(above.left, alloc)
+                           + DestroySubtree(above.middle, alloc);
+        root = Join2(below.left, below.left_bh, above.right, above.right_bh).root;
+        return erased;
+    }
+
+    template <RBTreeNode NodeTp, typename Ty, class Alloc>
+    inline static std::size_t EraseRange(NodeTp*& root, const Ty& lo, const Ty& hi, Alloc& alloc) {
+        return EraseRange(root, lo, hi, alloc, std::less<typename NodeTp::value_type>{});
+    }
+
+    template <RBTreeNode NodeTp, typename Ty>
+    inline static std::size_t EraseRange(NodeTp*& root, const Ty& lo, const Ty& hi) {
+        std::allocator<typename NodeTp::node_type> alloc;
+        return EraseRange(root, lo, hi, alloc);
+    }
 
  // Bin
 } // namesapce Tree   
-template <typename Ty>
+/*
+ * 节点类型由分配器的 value_type 决定:
+ *   RBTree<int>                                         -> RBNode<int>
+ *   RBTree<int, std::allocator<CompactRBNode<int>>>     -> CompactRBNode<int>
+ * Compare 为严格弱序; 带 is_transparent 的比较器 (如 std::less<>) 额外开放异构的
+ * Find/lower_bound/upper_bound/equal_range/FindMany, 例如 RBTree<std::string, ..., std::less<>> 可直接用 std::string_view 查找
+ */
+template <typename Ty, class Alloc = std::allocator<RBTreeTools::RBNode<Ty>>, class Compare = std::less<Ty>>
 struct RBTree {
 public:
     using value_type = Ty;
-    using node_type = RBTreeTools::RBNode<Ty>;
+    using node_type = typename std::allocator_traits<Alloc>::value_type;
+    using allocator_type = Alloc;
+    using key_compare = Compare;
+    static_assert(RBTreeTools::RBTreeNode<node_type>, "RBTree: Alloc must allocate red-black tree nodes");
+    static_assert(std::same_as<typename node_type::value_type, Ty>, "RBTree: node value_type mismatch");
 
 public:
     RBTree() : head(nullptr) {}
-    RBTree(node_type *head) : head(head) {} 
+    explicit RBTree(const Alloc& alloc) : head(nullptr), alloc(alloc) {}
+    explicit RBTree(const Compare& comp, const Alloc& alloc = Alloc()) : head(nullptr), alloc(alloc), comp(comp) {}
+    RBTree(node_type *head) : head(head) {
+        ResetEnds();
+    }
+    RBTree(const RBTree&) = delete;
+    RBTree& operator=(const RBTree&) = delete;
+    // * 被移走的树换上一个新的分配器: 与 PoolAllocator 共享池时, 它之后的 Clear() 会整池释放, 连带释放移走的节点
+    RBTree(RBTree&& other) noexcept(std::is_nothrow_default_constructible_v<Alloc>)
+        : head(std::exchange(other.head, nullptr)), leftmost(std::exchange(other.leftmost, nullptr)),
+          rightmost(std::exchange(other.rightmost, nullptr)), alloc(std::exchange(other.alloc, Alloc())),
+          comp(std::move(other.comp)) {}
+    RBTree& operator=(RBTree&& other) noexcept(std::is_nothrow_default_constructible_v<Alloc>) {
+        if (this != &other) {
+            Clear();
+            head = std::exchange(other.head, nullptr);
+            leftmost = std::exchange(other.leftmost, nullptr);
+            rightmost = std::exchange(other.rightmost, nullptr);
+            alloc = std::exchange(other.alloc, Alloc());
+            comp = std::move(other.comp);
+        }
+        return *this;
+    }
+    ~RBTree() {
+        Clear();
+    }
 
     void SetRoot(node_type * root) noexcept {
         if (root == nullptr) [[unlikely]] {
             return ;
         }
         head = root;
+        ResetEnds();
+    }
+    node_type* Root() const noexcept {
+        return head;
+    }
+    // * 最小 / 最大节点, 由各修改操作维护, O(1); 空树时为 nullptr
+    node_type* Leftmost() const noexcept {
+        return leftmost;
+    }
+    node_type* Rightmost() const noexcept {
+        return rightmost;
+    }
+
+    template <typename Val>
+    node_type* Insert(Val&& val) {
+        node_type* node = RBTreeTools::InsertRBTree(head, std::forward<Val>(val), alloc, comp);
+        if (!leftmost || comp(node->val, leftmost->val)) leftmost = node;
+        if (!rightmost || comp(rightmost->val, node->val)) rightmost = node;
+        return node;
+    }
+    /*
+    * @function: 以 hint 为手指插入, 适合基本有序的输入:
+    *   for (auto t : timestamps) last = tree.InsertHint(last, t);
+    * @note: val 大于当前最大值时直接挂在最大节点下, 与 hint 无关, 只比较一次
+    */
+    template <typename Val>
+    node_type* InsertHint(node_type* hint, Val&& val) {
+        if (rightmost && comp(rightmost->val, val)) {
+            return rightmost = RBTreeTools::AppendMax(head, rightmost, std::forward<Val>(val), alloc);
+        }
+        node_type* node = RBTreeTools::InsertHint(head, hint, std::forward<Val>(val), alloc, comp);
+        // * 走到这里时 val 不大于最大值, 只可能成为新的最小值 (或者树原本为空)
+        if (!leftmost || comp(node->val, leftmost->val)) leftmost = node;
+        if (!rightmost) rightmost = node;
+        return node;
+    }
+    // @function: 从 finger 出发查找, finger 为空时从根开始
+    node_type* FingerFind(node_type* finger, const value_type& val) const {
+        return RBTreeTools::FingerFind(head, finger, val, comp);
     }
+    using iterator = RBTreeTools::RBTreeIterator<node_type>;
+    using const_iterator = iterator;
 
+    iterator begin() const noexcept {
+        return iterator(leftmost, &head);
+    }
+    iterator end() const noexcept {
+        return iterator(nullptr, &head);
+    }
+    iterator lower_bound(const value_type& val) const {
+        return iterator(RBTreeTools::LowerBound(head, val, comp), &head);
+    }
+    iterator upper_bound(const value_type& val) const {
+        return iterator(RBTreeTools::UpperBound(head, val, comp), &head);
+    }
+    std::pair<iterator, iterator> equal_range(const value_type& val) const {
+        return {lower_bound(val), upper_bound(val)};
+    }
+
+    node_type* Find(const value_type& val) const {
+        return RBTreeTools::Find(head, val, comp);
+    }
+
+    // * 异构查找: 只在透明比较器下存在, 查找时不构造 value_type 临时对象
+    template <typename Key> requires RBTreeTools::TransparentCompare<Compare>
+    iterator lower_bound(const Key& key) const {
+        return iterator(RBTreeTools::LowerBound(head, key, comp), &head);
+    }
+    template <typename Key> requires RBTreeTools::TransparentCompare<Compare>
+    iterator upper_bound(const Key& key) const {
+        return iterator(RBTreeTools::UpperBound(head, key, comp), &head);
+    }
+    template <typename Key> requires RBTreeTools::TransparentCompare<Compare>
+    std::pair<iterator, iterator> equal_range(const Key& key) const {
+        return {lower_bound(key), upper_bound(key)};
+    }
+    template <typename Key> requires RBTreeTools::TransparentCompare<Compare>
+    node_type* Find(const Key& key) const {
+        return RBTreeTools::Find(head, key, comp);
+    }
+
+    // @function: 批量查找, 结果 (node_type*, 未找到为 nullptr) 按顺序写入 out
+    template <std::forward_iterator It, typename OutIt>
+    OutIt FindMany(It first, It last, OutIt out) const {
+        return RBTreeTools::FindMany(head, first, last, out, comp);
+    }
+    // @return: val 存在并已删除时返回 true
+    bool Remove(const value_type& val) {
+        node_type* node = RBTreeTools::Find(head, val, comp);
+        if (!node) {
+            return false;
+        }
+        // * 最小 / 最大节点至多有一个孩子, 后继 / 前驱是它的孩子或父节点, O(1); 删除不会移动其他节点
+        if (node == leftmost) leftmost = RBTreeTools::Successor(node);
+        if (node == rightmost) rightmost = RBTreeTools::Predecessor(node);
+        RBTreeTools::DestoryNode(RBTreeTools::RemoveNode(head, node), alloc);
+        return true;
+    }
+    // @function: 删除闭区间 [lo, hi] 内的所有值, O(k + log n)
+    std::size_t EraseRange(const value_type& lo, const value_type& hi) {
+        std::size_t erased = RBTreeTools::EraseRange(head, lo, hi, alloc, comp);
+        if (erased) ResetEnds();
+        return erased;
+    }
+    // @function: 清空后由严格递增的序列 O(n) 建树
+    template <std::forward_iterator It>
+    void BuildFromSorted(It first, It last) {
+        Clear();
+        head = RBTreeTools::BuildFromSorted<node_type>(first, last, alloc);
+        ResetEnds();
+    }
+    template <std::input_iterator It>
+    std::size_t InsertRange(It first, It last) {
+        std::size_t inserted = RBTreeTools::InsertRange(head, first, last, alloc, comp);
+        if (inserted) ResetEnds();
+        return inserted;
+    }
+    // @function: 释放所有节点, 使用 PoolAllocator 时为整块丢弃
+    void Clear() {
+        RBTreeTools::DestroyRBTree(head, alloc);
+        head = leftmost = rightmost = nullptr;
+    }
+    allocator_type GetAllocator() const {
+        return alloc;
+    }
+    key_compare key_comp() const {
+        return comp;
+    }
+    // @function: 深度与黑高分布, O(n)
+    RBTreeTools::TreeStats Stats() const {
+        return RBTreeTools::Stats(head);
+    }
 
 private:
     node_type* head { nullptr };
+    node_type* leftmost { nullptr };
+    node_type* rightmost { nullptr };
+    [[no_unique_address]] Alloc alloc {};
+    [[no_unique_address]] Compare comp {};
+
+    // @function: 整体替换或批量修改之后重新定位最小 / 最大节点, O(log n)
+    void ResetEnds() noexcept {
+        leftmost = RBTreeTools::Minimum(head);
+        rightmost = RBTreeTools::Maximum(head);
+    }
 };
+
+template <typename Ty, class Alloc = std::allocator<RBTreeTools::CompactRBNode<Ty>>, class Compare = std::less<Ty>>
+using CompactRBTree = RBTree<Ty, Alloc, Compare>;
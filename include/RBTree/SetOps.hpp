@@ -0,0 +1,184 @@
+#pragma once
+/*
+ *  基于 Join/Split (定义在 RBTree.hpp) 的集合运算:
+ *  Union/Intersection/Difference 以一棵树的根为界拆开另一棵树, 左右两半递归 (可并行) 后再 Join,
+ *  总工作量 O(m log(n/m + 1)), 其中 m <= n 为两棵树的大小
+ *
+ *  所有运算都会消耗传入的树: 节点被重新链接到结果中, 多余的节点 (重复值/被减去的值) 归还给 alloc
+ */
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "RBTree.hpp"
+
+namespace RBTreeTools {
+
+    namespace _detail {
+        template <class Alloc, typename Compare>
+        struct SetOpContext {
+            Alloc& alloc;
+            std::mutex mutex;           // * 并行分支归还节点时串行访问分配器
+            std::size_t parallel_depth; // * 递归的前几层 fork 出新任务
+            Compare comp;               // * 两棵树共同的比较器, 传给 Split
+
+            template <RBTreeNode NodeTp>
+            void Discard(NodeTp* node) {
+                std::lock_guard<std::mutex> lock(mutex);
+                DestoryNode(node, alloc);
+            }
+            // * 逐个归还: 不能走 DestroyRBTree, 否则 PoolAllocator 会整池释放
+            template <RBTreeNode NodeTp>
+            void DiscardTree(NodeTp* node) {
+                if (!node) return;
+                DiscardTree(node->left);
+                DiscardTree(node->right);
+                Discard(node);
+            }
+        };
+
+        // * 两侧都足够大 (黑高 >= 8, 至少 255 个节点) 才值得开新线程
+        constexpr std::size_t ForkMinBlackHeight = 8;
+
+        // @function: 左半部分交给新任务, 右半部分在当前线程计算
+        template <typename Left, typename Right>
+        inline auto ForkJoin(bool fork, Left&& left, Right&& right) {
+            if (fork) {
+                auto future = std::async(std::launch::async, std::forward<Left>(left));
+                auto r = right();
+                return std::make_pair(future.get(), r);
+            }
+            auto l = left();
+            auto r = right();
+            return std::make_pair(l, r);
+        }
+
+        // * 黑高由调用方传入, 不必沿两棵树的脊重新统计
+        inline bool ShouldFork(std::size_t depth, std::size_t parallel_depth, std::size_t a_bh, std::size_t b_bh) {
+            return depth < parallel_depth
+                && a_bh >= ForkMinBlackHeight
+                && b_bh >= ForkMinBlackHeight;
+        }
+
+        // * 以下递归都连同黑高一起传递子树, Split/Join 因此是 O(log n) 而不是 O(log^2 n)
+        template <RBTreeNode NodeTp, class Alloc, typename Compare>
+        JoinResult<NodeTp> Union(NodeTp* a, std::size_t a_bh, NodeTp* b, std::size_t b_bh,
+                                 SetOpContext<Alloc, Compare>& ctx, std::size_t depth) {
+            if (!a) return DetachAsTree(b, b_bh);
+            if (!b) return DetachAsTree(a, a_bh);
+            SplitResult<NodeTp> parts = Split(b, b_bh, a->val, ctx.comp);
+            const std::size_t a_left_bh = DetachedHeight(a, a_bh, a->left);
+            const std::size_t a_right_bh = DetachedHeight(a, a_bh, a->right);
+            NodeTp* a_left = DetachAsRoot(a->left);
+            NodeTp* a_right = DetachAsRoot(a->right);
+            bool fork = ShouldFork(depth, ctx.parallel_depth, a_left_bh, parts.left_bh);
+            auto [left, right] = ForkJoin(fork,
+                [&] { return Union(a_left, a_left_bh, parts.left, parts.left_bh, ctx, depth + 1); },
+                [&] { return Union(a_right, a_right_bh, parts.right, parts.right_bh, ctx, depth + 1); });
+            if (parts.middle) ctx.Discard(parts.middle);
+            return Join(left.root, left.black_height, a, right.root, right.black_height);
+        }
+
+        template <RBTreeNode NodeTp, class Alloc, typename Compare>
+        JoinResult<NodeTp> Intersection(NodeTp* a, std::size_t a_bh, NodeTp* b, std::size_t b_bh,
+                                        SetOpContext<Alloc, Compare>& ctx, std::size_t depth) {
+            if (!a || !b) {
+                ctx.DiscardTree(a);
+                ctx.DiscardTree(b);
+                return {};
+            }
+            SplitResult<NodeTp> parts = Split(b, b_bh, a->val, ctx.comp);
+            const std::size_t a_left_bh = DetachedHeight(a, a_bh, a->left);
+            const std::size_t a_right_bh = DetachedHeight(a, a_bh, a->right);
+            NodeTp* a_left = DetachAsRoot(a->left);
+            NodeTp* a_right = DetachAsRoot(a->right);
+            bool fork = ShouldFork(depth, ctx.parallel_depth, a_left_bh, parts.left_bh);
+            auto [left, right] = ForkJoin(fork,
+                [&] { return Intersection(a_left, a_left_bh, parts.left, parts.left_bh, ctx, depth + 1); },
+                [&] { return Intersection(a_right, a_right_bh, parts.right, parts.right_bh, ctx, depth + 1); });
+            if (parts.middle) {
+                ctx.Discard(parts.middle);
+                return Join(left.root, left.black_height, a, right.root, right.black_height);
+            }
+            ctx.Discard(a);
+            return Join2(left.root, left.black_height, right.root, right.black_height);
+        }
+
+        template <RBTreeNode NodeTp, class Alloc, typename Compare>
+        JoinResult<NodeTp> Difference(NodeTp* a, std::size_t a_bh, NodeTp* b, std::size_t b_bh,
+                                      SetOpContext<Alloc, Compare>& ctx, std::size_t depth) {
+            if (!a || !b) {
+                ctx.DiscardTree(b);
+                return DetachAsTree(a, a_bh);
+            }
+            SplitResult<NodeTp> parts = Split(a, a_bh, b->val, ctx.comp);
+            const std::size_t b_left_bh = DetachedHeight(b, b_bh, b->left);
+            const std::size_t b_right_bh = DetachedHeight(b, b_bh, b->right);
+            NodeTp* b_left = DetachAsRoot(b->left);
+            NodeTp* b_right = DetachAsRoot(b->right);
+            bool fork = ShouldFork(depth, ctx.parallel_depth, parts.left_bh, b_left_bh);
+            auto [left, right] = ForkJoin(fork,
+                [&] { return Difference(parts.left, parts.left_bh, b_left, b_left_bh, ctx, depth + 1); },
+                [&] { return Difference(parts.right, parts.right_bh, b_right, b_right_bh, ctx, depth + 1); });
+            ctx.Discard(b);
+            if (parts.middle) ctx.Discard(parts.middle);
+            return Join2(left.root, left.black_height, right.root, right.black_height);
+        }
+
+        // * 默认 fork 的层数: 让叶子任务数约为硬件线程数的 4 倍
+        inline std::size_t DefaultParallelDepth() {
+            unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+            return threads == 1 ? 0 : std::bit_width(threads) + 2;
+        }
+    }
+
+    /*
+    * @function: a ∪ b, 消耗 a 与 b
+    * @param: parallel_depth 递归前几层并行, 0 表示串行
+    * @param: comp 两棵树建树时使用的比较器, 必须相同
+    * @note: 并行时 alloc 只在内部互斥锁保护下使用, 因此 PoolAllocator 也可以使用
+    */
+    template <RBTreeNode NodeTp, class Alloc, typename Compare = std::less<typename NodeTp::value_type>>
+    inline static NodeTp* Union(NodeTp* a, NodeTp* b, Alloc& alloc,
+                                std::size_t parallel_depth = _detail::DefaultParallelDepth(), Compare comp = {}) {
+        _detail::SetOpContext<Alloc, Compare> ctx{alloc, {}, parallel_depth, comp};
+        return _detail::Union(a, BlackHeight(a), b, BlackHeight(b), ctx, 0).root;
+    }
+
+    // @function: a ∩ b, 消耗 a 与 b
+    template <RBTreeNode NodeTp, class Alloc, typename Compare = std::less<typename NodeTp::value_type>>
+    inline static NodeTp* Intersection(NodeTp* a, NodeTp* b, Alloc& alloc,
+                                       std::size_t parallel_depth = _detail::DefaultParallelDepth(), Compare comp = {}) {
+        _detail::SetOpContext<Alloc, Compare> ctx{alloc, {}, parallel_depth, comp};
+        return _detail::Intersection(a, BlackHeight(a), b, BlackHeight(b), ctx, 0).root;
+    }
+
+    // @function: a \ b, 消耗 a 与 b
+    template <RBTreeNode NodeTp, class Alloc, typename Compare = std::less<typename NodeTp::value_type>>
+    inline static NodeTp* Difference(NodeTp* a, NodeTp* b, Alloc& alloc,
+                                     std::size_t parallel_depth = _detail::DefaultParallelDepth(), Compare comp = {}) {
+        _detail::SetOpContext<Alloc, Compare> ctx{alloc, {}, parallel_depth, comp};
+        return _detail::Difference(a, BlackHeight(a), b, BlackHeight(b), ctx, 0).root;
+    }
+
+    template <RBTreeNode NodeTp>
+    inline static NodeTp* Union(NodeTp* a, NodeTp* b) {
+        std::allocator<typename NodeTp::node_type> alloc;
+        return Union(a, b, alloc);
+    }
+    template <RBTreeNode NodeTp>
+    inline static NodeTp* Intersection(NodeTp* a, NodeTp* b) {
+        std::allocator<typename NodeTp::node_type> alloc;
+        return Intersection(a, b, alloc);
+    }
+    template <RBTreeNode NodeTp>
+    inline static NodeTp* Difference(NodeTp* a, NodeTp* b) {
+        std::allocator<typename NodeTp::node_type> alloc;
+        return Difference(a, b, alloc);
+    }
+}
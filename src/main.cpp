@@ -6,9 +6,35 @@
 #include <vector>
 #include <cassert>
 #include <algorithm>
+#include <random>
+#include <set>
+#include <thread>
+#include <latch>
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <queue>
+#include <map>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
 
 #include "../include/match/static_match.hpp"
 #include "../include/RBTree/RBTree.hpp"
+#include "../include/RBTree/NodePool.hpp"
+#include "../include/RBTree/OrderStatistic.hpp"
+#include "../include/RBTree/SetOps.hpp"
+#include "../include/RBTree/Concurrent.hpp"
+#include "../include/RBTree/Persistent.hpp"
+#include "../include/RBTree/Indexed.hpp"
+#include "../include/RBTree/Frozen.hpp"
+#include "../include/RBTree/Interval.hpp"
+#include "../include/BPlusTree/BPlusTree.hpp"
+#include "../include/Graph/GraphManager.hpp"
+#include "../include/Graph/BFS.hpp"
+#include "../include/Graph/ShortestPath.hpp"
+#include "../include/Graph/EdgeListLoader.hpp"
+#include "../include/Graph/Snapshot.hpp"
 void test_static_match(){
 
 // 测试1: 基本类型匹配
@@ -101,7 +127,7 @@ using namespace RBTreeTools;
 // 打印节点值及颜色
 template <typename Node>
 void PrintNode(Node* node) {
-    std::cout << node->val << "(" << (node->color == Color::Red ? "R" : "B") << ") ";
+    std::cout << node->val << "(" << (ColorOf(node) == Color::Red ? "R" : "B") << ") ";
 }
 
 // 验证中序遍历是否递增（即是合法的 BST）
@@ -121,7 +147,25 @@ int CountBlackHeight(Node* node, bool& ok) {
     int left = CountBlackHeight(node->left, ok);
     int right = CountBlackHeight(node->right, ok);
     if (left != right) ok = false;
-    return left + (node->color == Color::Black ? 1 : 0);
+    return left + (ColorOf(node) == Color::Black ? 1 : 0);
+}
+
+// 验证性质3：红节点的孩子一定是黑的
+template <typename Node>
+bool NoRedRed(Node* node) {
+    if (!node) return true;
+    if (ColorOf(node) == Color::Red) {
+        if (ColorOf(node->left) == Color::Red || ColorOf(node->right) == Color::Red)
+            return false;
+    }
+    return NoRedRed(node->left) && NoRedRed(node->right);
+}
+
+template <typename Node>
+bool IsValidRBTree(Node* root) {
+    bool ok = true;
+    CountBlackHeight(root, ok);
+    return ok && IsInOrder<Node>(root) && NoRedRed(root) && ColorOf(root) == Color::Black;
 }
 
 int main() {
@@ -160,6 +204,1322 @@ int main() {
     // assert(dup != nullptr && dup->val == 30);
     std::cout << "✓ 重复插入未生成新节点\n";
 
+    std::cout << "内存池节点分配: ";
+    {
+        RBTree<int, PoolAllocator<Node>> pooled;
+        for (int v : values) {
+            pooled.Insert(v);
+        }
+        pooled.Insert(30);
+        assert(pooled.GetAllocator().Pool().Size() == values.size());
+        assert(IsInOrder<Node>(pooled.Root()));
+        bool pooled_ok = true;
+        CountBlackHeight<Node>(pooled.Root(), pooled_ok);
+        assert(pooled_ok);
+        pooled.Clear();
+        assert(pooled.GetAllocator().Pool().Capacity() == 0);
+
+        // 被移走的树仍然可用, 并且不再与移走的树共享池
+        RBTree<int, PoolAllocator<Node>> a;
+        a.Insert(1);
+        auto b = std::move(a);
+        a.Insert(2);
+        assert(&a.GetAllocator().Pool() != &b.GetAllocator().Pool());
+        a.Clear();
+        assert(b.Find(1) && !b.Find(2) && b.GetAllocator().Pool().Size() == 1);
+        a = std::move(b);
+        b.Insert(3);
+        assert(a.Find(1) && !a.Find(3) && b.Find(3));
+    }
+    std::cout << "✓ 节点来自内存池且整块释放\n";
+
+    std::cout << "有序序列建树与批量插入: ";
+    {
+        for (int n : {0, 1, 2, 3, 7, 8, 100, 1000}) {
+            std::vector<int> sorted(n);
+            for (int i = 0; i < n; ++i) sorted[i] = i * 2;
+            Node* built = BuildFromSorted(sorted.begin(), sorted.end());
+            assert(IsValidRBTree(built));
+            std::vector<int> batch = {5, -3, 7, 5, 2 * n + 11, 0};
+            std::size_t inserted = InsertRange(built, batch.begin(), batch.end());
+            assert(inserted == (n > 0 ? 4u : 5u));
+            assert(IsValidRBTree(built));
+            assert(Find(built, 5) && Find(built, -3) && Find(built, 0));
+            DestroyRBTree(built);
+        }
+    }
+    std::cout << "✓ 建树与合并后仍是合法红黑树\n";
+
+    std::cout << "紧凑节点 (颜色压入父指针): ";
+    {
+        using Compact = CompactRBNode<int>;
+        static_assert(sizeof(Compact) == 32);
+        CompactRBTree<int> compact;
+        for (int v : values) {
+            compact.Insert(v);
+        }
+        assert(IsValidRBTree<Compact>(compact.Root()));
+        for (int v : values) {
+            Compact* hit = compact.Find(v);
+            assert(hit && hit->val == v);
+            assert(!ParentOf(hit) || ParentOf(hit)->left == hit || ParentOf(hit)->right == hit);
+        }
+        assert(!compact.Find(2));
+    }
+    std::cout << "✓ 32 字节节点, 结构合法\n";
+
+    std::cout << "顺序统计 Rank/Select/CountInRange: ";
+    {
+        using OSNode = OSRBNode<int>;
+        OrderStatisticRBTree<int> ranked;
+        std::vector<int> keys;
+        for (int i = 0; i < 500; ++i) {
+            keys.push_back((i * 7919) % 1000);
+            ranked.Insert(keys.back());
+        }
+        std::vector<int> extra = {1001, 1003, -5};
+        ranked.InsertRange(extra.begin(), extra.end());
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+        keys.insert(keys.begin(), -5);
+        keys.push_back(1001);
+        keys.push_back(1003);
+        assert(IsValidRBTree<OSNode>(ranked.Root()));
+        assert(SubtreeSize(ranked.Root()) == keys.size());
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            assert(Select(ranked.Root(), i)->val == keys[i]);
+            assert(Rank(ranked.Root(), keys[i]) == i);
+        }
+        assert(!Select(ranked.Root(), keys.size()));
+        assert(CountInRange(ranked.Root(), 100, 199) 
+            == std::size_t(std::count_if(keys.begin(), keys.end(), [](int k) { return k >= 100 && k <= 199; })));
+        assert(CountInRange(ranked.Root(), 10, 5) == 0);
+
+        // 降序树: 排名与区间都按比较器的顺序
+        OrderStatisticRBTree<int, std::allocator<OSNode>, std::greater<int>> descending;
+        for (int k : keys) descending.Insert(k);
+        std::greater<int> greater;
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            assert(Select(descending.Root(), i)->val == keys[keys.size() - 1 - i]);
+            assert(Rank(descending.Root(), keys[keys.size() - 1 - i], greater) == i);
+        }
+        assert(CountInRange(descending.Root(), 199, 100, greater) == CountInRange(ranked.Root(), 100, 199));
+        assert(CountInRange(descending.Root(), 5, 10, greater) == 0);
+    }
+    std::cout << "✓ 与有序数组结果一致\n";
+
+    std::cout << "迭代器与 lower_bound/upper_bound/equal_range: ";
+    {
+        static_assert(std::bidirectional_iterator<RBTree<int>::iterator>);
+        RBTree<int> tree;
+        for (int v : values) {
+            tree.Insert(v);
+        }
+        std::vector<int> expected = values;
+        std::sort(expected.begin(), expected.end());
+        std::vector<int> forward;
+        for (int v : tree) {
+            forward.push_back(v);
+        }
+        assert(forward == expected);
+        std::vector<int> backward(std::make_reverse_iterator(tree.end()), std::make_reverse_iterator(tree.begin()));
+        assert(std::equal(backward.rbegin(), backward.rend(), expected.begin(), expected.end()));
+        assert(*tree.lower_bound(16) == 20 && *tree.lower_bound(20) == 20);
+        assert(*tree.upper_bound(20) == 25 && tree.upper_bound(90) == tree.end());
+        auto [lo, hi] = tree.equal_range(30);
+        assert(std::distance(lo, hi) == 1 && *lo == 30);
+        assert(std::distance(tree.begin(), tree.end()) == std::ptrdiff_t(values.size()));
+
+        int visited = 0;
+        Traversal(tree.Root()->left, [&](Node*) { ++visited; });
+        assert(visited == std::distance(tree.begin(), tree.lower_bound(tree.Root()->val)));
+
+        // 退化成左链的普通二叉搜索树, 深度超过遍历栈容量
+        Node* chain = nullptr;
+        for (int v = 300; v > 0; --v) {
+            InsertBinTree(chain, CreateNode(v));
+        }
+        std::vector<int> chain_vals;
+        Traversal(chain, [&](Node* n) { chain_vals.push_back(n->val); });
+        assert(chain_vals.size() == 300 && std::is_sorted(chain_vals.begin(), chain_vals.end()));
+        DestroyRBTree(chain);
+    }
+    std::cout << "✓ 与有序数组一致\n";
+
+    std::cout << "Join/Split 集合运算: ";
+    {
+        auto make = [](int from, int to, int step) {
+            std::vector<int> vals;
+            for (int v = from; v < to; v += step) vals.push_back(v);
+            return vals;
+        };
+        auto collect = [](Node* tree) {
+            std::vector<int> vals;
+            Traversal(tree, [&](Node* n) { vals.push_back(n->val); });
+            return vals;
+        };
+        std::vector<int> a = make(0, 20000, 2), b = make(0, 30000, 3);
+        std::vector<int> expect_union, expect_inter, expect_diff;
+        std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expect_union));
+        std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expect_inter));
+        std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expect_diff));
+
+        for (std::size_t parallel_depth : {std::size_t{0}, std::size_t{4}}) {
+            std::allocator<Node> alloc;
+            Node* u = Union(BuildFromSorted(a.begin(), a.end()), BuildFromSorted(b.begin(), b.end()), alloc, parallel_depth);
+            assert(IsValidRBTree(u) && collect(u) == expect_union);
+            Node* i = Intersection(BuildFromSorted(a.begin(), a.end()), BuildFromSorted(b.begin(), b.end()), alloc, parallel_depth);
+            assert(IsValidRBTree(i) && collect(i) == expect_inter);
+            Node* d = Difference(BuildFromSorted(a.begin(), a.end()), BuildFromSorted(b.begin(), b.end()), alloc, parallel_depth);
+            assert(IsValidRBTree(d) && collect(d) == expect_diff);
+            DestroyRBTree(u);
+            DestroyRBTree(i);
+            DestroyRBTree(d);
+        }
+        // 降序建的树: 比较器一路传给 Split
+        {
+            std::allocator<Node> alloc;
+            std::greater<int> greater;
+            auto descending = [](std::vector<int> vals) { std::reverse(vals.begin(), vals.end()); return vals; };
+            std::vector<int> ra = descending(a), rb = descending(b);
+            Node* u = Union(BuildFromSorted(ra.begin(), ra.end()), BuildFromSorted(rb.begin(), rb.end()), alloc, 0, greater);
+            assert(collect(u) == descending(expect_union));
+            Node* i = Intersection(BuildFromSorted(ra.begin(), ra.end()), BuildFromSorted(rb.begin(), rb.end()), alloc, 4, greater);
+            assert(collect(i) == descending(expect_inter));
+            Node* d = Difference(BuildFromSorted(ra.begin(), ra.end()), BuildFromSorted(rb.begin(), rb.end()), alloc, 0, greater);
+            assert(collect(d) == descending(expect_diff));
+            DestroyRBTree(u);
+            DestroyRBTree(i);
+            DestroyRBTree(d);
+        }
+
+        Node* whole = BuildFromSorted(a.begin(), a.end());
+        auto [lo, mid, hi, lo_bh, hi_bh] = Split(whole, 5000);
+        assert(mid && mid->val == 5000 && IsValidRBTree(lo) && IsValidRBTree(hi));
+        assert(collect(lo).size() == 2500 && collect(hi).size() == 7499);
+        assert(lo_bh == BlackHeight(lo) && hi_bh == BlackHeight(hi));
+        auto [joined, joined_bh] = Join(lo, lo_bh, mid, hi, hi_bh);
+        assert(IsValidRBTree(joined) && collect(joined) == a && joined_bh == BlackHeight(joined));
+
+        // Split/Join 传回的黑高始终与实际黑高一致, 包括插入修复使黑高加 1 的情况
+        std::mt19937 rng(6);
+        std::size_t bh = BlackHeight(joined);
+        for (int round = 0; round < 2000; ++round) {
+            int key = static_cast<int>(rng() % 20002) - 1;
+            SplitResult<Node> parts = Split(joined, bh, key, std::less<int>{});
+            assert(parts.left_bh == BlackHeight(parts.left) && parts.right_bh == BlackHeight(parts.right));
+            assert(IsValidRBTree(parts.left) && IsValidRBTree(parts.right));
+            JoinResult<Node> rejoined = parts.middle
+                ? Join(parts.left, parts.left_bh, parts.middle, parts.right, parts.right_bh)
+                : Join2(parts.left, parts.left_bh, parts.right, parts.right_bh);
+            assert(rejoined.black_height == BlackHeight(rejoined.root) && IsValidRBTree(rejoined.root));
+            joined = rejoined.root;
+            bh = rejoined.black_height;
+        }
+        assert(collect(joined) == a);
+        DestroyRBTree(joined);
+    }
+    std::cout << "✓ 与 std::set_* 结果一致且保持红黑性质\n";
+
+    std::cout << "删除修复与区间删除: ";
+    {
+        // 普通节点 / 紧凑节点 / 顺序统计节点都走同一套 RemoveRBTree
+        auto churn = [](auto& tree, auto check_sizes) {
+            using TreeNode = std::remove_pointer_t<decltype(tree.Root())>;
+            std::set<int> reference;
+            std::mt19937 rng(11);
+            for (int round = 0; round < 30000; ++round) {
+                int v = static_cast<int>(rng() % 5000);
+                if (rng() % 2) {
+                    tree.Insert(v);
+                    reference.insert(v);
+                } else {
+                    assert(tree.Remove(v) == (reference.erase(v) == 1));
+                }
+            }
+            assert(IsValidRBTree<TreeNode>(tree.Root()));
+            assert(std::equal(tree.begin(), tree.end(), reference.begin(), reference.end()));
+            check_sizes(tree.Root(), reference.size());
+
+            // 区间删除: 闭区间 [1000, 2999], 以及区间端点不在树中的情况
+            std::size_t expect = std::distance(reference.lower_bound(1000), reference.upper_bound(2999));
+            assert(tree.EraseRange(1000, 2999) == expect);
+            reference.erase(reference.lower_bound(1000), reference.upper_bound(2999));
+            assert(tree.EraseRange(5000, 9000) == 0 && tree.EraseRange(10, 5) == 0);
+            assert(IsValidRBTree<TreeNode>(tree.Root()));
+            assert(std::equal(tree.begin(), tree.end(), reference.begin(), reference.end()));
+            check_sizes(tree.Root(), reference.size());
+            for (int v : std::vector<int>(reference.begin(), reference.end())) {
+                assert(tree.Remove(v));
+            }
+            assert(!tree.Root());
+        };
+        auto no_sizes = [](auto*, std::size_t) {};
+        RBTree<int> plain;
+        churn(plain, no_sizes);
+        CompactRBTree<int> compact;
+        churn(compact, no_sizes);
+        RBTree<int, PoolAllocator<Node>> pooled;
+        churn(pooled, no_sizes);
+        assert(pooled.GetAllocator().Pool().Size() == 0);
+        OrderStatisticRBTree<int> ranked;
+        churn(ranked, [](auto* root, std::size_t n) {
+            assert(SubtreeSize(root) == n);
+            for (std::size_t k = 0; k < n; k += 97) {
+                assert(Rank(root, Select(root, k)->val) == k);
+            }
+        });
+    }
+    std::cout << "✓ 删除后仍是合法红黑树, 子树大小正确\n";
+
+    std::cout << "比较器与异构查找, 批量查找: ";
+    {
+        // 透明比较器: 用 std::string_view / const char* 直接查 std::string, 不构造临时 std::string
+        RBTree<std::string, std::allocator<RBNode<std::string>>, std::less<>> names;
+        for (const char* name : {"delta", "alpha", "echo", "charlie", "bravo"}) {
+            names.Insert(std::string(name));
+        }
+        std::string_view key = "charlie";
+        assert(names.Find(key) && names.Find(key)->val == "charlie");
+        assert(!names.Find(std::string_view("foxtrot")));
+        assert(names.lower_bound("c")->size() == 7 && *names.upper_bound("charlie") == "delta");
+        assert(names.Remove("echo") && !names.Find("echo"));
+
+        // 自定义顺序: 降序树上的插入/删除/区间删除/批量插入都按 comp 进行
+        RBTree<int, std::allocator<Node>, std::greater<int>> desc;
+        for (int v = 0; v < 1000; ++v) desc.Insert(v);
+        std::vector<int> extra = {1500, 1200, 1200, -7};
+        assert(desc.InsertRange(extra.begin(), extra.end()) == 3);
+        assert(desc.Remove(500) && !desc.Remove(500));
+        assert(desc.EraseRange(899, 800) == 100);
+        bool desc_ok = true;
+        CountBlackHeight(desc.Root(), desc_ok);
+        assert(desc_ok && NoRedRed(desc.Root()));
+        assert(std::is_sorted(desc.begin(), desc.end(), std::greater<int>()));
+        assert(*desc.begin() == 1500 && *desc.lower_bound(899) == 799);
+
+        // FindMany 与逐个 Find 的结果一致
+        RBTree<int> tree;
+        for (int v = 0; v < 5000; v += 3) tree.Insert(v);
+        std::vector<int> keys;
+        for (int i = 0; i < 1001; ++i) keys.push_back((i * 7919) % 5100);
+        std::vector<Node*> batched;
+        tree.FindMany(keys.begin(), keys.end(), std::back_inserter(batched));
+        assert(batched.size() == keys.size());
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            assert(batched[i] == tree.Find(keys[i]));
+        }
+    }
+    std::cout << "✓ 与逐个查找一致\n";
+
+    std::cout << "下标链接的连续存储红黑树: ";
+    {
+        static_assert(sizeof(IndexedRBNode<int>) == 16);
+        IndexedRBTree<int> tree;
+        std::set<int> reference;
+        std::mt19937 rng(13);
+        for (int i = 0; i < 20000; ++i) {
+            int v = static_cast<int>(rng() % 50000);
+            auto index = tree.Insert(v);
+            assert(tree.Value(index) == v);
+            reference.insert(v);
+        }
+        assert(tree.Size() == reference.size());
+        // 递归检查黑高与红红冲突
+        auto black_height = [&](auto&& self, std::uint32_t node) -> int {
+            if (node == tree.Nil) return 1;
+            int left = self(self, tree.Left(node)), right = self(self, tree.Right(node));
+            assert(left == right);
+            if (tree.ColorOf(node) == Color::Red) {
+                assert(tree.ColorOf(tree.Left(node)) == Color::Black && tree.ColorOf(tree.Right(node)) == Color::Black);
+            }
+            return left + (tree.ColorOf(node) == Color::Black);
+        };
+        black_height(black_height, tree.RootIndex());
+        assert(tree.ColorOf(tree.RootIndex()) == Color::Black);
+
+        std::vector<int> vals;
+        tree.Traversal([&](int v) { vals.push_back(v); });
+        assert(std::equal(vals.begin(), vals.end(), reference.begin(), reference.end()));
+        for (int v = 0; v < 50000; v += 37) {
+            assert(tree.Contains(v) == (reference.count(v) == 1));
+            auto lower = tree.LowerBound(v);
+            auto it = reference.lower_bound(v);
+            assert(it == reference.end() ? lower == tree.Nil : tree.Value(lower) == *it);
+        }
+
+        // 节点区按字节拷贝后即可恢复出同一棵树
+        std::vector<IndexedRBNode<int>> raw(tree.Nodes().size());
+        std::memcpy(raw.data(), tree.Nodes().data(), raw.size() * sizeof(raw[0]));
+        IndexedRBTree<int> restored(std::move(raw), tree.RootIndex());
+        std::vector<int> restored_vals;
+        restored.Traversal([&](int v) { restored_vals.push_back(v); });
+        assert(restored_vals == vals);
+    }
+    std::cout << "✓ 与 std::set 一致, 按字节拷贝后可恢复\n";
+
+    std::cout << "Eytzinger 只读快照: ";
+    {
+        for (int n : {0, 1, 2, 7, 8, 100, 4097}) {
+            RBTree<int> tree;
+            std::set<int> reference;
+            std::mt19937 rng(17 + n);
+            while (static_cast<int>(reference.size()) < n) {
+                int v = static_cast<int>(rng() % (4 * n + 1)) * 2;
+                tree.Insert(v);
+                reference.insert(v);
+            }
+            auto frozen = Freeze(tree);
+            assert(frozen.Size() == reference.size());
+            for (int v = -3; v <= 8 * n + 3; ++v) {
+                auto lower = reference.lower_bound(v);
+                auto upper = reference.upper_bound(v);
+                assert(lower == reference.end() ? frozen.LowerBound(v) == nullptr : *frozen.LowerBound(v) == *lower);
+                assert(upper == reference.end() ? frozen.UpperBound(v) == nullptr : *frozen.UpperBound(v) == *upper);
+                assert(frozen.Contains(v) == (reference.count(v) == 1));
+            }
+            // 解冻回可修改的红黑树, 修改后再冻结
+            auto thawed = frozen.Thaw();
+            assert(IsValidRBTree(thawed.Root()));
+            thawed.Insert(-1);
+            reference.insert(-1);
+            std::vector<int> vals;
+            Freeze(thawed).ForEach([&](int v) { vals.push_back(v); });
+            assert(std::equal(vals.begin(), vals.end(), reference.begin(), reference.end()));
+        }
+        // 降序比较器
+        std::vector<int> desc {9, 7, 5, 3, 1};
+        FrozenRBTree<int, std::greater<int>> frozen(desc.begin(), desc.end());
+        assert(*frozen.LowerBound(6) == 5 && *frozen.UpperBound(5) == 3 && frozen.LowerBound(0) == nullptr);
+
+        // 元素的拷贝中途抛出异常: 已构造的元素全部析构, 不泄漏
+        static int live = 0, copies_left = 0;
+        struct Fragile {
+            int v;
+            Fragile(int v) : v(v) { ++live; }
+            Fragile(const Fragile& other) : v(other.v) {
+                if (copies_left-- == 0) throw std::runtime_error("copy");
+                ++live;
+            }
+            ~Fragile() { --live; }
+            bool operator<(const Fragile& other) const { return v < other.v; }
+        };
+        {
+            std::vector<Fragile> source;
+            source.reserve(20);
+            for (int i = 0; i < 20; ++i) source.emplace_back(i);
+            const int before = live;
+            for (int fail_at : {0, 1, 7, 19}) {
+                copies_left = fail_at;
+                bool thrown = false;
+                try {
+                    FrozenRBTree<Fragile> broken(source.begin(), source.end());
+                } catch (const std::runtime_error&) {
+                    thrown = true;
+                }
+                assert(thrown && live == before);
+            }
+            copies_left = 100;
+            FrozenRBTree<Fragile> whole(source.begin(), source.end());
+            assert(live == before + 20 && whole.Contains(Fragile(13)));
+            copies_left = 5;
+            bool thrown = false;
+            try {
+                FrozenRBTree<Fragile> copy(whole);
+            } catch (const std::runtime_error&) {
+                thrown = true;
+            }
+            assert(thrown && live == before + 20);
+        }
+        assert(live == 0);
+    }
+    std::cout << "✓ 与 std::set 一致, 可解冻回红黑树\n";
+
+    std::cout << "区间树 (子树最大右端点): ";
+    {
+        using Range = Interval<int>;
+        using INode = IntervalRBNode<int>;
+        IntervalRBTree<int> ranges;
+        std::set<Range> reference;
+        std::mt19937 rng(19);
+        // 检查每个节点的 max_hi 都等于子树中最大的右端点
+        auto check_max = [&](auto&& self, INode* node) -> int {
+            if (!node) return std::numeric_limits<int>::min();
+            int expect = std::max({node->val.hi, self(self, node->left), self(self, node->right)});
+            assert(node->max_hi == expect);
+            return expect;
+        };
+        auto check_queries = [&] {
+            for (int q = 0; q < 200; ++q) {
+                int lo = static_cast<int>(rng() % 10000);
+                int hi = lo + static_cast<int>(rng() % 300);
+                std::vector<Range> expect;
+                for (const Range& r : reference) {
+                    if (r.Overlaps(lo, hi)) expect.push_back(r);
+                }
+                auto hits = Overlapping(ranges.Root(), lo, hi);
+                assert(hits.size() == expect.size());
+                for (std::size_t i = 0; i < hits.size(); ++i) assert(hits[i]->val == expect[i]);
+                std::size_t stabbed = 0;
+                for (const Range& r : reference) stabbed += r.lo <= lo && lo <= r.hi;
+                assert(Overlapping(ranges.Root(), lo).size() == stabbed);
+            }
+        };
+        for (int i = 0; i < 5000; ++i) {
+            int lo = static_cast<int>(rng() % 10000);
+            Range r {lo, lo + static_cast<int>(rng() % 200)};
+            ranges.Insert(r);
+            reference.insert(r);
+        }
+        assert(IsValidRBTree<INode>(ranges.Root()));
+        check_max(check_max, ranges.Root());
+        check_queries();
+        // 删除走 RemoveFixup 的旋转, max_hi 同样保持正确
+        std::vector<Range> all(reference.begin(), reference.end());
+        std::shuffle(all.begin(), all.end(), rng);
+        for (std::size_t i = 0; i < all.size() / 2; ++i) {
+            assert(ranges.Remove(all[i]));
+            reference.erase(all[i]);
+        }
+        assert(IsValidRBTree<INode>(ranges.Root()));
+        check_max(check_max, ranges.Root());
+        check_queries();
+        assert(Overlapping(ranges.Root(), 5, 4).empty());
+    }
+    std::cout << "✓ 与线性扫描一致, 删除后 max_hi 仍正确\n";
+
+    std::cout << "手指查找与带提示插入: ";
+    {
+        std::mt19937 rng(23);
+        std::vector<std::vector<int>> streams(4);
+        for (int i = 0; i < 5000; ++i) streams[0].push_back(i);
+        for (int i = 5000; i > 0; --i) streams[1].push_back(i);
+        // 基本有序: 时间戳带少量抖动和重复
+        for (int i = 0; i < 5000; ++i) streams[2].push_back(i * 4 + static_cast<int>(rng() % 16));
+        for (int i = 0; i < 5000; ++i) streams[3].push_back(static_cast<int>(rng() % 8000));
+        for (const auto& stream : streams) {
+            RBTree<int> tree;
+            OrderStatisticRBTree<int> ranked;
+            std::set<int> reference;
+            RBNode<int>* last = nullptr;
+            OSRBNode<int>* ranked_last = nullptr;
+            for (int v : stream) {
+                last = tree.InsertHint(last, v);
+                assert(last->val == v);
+                ranked_last = ranked.InsertHint(ranked_last, v);
+                reference.insert(v);
+            }
+            assert(IsValidRBTree(tree.Root()));
+            assert(IsValidRBTree<OSRBNode<int>>(ranked.Root()));
+            assert(SubtreeSize(ranked.Root()) == reference.size());
+            assert(std::equal(tree.begin(), tree.end(), reference.begin(), reference.end()));
+            // 从任意手指出发都能找到同样的结果
+            RBNode<int>* finger = tree.Find(*reference.begin());
+            for (int v = -5; v < 25000; v += 7) {
+                RBNode<int>* found = tree.FingerFind(finger, v);
+                assert((found != nullptr) == (reference.count(v) == 1));
+                if (found) {
+                    assert(found->val == v);
+                    finger = found;
+                }
+            }
+            assert(tree.FingerFind(nullptr, *reference.rbegin())->val == *reference.rbegin());
+            assert(tree.Leftmost()->val == *reference.begin() && tree.Rightmost()->val == *reference.rbegin());
+        }
+
+        // 最小 / 最大节点在每种修改之后都与 Minimum / Maximum 一致
+        RBTree<int> tree;
+        std::set<int> reference;
+        auto check_ends = [&] {
+            assert(tree.Leftmost() == Minimum(tree.Root()) && tree.Rightmost() == Maximum(tree.Root()));
+            assert(reference.empty() ? !tree.Leftmost() : tree.Leftmost()->val == *reference.begin());
+        };
+        check_ends();
+        RBNode<int>* last = nullptr;
+        for (int round = 0; round < 20000; ++round) {
+            int v = static_cast<int>(rng() % 3000);
+            switch (rng() % 6) {
+            case 0: tree.Insert(v); reference.insert(v); break;
+            case 1: last = tree.InsertHint(last, v); reference.insert(v); break;
+            case 2: last = tree.InsertHint(last, 3000 + round); reference.insert(3000 + round); break;
+            case 3: case 4:
+                if (!reference.empty() && rng() % 2) v = rng() % 2 ? *reference.begin() : *reference.rbegin();
+                if (last && last->val == v) last = nullptr;
+                assert(tree.Remove(v) == (reference.erase(v) == 1));
+                break;
+            default:
+                if (round % 50 == 0) {
+                    int lo = v, hi = v + static_cast<int>(rng() % 400);
+                    tree.EraseRange(lo, hi);
+                    reference.erase(reference.lower_bound(lo), reference.upper_bound(hi));
+                    last = nullptr;
+                }
+            }
+            check_ends();
+        }
+        std::vector<int> sorted {2, 4, 6};
+        tree.BuildFromSorted(sorted.begin(), sorted.end());
+        reference = {2, 4, 6};
+        check_ends();
+        RBTree<int> moved = std::move(tree);
+        assert(!tree.Leftmost() && !tree.Rightmost() && moved.Leftmost()->val == 2 && moved.Rightmost()->val == 6);
+        moved.Clear();
+        assert(!moved.Leftmost() && !moved.Rightmost() && moved.begin() == moved.end());
+    }
+    std::cout << "✓ 有序/逆序/基本有序/随机输入均与 std::set 一致\n";
+
+    std::cout << "树形统计与热路径计数器: ";
+    {
+        RBTree<int> tree;
+        ResetCounters();
+        for (int i = 0; i < 4096; ++i) tree.Insert(i);
+        TreeStats stats = tree.Stats();
+        assert(stats.size == 4096);
+        bool ok = true;
+        assert(static_cast<int>(stats.black_height) + 1 == CountBlackHeight(tree.Root(), ok) && ok);
+        assert(stats.max_depth < 2 * stats.black_height);
+        std::size_t total = 0;
+        for (std::size_t count : stats.black_height_histogram) total += count;
+        assert(total == stats.size && stats.depth_histogram[0] == 1);
+        assert(stats.average_depth > 1 && stats.average_depth <= stats.max_depth);
+        assert(RBTreeTools::Stats<RBNode<int>>(nullptr).size == 0);
+
+        for (int i = 0; i < 4096; ++i) assert(tree.Find(i));
+        for (int i = 0; i < 4096; i += 2) tree.Remove(i);
+        const OpCounters& counters = LocalCounters();
+        if constexpr (StatsEnabled) {
+            // 有序插入每次都走 Case 1 或 Case 3, 旋转次数与修复循环次数都是 O(n)
+            assert(counters.rotations > 0 && counters.rotations < 4096);
+            assert(counters.insert_fixup_iterations > 0 && counters.recolors > 0);
+            assert(counters.remove_fixup_iterations > 0);
+            // Remove 内部也调用 Find
+            assert(counters.finds == 4096 + 2048);
+            assert(counters.find_comparisons >= counters.finds);
+        } else {
+            assert(counters.rotations == 0 && counters.finds == 0);
+        }
+
+        // 其他线程的计数: 存活时与退出后都计入 SnapshotCounters()
+        const OpCounters before = SnapshotCounters();
+        std::latch counted(2), done(1);
+        std::thread worker([&] {
+            for (int i = 0; i < 100; ++i) tree.Find(i);
+            assert(LocalCounters().finds == (StatsEnabled ? 100 : 0));
+            counted.count_down();
+            done.wait();
+            for (int i = 0; i < 50; ++i) tree.Find(i);
+        });
+        counted.arrive_and_wait();
+        assert(SnapshotCounters().finds - before.finds == (StatsEnabled ? 100 : 0));
+        done.count_down();
+        worker.join();
+        const OpCounters after = SnapshotCounters();
+        assert(after.finds - before.finds == (StatsEnabled ? 150 : 0));
+        assert(after.find_comparisons >= after.finds);
+        // 清零只影响当前线程
+        ResetCounters();
+        assert(LocalCounters().finds == 0 && SnapshotCounters().finds == after.finds - counters.finds);
+    }
+    std::cout << "✓\n";
+
+    std::cout << "图 (CSR 邻接表): ";
+    {
+        using namespace Moonlight::Graph;
+        GraphInstance<int, double> graph;
+        graph.AddEdge(0, 1, 1.5).AddEdge(1, 2, 2.0).AddEdge(2, 0, 3.0).AddVertex();
+        // 无向边: (1, 0) 与 (0, 1) 是同一条边
+        graph.AddEdge(1, 0, 9.0).UpdateEdge(1, 0, 4.0);
+        const auto& small = graph.List();
+        assert(small.VertexCount() == 4 && small.ArcCount() == 6);
+        const std::vector<uint64_t> offsets {0, 2, 4, 6, 6};
+        const std::vector<uint64_t> targets {1, 2, 0, 2, 0, 1};
+        assert(std::equal(small.Offsets().begin(), small.Offsets().end(), offsets.begin(), offsets.end()));
+        assert(std::equal(small.Targets().begin(), small.Targets().end(), targets.begin(), targets.end()));
+        assert(small.Weights(0)[0] == 4.0 && small.Weights(0)[1] == 3.0 && small.Neighbors(3).empty());
+        assert(&graph.List() == &small);
+
+        // 随机图: 检查对称性与排序; 线程数不同时三个数组必须完全相同
+        std::mt19937_64 rng(19);
+        const uint64_t n = 3000;
+        std::unordered_set<Edge<double>, Edge<double>::EdgeHash, Edge<double>::EdgeEqual> edges;
+        GraphInstance<int, double> random_graph;
+        random_graph.AddNVertex(n, 0);
+        for (int i = 0; i < 100000; ++i) {
+            // 每 16 条边有一条落在前 8 个顶点上, 制造几个度数很大的顶点
+            uint64_t u = rng() % n, v = rng() % (i % 16 ? n : 8);
+            double w = static_cast<double>(rng() % 1000);
+            if (edges.insert(Edge<double>(u, v, w)).second) {
+                random_graph.AddEdge(u, v, w);
+            }
+        }
+        const auto& csr = random_graph.List();
+        assert(csr.VertexCount() == n);
+        std::size_t arcs = 0;
+        for (uint64_t v = 0; v < n; ++v) {
+            auto neighbors = csr.Neighbors(v);
+            auto weights = csr.Weights(v);
+            assert(neighbors.size() == csr.Degree(v) && weights.size() == neighbors.size());
+            assert(std::adjacent_find(neighbors.begin(), neighbors.end(), std::greater_equal<>()) == neighbors.end());
+            for (std::size_t i = 0; i < neighbors.size(); ++i) {
+                // 每个条目都能在对端找到方向相反、权重相同的条目
+                auto back = csr.Neighbors(neighbors[i]);
+                auto pos = std::lower_bound(back.begin(), back.end(), v);
+                assert(pos != back.end() && *pos == v);
+                assert(csr.Weights(neighbors[i])[pos - back.begin()] == weights[i]);
+                arcs += neighbors[i] == v ? 2 : 1;
+            }
+        }
+        assert(arcs == 2 * edges.size() && csr.Degree(0) > csr.Degree(n - 1));
+        for (unsigned threads : {1u, 3u, 8u}) {
+            AdjacencyList<int, double> rebuilt(n, edges, threads);
+            assert(std::ranges::equal(rebuilt.Offsets(), csr.Offsets()));
+            assert(std::ranges::equal(rebuilt.Targets(), csr.Targets()));
+            assert(std::ranges::equal(rebuilt.EdgeWeights(), csr.EdgeWeights()));
+        }
+        GraphInstance<int, double> moved(std::move(random_graph));
+        assert(moved.EdgeCount() == edges.size() && moved.List().ArcCount() == csr.ArcCount());
+        moved.AddEdge(n, 0);
+        assert(moved.List().VertexCount() == n + 1 && moved.List().Neighbors(n).size() == 1);
+    }
+    std::cout << "✓\n";
+
+    std::cout << "图 (方向优化 BFS): ";
+    {
+        using namespace Moonlight::Graph;
+        auto& manager = GraphManager<int, double>::Instance();
+        auto& graph = manager.GetAEmptyGraph();
+        assert(&manager.GetGraph(0) == &graph);
+        // 一个稠密的随机部分 (会切换到自底向上) 加一条长链 (frontier 变小后切回自顶向下), 再加一个孤立点
+        std::mt19937_64 rng(20);
+        const uint64_t dense = 4000, chain = 300;
+        for (int i = 0; i < 40000; ++i) graph.AddEdge(rng() % dense, rng() % dense);
+        for (uint64_t v = dense; v < dense + chain; ++v) graph.AddEdge(v - 1, v);
+        graph.AddVertex();
+        const auto& csr = graph.List();
+        const uint64_t n = csr.VertexCount();
+
+        std::vector<uint64_t> expected(n, Unreached);
+        std::vector<uint64_t> queue {0};
+        expected[0] = 0;
+        for (std::size_t head = 0; head < queue.size(); ++head) {
+            for (uint64_t v : csr.Neighbors(queue[head])) {
+                if (expected[v] == Unreached) {
+                    expected[v] = expected[queue[head]] + 1;
+                    queue.push_back(v);
+                }
+            }
+        }
+        auto check = [&](const BFSResult& result) {
+            assert(result.distance == expected);
+            for (uint64_t v = 1; v < n; ++v) {
+                if (!result.Reached(v)) continue;
+                uint64_t p = result.parent[v];
+                auto neighbors = csr.Neighbors(v);
+                assert(std::binary_search(neighbors.begin(), neighbors.end(), p));
+                assert(result.distance[p] + 1 == result.distance[v]);
+            }
+            assert(result.parent[0] == 0 && !result.Reached(n - 1));
+        };
+        BFSResult hybrid = BFS(graph, 0);
+        check(hybrid);
+        assert(hybrid.bottom_up_steps > 0 && hybrid.top_down_steps > 0);
+        BFSOptions top_down;
+        top_down.alpha = 0;
+        BFSResult plain = BFS(csr, 0, top_down);
+        check(plain);
+        assert(plain.bottom_up_steps == 0);
+        for (unsigned threads : {2u, 4u}) {
+            BFSOptions options;
+            options.threads = threads;
+            std::atomic<uint64_t> visited {0};
+            check(BFS(graph, 0, [&](uint64_t, uint64_t, uint64_t) { visited.fetch_add(1); }, options));
+            assert(visited == static_cast<uint64_t>(std::count_if(expected.begin(), expected.end(),
+                                                                   [](uint64_t d) { return d != Unreached; })));
+        }
+        // 找到链尾之前的某个顶点后提前结束, 更远的层不再扩展
+        const uint64_t target = dense + chain / 2;
+        BFSResult partial = BFS(graph, 0, [&](uint64_t v, uint64_t, uint64_t) { return v != target; });
+        assert(partial.Reached(target) && partial.distance[target] == expected[target]);
+        assert(!partial.Reached(dense + chain - 1));
+        manager.DestoryAGraph(0);
+        assert(manager.GetAEmptyGraph().VertexCount() == 0);
+        manager.DestoryAGraph(0);
+    }
+    std::cout << "✓\n";
+
+    std::cout << "图 (最短路: Dijkstra / delta-stepping): ";
+    {
+        using namespace Moonlight::Graph;
+        // 两种堆单独与 std::priority_queue 对照
+        std::mt19937_64 rng(21);
+        RadixHeap<uint32_t, int> radix;
+        std::priority_queue<uint32_t, std::vector<uint32_t>, std::greater<>> expected_keys;
+        uint32_t last = 0;
+        for (int round = 0; round < 20000; ++round) {
+            if (rng() % 3 || radix.Empty()) {
+                uint32_t key = last + static_cast<uint32_t>(rng() % 5000);
+                radix.Push(key, round);
+                expected_keys.push(key);
+            } else {
+                last = radix.Pop().first;
+                assert(last == expected_keys.top());
+                expected_keys.pop();
+            }
+        }
+        PairingHeap<double> pairing(1000);
+        std::vector<double> keys(1000);
+        for (uint64_t v = 0; v < 1000; ++v) pairing.Push(v, keys[v] = static_cast<double>(rng() % 100000));
+        for (int i = 0; i < 3000; ++i) {
+            uint64_t v = rng() % 1000;
+            keys[v] -= static_cast<double>(rng() % 100);
+            pairing.DecreaseKey(v, keys[v]);
+        }
+        double previous = -std::numeric_limits<double>::infinity();
+        for (int i = 0; i < 1000; ++i) {
+            uint64_t v = pairing.Pop();
+            assert(pairing.KeyOf(v) == keys[v] && keys[v] >= previous);
+            previous = keys[v];
+        }
+        assert(pairing.Empty());
+
+        // 同一张图分别用整数与浮点边权, 与二叉堆 Dijkstra 对照
+        auto check = [&](auto& graph, auto weight_of) {
+            using Weight = decltype(weight_of(0));
+            const auto& csr = graph.List();
+            const uint64_t n = csr.VertexCount();
+            std::vector<Weight> expected(n, InfiniteDistance<Weight>);
+            std::priority_queue<std::pair<Weight, uint64_t>, std::vector<std::pair<Weight, uint64_t>>, std::greater<>> queue;
+            expected[0] = 0;
+            queue.emplace(0, 0);
+            while (!queue.empty()) {
+                auto [d, u] = queue.top();
+                queue.pop();
+                if (d != expected[u]) continue;
+                for (std::size_t i = 0; i < csr.Degree(u); ++i) {
+                    uint64_t v = csr.Neighbors(u)[i];
+                    if (d + csr.Weights(u)[i] < expected[v]) queue.emplace(expected[v] = d + csr.Weights(u)[i], v);
+                }
+            }
+            auto valid_tree = [&](const ShortestPathResult<Weight>& result) {
+                assert(result.distance == expected);
+                for (uint64_t v = 1; v < n; ++v) {
+                    if (!result.Reached(v)) {
+                        assert(expected[v] == InfiniteDistance<Weight>);
+                        continue;
+                    }
+                    // 沿 parent 一定能走回起点, 且每一步都是紧边
+                    uint64_t steps = 0;
+                    for (uint64_t x = v; x != 0; x = result.parent[x], ++steps) assert(steps < n);
+                    auto neighbors = csr.Neighbors(v);
+                    auto at = std::lower_bound(neighbors.begin(), neighbors.end(), result.parent[v]) - neighbors.begin();
+                    assert(result.distance[result.parent[v]] + csr.Weights(v)[at] == result.distance[v]);
+                }
+            };
+            valid_tree(Dijkstra(graph, 0));
+            valid_tree(Dijkstra(graph, 0, Unreached, DijkstraHeap::Pairing));
+            for (unsigned threads : {1u, 4u}) {
+                DeltaSteppingOptions<Weight> options;
+                options.threads = threads;
+                valid_tree(DeltaStepping(graph, 0, options));
+                options.delta = weight_of(7);
+                valid_tree(DeltaStepping(csr, 0, options));
+            }
+            // 点到点: 目标出堆即停止, 它的距离已经是最终结果
+            uint64_t target = n / 2;
+            auto partial = Dijkstra(csr, 0, target);
+            assert(partial.distance[target] == expected[target]);
+        };
+        GraphInstance<int, int> integer_graph;
+        GraphInstance<int, double> real_graph;
+        const uint64_t n = 5000;
+        for (int i = 0; i < 30000; ++i) {
+            uint64_t u = rng() % n, v = rng() % n;
+            // 含零权边
+            int w = static_cast<int>(rng() % 50);
+            integer_graph.AddEdge(u, v, w);
+            real_graph.AddEdge(u, v, w * 0.37 + 0.01);
+        }
+        real_graph.AddEdge(n, n + 1, 1.0);
+        check(integer_graph, [](int w) { return w; });
+        check(real_graph, [](int w) { return static_cast<double>(w); });
+    }
+    std::cout << "✓\n";
+
+    std::cout << "图 (位图邻接矩阵): ";
+    {
+        using namespace Moonlight::Graph;
+        GraphInstance<int, double> graph;
+        std::mt19937_64 rng(22);
+        const uint64_t n = 300;
+        std::vector<std::vector<bool>> dense(n, std::vector<bool>(n, false));
+        graph.AddNVertex(n, 0);
+        for (uint64_t u = 0; u < n; ++u) {
+            for (uint64_t v = u; v < n; ++v) {
+                if (rng() % 5 == 0 && (u != v || u % 7 == 0)) {
+                    graph.AddEdge(u, v, static_cast<double>(u + v));
+                    dense[u][v] = dense[v][u] = true;
+                }
+            }
+        }
+        const auto& matrix = graph.Matrix();
+        assert(matrix.Mode() == MatrixMode::Bitset && matrix.VertexCount() == n);
+        uint64_t triangles = 0;
+        for (uint64_t u = 0; u < n; ++u) {
+            auto row = matrix.Row(u);
+            // 每行补齐到 256 位, 行首 32 字节对齐, 补齐部分为 0
+            assert(row.size() % 4 == 0 && reinterpret_cast<std::uintptr_t>(row.data()) % 32 == 0);
+            assert(row.back() >> (n % 64) == 0);
+            assert(matrix.Degree(u) == static_cast<uint64_t>(std::count(dense[u].begin(), dense[u].end(), true)));
+            for (uint64_t v = 0; v < n; ++v) {
+                assert(matrix.HasEdge(u, v) == dense[u][v]);
+                if (v % 13) continue;
+                uint64_t common = 0;
+                for (uint64_t w = 0; w < n; ++w) common += dense[u][w] && dense[v][w];
+                assert(matrix.CommonNeighbors(u, v) == common);
+                uint64_t together = matrix.Degree(u) + matrix.Degree(v) - common;
+                assert(matrix.Jaccard(u, v) == (together ? static_cast<double>(common) / together : 0.0));
+            }
+            for (uint64_t v = u + 1; v < n; ++v) {
+                if (!dense[u][v]) continue;
+                for (uint64_t w = v + 1; w < n; ++w) triangles += dense[u][w] && dense[v][w];
+            }
+        }
+        assert(matrix.CountTriangles() == triangles && matrix.CountTriangles(4) == triangles);
+        std::vector<std::pair<uint64_t, uint64_t>> pairs {{0, 1}, {5, 5}, {17, 299}};
+        std::vector<uint64_t> commons(pairs.size());
+        std::vector<double> similarities(pairs.size());
+        matrix.CommonNeighbors(pairs, commons);
+        matrix.Jaccard(pairs, similarities);
+        for (std::size_t i = 0; i < pairs.size(); ++i) {
+            assert(commons[i] == matrix.CommonNeighbors(pairs[i].first, pairs[i].second));
+            assert(similarities[i] == matrix.Jaccard(pairs[i].first, pairs[i].second));
+        }
+        // 换成带权模式时重新构造, 并且按 AddEdge 时的权重取值
+        const auto& weighted = graph.Matrix(MatrixMode::Weighted);
+        assert(weighted.Mode() == MatrixMode::Weighted);
+        for (uint64_t u = 0; u < n; u += 11) {
+            for (uint64_t v = 0; v < n; ++v) {
+                assert(weighted.At(u, v) == (dense[u][v] ? static_cast<double>(u + v) : 0.0));
+            }
+        }
+    }
+    std::cout << "✓\n";
+
+    std::cout << "图 (增量修改 + CSR 合并): ";
+    {
+        using namespace Moonlight::Graph;
+        using EdgeSet = std::unordered_set<Edge<double>, Edge<double>::EdgeHash, Edge<double>::EdgeEqual>;
+        GraphInstance<int, double> graph;
+        std::mt19937_64 rng(23);
+        uint64_t n = 400;
+        // 镜像: {min, max} -> 权重
+        std::map<std::pair<uint64_t, uint64_t>, double> mirror;
+        auto key = [](uint64_t u, uint64_t v) { return std::make_pair(std::min(u, v), std::max(u, v)); };
+        graph.AddNVertex(n, 0);
+        for (int i = 0; i < 3000; ++i) {
+            uint64_t u = rng() % n, v = rng() % n;
+            if (mirror.emplace(key(u, v), static_cast<double>(i)).second) graph.AddEdge(u, v, static_cast<double>(i));
+        }
+        auto check_reads = [&] {
+            for (uint64_t v = 0; v < n; ++v) {
+                std::vector<std::pair<uint64_t, double>> expected, actual;
+                for (uint64_t u = 0; u < n; ++u) {
+                    auto it = mirror.find(key(u, v));
+                    if (it != mirror.end()) expected.emplace_back(u, it->second);
+                }
+                graph.ForEachNeighbor(v, [&](uint64_t u, double w) { actual.emplace_back(u, w); });
+                assert(actual == expected);
+            }
+        };
+        auto mutate = [&](int count) {
+            for (int i = 0; i < count; ++i) {
+                uint64_t u = rng() % n, v = rng() % n;
+                double w = static_cast<double>(rng() % 1000);
+                switch (rng() % 3) {
+                    case 0: graph.AddEdge(u, v, w); mirror.emplace(key(u, v), w); break;
+                    case 1: graph.UpdateEdge(u, v, w); if (mirror.count(key(u, v))) mirror[key(u, v)] = w; break;
+                    default: graph.RemoveEdge(u, v); mirror.erase(key(u, v)); break;
+                }
+            }
+        };
+        const auto& list = graph.List();
+        assert(graph.PendingMutations() == 0);
+        mutate(1500);
+        // 修改先记在 delta 中, ForEachNeighbor 读到的是 CSR + delta
+        assert(graph.PendingMutations() > 0);
+        check_reads();
+        // 修改之后才构造的位图随之就地更新
+        const auto& matrix = graph.Matrix();
+        mutate(1500);
+        check_reads();
+        for (uint64_t u = 0; u < n; ++u) {
+            uint64_t degree = 0;
+            for (uint64_t v = 0; v < n; ++v) {
+                bool has = mirror.count(key(u, v)) > 0;
+                assert(matrix.HasEdge(u, v) == has);
+                degree += has;
+            }
+            assert(matrix.Degree(u) == degree);
+        }
+        // 加入新的顶点, 合并后与由同样的边重新构造的 CSR 完全一致
+        graph.AddEdge(n + 5, 3, 1.5);
+        mirror.emplace(key(n + 5, 3), 1.5);
+        n += 6;
+        graph.Flush();
+        assert(&graph.List() == &list && graph.PendingMutations() == 0);
+        auto compare = [&] {
+            EdgeSet edges;
+            for (const auto& [uv, w] : mirror) edges.insert(Edge<double>(uv.first, uv.second, w));
+            AdjacencyList<int, double> rebuilt(n, edges);
+            const auto& merged = graph.List();
+            assert(merged.VertexCount() == n);
+            assert(std::ranges::equal(merged.Offsets(), rebuilt.Offsets()));
+            assert(std::ranges::equal(merged.Targets(), rebuilt.Targets()));
+            assert(std::ranges::equal(merged.EdgeWeights(), rebuilt.EdgeWeights()));
+        };
+        compare();
+        assert(graph.List().Degree(n - 2) == 0);
+        check_reads();
+        // 修改数达到阈值时在修改时就合并, delta 不会无限增长
+        mutate(10000);
+        assert(graph.PendingMutations() < 4096);
+        check_reads();
+        compare();
+    }
+    std::cout << "✓\n";
+
+    std::cout << "图 (并行边表加载): ";
+    {
+        using namespace Moonlight::Graph;
+        const std::string path = (std::filesystem::temp_directory_path() / "moonlight_edges.txt").string();
+        std::mt19937_64 rng(24);
+        // 各种分隔符 / 注释 / CRLF / 多余的列 / 无法解析的行, 最后一行没有换行符
+        std::string text = "# SNAP 风格的注释\n% Matrix Market 风格的注释\n\n";
+        GraphInstance<int, double> expected;
+        uint64_t malformed = 0;
+        for (int i = 0; i < 20000; ++i) {
+            uint64_t u = rng() % 3000, v = rng() % 3000;
+            switch (rng() % 5) {
+                case 0: text += std::to_string(u) + "\t" + std::to_string(v) + "\n"; expected.AddEdge(u, v); break;
+                case 1: text += std::to_string(u) + "," + std::to_string(v) + ",0.25\r\n"; expected.AddEdge(u, v, 0.25); break;
+                case 2: text += "  " + std::to_string(u) + " " + std::to_string(v) + " " + std::to_string(i) + " 1700000000\n";
+                        expected.AddEdge(u, v, i); break;
+                case 3: text += std::to_string(u) + "x " + std::to_string(v) + "\n"; ++malformed; break;
+                default: text += std::to_string(u) + " " + std::to_string(v) + " 1e-3\n"; expected.AddEdge(u, v, 1e-3); break;
+            }
+        }
+        text += "7 8 2.5";
+        expected.AddEdge(7, 8, 2.5);
+        std::ofstream(path, std::ios::binary) << text;
+
+        auto same_graph = [&](const GraphInstance<int, double>& graph) {
+            assert(graph.EdgeCount() == expected.EdgeCount() && graph.VertexCount() == expected.VertexCount());
+            assert(std::ranges::equal(graph.List().Offsets(), expected.List().Offsets()));
+            assert(std::ranges::equal(graph.List().Targets(), expected.List().Targets()));
+            assert(std::ranges::equal(graph.List().EdgeWeights(), expected.List().EdgeWeights()));
+        };
+        // 4 KB 一块, 4 个线程: 很多轮, 块的边界落在行中间
+        auto& manager = Moonlight::Graph::GraphManager<int, double>::Instance();
+        auto& graph = manager.GetAEmptyGraph();
+        auto stats = LoadEdgeList(graph, path, {.threads = 4, .chunk_bytes = 4096});
+        assert(stats.threads == 4 && stats.bytes == text.size());
+        assert(stats.lines == 20000 + 4 && stats.malformed == malformed);
+        assert(stats.edges == 20000 + 1 - malformed && stats.inserted == expected.EdgeCount());
+        same_graph(graph);
+        // 单线程一轮读完, 结果相同
+        GraphInstance<int, double> serial;
+        assert(LoadEdgeList(serial, path, {.threads = 1}).threads == 1);
+        same_graph(serial);
+        bool thrown = false;
+        try {
+            LoadEdgeList(serial, path + ".missing");
+        } catch (const std::system_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+        std::filesystem::remove(path);
+        manager.DestoryAGraph(0);
+    }
+    std::cout << "✓\n";
+
+    std::cout << "图 (mmap 快照): ";
+    {
+        using namespace Moonlight::Graph;
+        using Snapshot = GraphSnapshot<int, double>;
+        const auto directory = std::filesystem::temp_directory_path();
+        const std::string path = (directory / "moonlight_graph.snapshot").string();
+        GraphInstance<int, double> graph;
+        std::mt19937_64 rng(25);
+        // 顶点 0..499 有值, 500..509 只作为空位存在 (未初始化), 510 由 AddEdge 初始化
+        for (int v = 0; v < 500; ++v) graph.AddVertex(v * 3);
+        for (int i = 0; i < 4000; ++i) graph.AddEdge(rng() % 500, rng() % 500, static_cast<double>(i) / 4);
+        graph.AddEdge(510, 7, -1.0);
+        graph.List();
+        graph.RemoveEdge(510, 7).AddEdge(510, 8, 2.0);
+        Snapshot::Save(graph, path);
+        assert(!std::filesystem::exists(path + ".tmp"));
+
+        auto snapshot = Snapshot::Open(path);
+        assert(snapshot.Verify());
+        assert(snapshot.VertexCount() == graph.VertexCount() && snapshot.EdgeCount() == graph.EdgeCount());
+        assert(snapshot.ArcCount() == graph.List().ArcCount());
+        assert(std::ranges::equal(snapshot.Offsets(), graph.List().Offsets()));
+        assert(std::ranges::equal(snapshot.Targets(), graph.List().Targets()));
+        assert(std::ranges::equal(snapshot.EdgeWeights(), graph.List().EdgeWeights()));
+        assert(reinterpret_cast<std::uintptr_t>(snapshot.Targets().data()) % 64 == 0);
+        for (uint64_t v = 0; v < snapshot.VertexCount(); ++v) {
+            assert(snapshot.Vertex(v) == graph.GetVertex(v));
+            auto neighbors = snapshot.Neighbors(v);
+            for (std::size_t i = 0; i < neighbors.size(); ++i) {
+                assert(snapshot.EdgeWeight(v, neighbors[i]) == snapshot.Weights(v)[i]);
+                assert(snapshot.EdgeWeight(neighbors[i], v) == snapshot.Weights(v)[i]);
+            }
+        }
+        assert(!snapshot.Vertex(505) && snapshot.Vertex(510) == 0 && snapshot.Vertex(3) == 9 && !snapshot.Vertex(9999));
+        assert(snapshot.HasEdge(8, 510) && !snapshot.HasEdge(7, 510) && !snapshot.HasEdge(9999, 1));
+
+        // 快照与原来的图无关: 图销毁之后快照仍可读
+        auto moved = std::move(snapshot);
+        graph = GraphInstance<int, double>();
+        assert(moved.EdgeWeight(510, 8) == 2.0);
+
+        auto expect_throw = [](auto&& open) {
+            bool thrown = false;
+            try {
+                open();
+            } catch (const std::runtime_error&) {
+                thrown = true;
+            }
+            assert(thrown);
+        };
+        // 类型大小不符
+        expect_throw([&] { GraphSnapshot<int, float>::Open(path); });
+        // 数据段的一个字节被改动: 头部完好, 只有校验时才发现
+        const std::string corrupted = (directory / "moonlight_graph_corrupted.snapshot").string();
+        std::filesystem::copy_file(path, corrupted, std::filesystem::copy_options::overwrite_existing);
+        {
+            std::fstream file(corrupted, std::ios::in | std::ios::out | std::ios::binary);
+            file.seekp(static_cast<std::streamoff>(std::filesystem::file_size(corrupted) - 3));
+            file.put('\x5a');
+        }
+        assert(!Snapshot::Open(corrupted).Verify());
+        expect_throw([&] { Snapshot::Open(corrupted, {.verify = true}); });
+        // 截断
+        std::filesystem::resize_file(corrupted, std::filesystem::file_size(corrupted) / 2);
+        expect_throw([&] { Snapshot::Open(corrupted); });
+        std::filesystem::resize_file(corrupted, 10);
+        expect_throw([&] { Snapshot::Open(corrupted); });
+        // 伪造的文件: 改动之后重新计算所有校验和, 只有结构检查能发现
+        auto forge = [&](auto&& edit) {
+            std::ifstream in(path, std::ios::binary);
+            std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+            SnapshotHeader header;
+            std::memcpy(&header, bytes.data(), sizeof(header));
+            edit(header, bytes);
+            for (auto& section : header.sections) {
+                section.checksum = Moonlight::Graph::_detail::Checksum64(bytes.data() + section.offset, section.bytes);
+            }
+            header.header_checksum = Moonlight::Graph::_detail::HeaderChecksum(header);
+            std::memcpy(bytes.data(), &header, sizeof(header));
+            std::ofstream(corrupted, std::ios::binary | std::ios::trunc).write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        };
+        auto section_word = [](SnapshotHeader& header, std::vector<char>& bytes, SnapshotSection s, std::size_t i) {
+            return reinterpret_cast<uint64_t*>(bytes.data() + header.sections[static_cast<uint32_t>(s)].offset) + i;
+        };
+        // 条目数加上 2^61: m * 8 溢出之后与原来的段长度相同, 只能靠按文件大小约束 m 发现
+        forge([&](SnapshotHeader& header, std::vector<char>& bytes) {
+            header.arc_count += uint64_t(1) << 61;
+            *section_word(header, bytes, SnapshotSection::Offsets, header.vertex_count) = header.arc_count;
+        });
+        expect_throw([&] { Snapshot::Open(corrupted); });
+        // 邻居指向不存在的顶点
+        forge([&](SnapshotHeader& header, std::vector<char>& bytes) {
+            *section_word(header, bytes, SnapshotSection::Targets, 5) = header.vertex_count + 7;
+        });
+        assert(!Snapshot::Open(corrupted).Verify());
+        expect_throw([&] { Snapshot::Open(corrupted, {.verify = true}); });
+        // offsets 不单调 (首尾仍然正确)
+        forge([&](SnapshotHeader& header, std::vector<char>& bytes) {
+            *section_word(header, bytes, SnapshotSection::Offsets, 3) = header.arc_count + 1;
+        });
+        assert(!Snapshot::Open(corrupted).Verify());
+        expect_throw([&] { Snapshot::Open(corrupted, {.verify = true}); });
+
+        // 改名失败 (目标是一个目录): 抛出 system_error, 不留下临时文件
+        const std::string occupied = (directory / "moonlight_graph_occupied.snapshot").string();
+        std::filesystem::create_directory(occupied);
+        bool save_failed = false;
+        try {
+            Snapshot::Save(GraphInstance<int, double>(), occupied);
+        } catch (const std::system_error&) {
+            save_failed = true;
+        }
+        assert(save_failed && !std::filesystem::exists(occupied + ".tmp"));
+        std::filesystem::remove(occupied);
+
+        // 空图
+        Snapshot::Save(GraphInstance<int, double>(), path);
+        auto empty = Snapshot::Open(path, {.verify = true, .prefetch = true});
+        assert(empty.VertexCount() == 0 && empty.ArcCount() == 0 && !empty.HasEdge(0, 0));
+        std::filesystem::remove(path);
+        std::filesystem::remove(corrupted);
+    }
+    std::cout << "✓\n";
+
+    std::cout << "B+ 树 (ITree 接口): ";
+    {
+        static_assert(TreeInterface<BPlusTree<int>> && TreeInterface<ITree<int>>);
+        ErasedTree<BPlusTree<int>> erased;
+        BPlusTree<int>& bplus = erased.Get();
+        ITree<int>& tree = erased;
+        std::set<int> reference;
+        std::mt19937 rng(2024);
+        for (int round = 0; round < 60000; ++round) {
+            int v = static_cast<int>(rng() % 20000);
+            if (rng() % 3) {
+                auto* entry = tree.Insert(int(v));
+                assert(entry && entry->GetValue() == v);
+                reference.insert(v);
+            } else {
+                auto* next = tree.Remove(v);
+                auto it = reference.find(v);
+                if (it == reference.end()) {
+                    assert(!next);
+                } else {
+                    it = reference.erase(it);
+                    assert(it == reference.end() ? !next : next && next->GetValue() == *it);
+                }
+            }
+        }
+        assert(bplus.Size() == reference.size());
+        std::vector<int> scanned;
+        tree.Traverse(nullptr, [&](auto* entry) { scanned.push_back(entry->GetValue()); });
+        assert(std::equal(scanned.begin(), scanned.end(), reference.begin(), reference.end()));
+        // 同一份泛型代码既可以直接调用 BPlusTree (内联), 也可以经过 ITree 的虚调用
+        auto count_hits = [](const auto& generic) {
+            std::size_t hits = 0;
+            for (int v = 0; v < 20000; v += 7) hits += generic.Find(v) != nullptr;
+            return hits;
+        };
+        std::size_t expected_hits = 0;
+        for (int v = 0; v < 20000; v += 7) {
+            assert((tree.Find(v) != nullptr) == reference.count(v));
+            expected_hits += reference.count(v);
+        }
+        assert(count_hits(bplus) == expected_hits && count_hits(tree) == expected_hits);
+        std::vector<int> tail;
+        bplus.Traverse(bplus.Find(*reference.begin()), [&](auto* entry) { tail.push_back(entry->GetValue()); });
+        assert(tail == scanned);
+        std::vector<int> ranged;
+        bplus.Scan(100, 200, [&](int v) { ranged.push_back(v); });
+        assert(std::equal(ranged.begin(), ranged.end(), reference.lower_bound(100), reference.upper_bound(200)));
+        for (int v : std::vector<int>(reference.begin(), reference.end())) {
+            assert(bplus.Erase(v));
+        }
+        assert(bplus.Empty() && !tree.Find(1));
+    }
+    std::cout << "✓ 与 std::set 一致\n";
+
+    std::cout << "并发红黑树 (路径复制 + epoch 回收): ";
+    {
+        ConcurrentRBTree<int> tree;
+        std::set<int> reference;
+        std::mt19937 rng(7);
+        for (int round = 0; round < 20000; ++round) {
+            int v = static_cast<int>(rng() % 4000);
+            if (rng() % 3) {
+                assert(tree.Insert(v) == reference.insert(v).second);
+            } else {
+                assert(tree.Erase(v) == (reference.erase(v) == 1));
+            }
+        }
+        {
+            auto guard = tree.Read();
+            bool ok = true;
+            CountBlackHeight(guard.Root(), ok);
+            assert(ok && NoRedRed(guard.Root()) && ColorOf(guard.Root()) == Color::Black);
+            std::vector<int> vals;
+            guard.ForEach([&](int v) { vals.push_back(v); });
+            assert(std::equal(vals.begin(), vals.end(), reference.begin(), reference.end()));
+        }
+        assert(tree.Size() == reference.size() && tree.Find(*reference.begin()) == *reference.begin());
+
+        // 写者按升序插入 0..n-1, 读者看到的任一版本都必须恰好是某个前缀 {0, ..., m-1} 且满足红黑性质
+        ConcurrentRBTree<int> prefix;
+        std::atomic<bool> stop{false};
+        std::vector<std::thread> readers;
+        for (int t = 0; t < 3; ++t) {
+            readers.emplace_back([&] {
+                while (!stop.load()) {
+                    auto guard = prefix.Read();
+                    bool ok = true;
+                    CountBlackHeight(guard.Root(), ok);
+                    assert(ok && NoRedRed(guard.Root()));
+                    int expect = 0;
+                    guard.ForEach([&](int v) { assert(v == expect); ++expect; });
+                }
+            });
+        }
+        for (int v = 0; v < 3000; ++v) {
+            prefix.Insert(v);
+        }
+        stop = true;
+        for (auto& reader : readers) reader.join();
+
+        // 同时存活的读者线程多于第一块槽位 (64) 的数倍: 槽位表按块增长, 写者仍能看到每个读者的宣告
+        readers.clear();
+        std::latch all_inside(301);
+        std::atomic<bool> release{false};
+        for (int t = 0; t < 300; ++t) {
+            readers.emplace_back([&] {
+                auto guard = prefix.Read();
+                all_inside.count_down();
+                while (!release.load()) std::this_thread::yield();
+                assert(guard.Contains(2999) && !guard.Contains(3000));
+            });
+        }
+        all_inside.arrive_and_wait();
+        prefix.Insert(3000);
+        prefix.Erase(0);
+        release = true;
+        for (auto& reader : readers) reader.join();
+        assert(prefix.Contains(3000) && !prefix.Contains(0));
+    }
+    std::cout << "✓ 与 std::set 一致, 并发读者只看到完整版本\n";
+
+    std::cout << "持久化红黑树 (快照): ";
+    {
+        PersistentRBTree<int> tree;
+        std::set<int> reference;
+        std::vector<std::pair<PersistentRBTree<int>, std::set<int>>> versions;
+        std::mt19937 rng(9);
+        for (int round = 0; round < 20000; ++round) {
+            int v = static_cast<int>(rng() % 3000);
+            if (rng() % 3) {
+                assert(tree.Insert(v) == reference.insert(v).second);
+            } else {
+                assert(tree.Erase(v) == (reference.erase(v) == 1));
+            }
+            if (round % 2000 == 0) {
+                versions.emplace_back(tree.Snapshot(), reference);
+            }
+        }
+        versions.emplace_back(tree, reference);
+        tree.Clear();
+        // 每个快照都保持拍下时的内容, 且仍是合法红黑树
+        for (auto& [snapshot, expect] : versions) {
+            bool ok = true;
+            CountBlackHeight(snapshot.Root(), ok);
+            assert(ok && NoRedRed(snapshot.Root()) && snapshot.Size() == expect.size());
+            std::vector<int> vals;
+            snapshot.ForEach([&](int v) { vals.push_back(v); });
+            assert(std::equal(vals.begin(), vals.end(), expect.begin(), expect.end()));
+        }
+        auto next = versions.back().first.Inserted(-1);
+        assert(next.Contains(-1) && !versions.back().first.Contains(-1));
+    }
+    std::cout << "✓ 各版本互不影响\n";
+
     std::cout << "所有基本测试通过 ✅\n";
 
     return 0;